@@ -0,0 +1,288 @@
+// AgregadosSimd.cpp - Kernels AVX2 / SSE4.1 / escalares para agregados de quantidades
+#include "AgregadosSimd.h"
+#include "DeteccaoCPU.h"
+#include <climits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ESTOQUE_X86_GNU 1
+#include <immintrin.h>
+// Funções compiladas para um alvo específico (o restante do binário continua genérico)
+#define ALVO_AVX2 __attribute__((target("avx2")))
+#define ALVO_SSE41 __attribute__((target("sse4.1")))
+#endif
+
+using std::int32_t;
+using std::uint32_t;
+using std::uint8_t;
+using std::size_t;
+
+// === ESCALAR (referência e cauda dos vetoriais) ===
+
+static void agregarEscalar(const int32_t* v, size_t n, int limite, AgregadosQuantidade& r) {
+    for (size_t i = 0; i < n; ++i) {
+        r.soma += v[i];
+        if (v[i] < r.minimo) r.minimo = v[i];
+        if (v[i] > r.maximo) r.maximo = v[i];
+        if (v[i] < limite) ++r.abaixoDoLimite;
+    }
+}
+
+// abaixo[k] += valores menores que limites[k]
+static void contarAbaixoEscalar(const int32_t* v, size_t n, const int* limites, size_t k, size_t* abaixo) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < k; ++j) {
+            abaixo[j] += v[i] < limites[j];
+        }
+    }
+}
+
+static void totalizarEscalar(const int32_t* q, const uint8_t* t, size_t n, TotaisMovimentos& r) {
+    for (size_t i = 0; i < n; ++i) {
+        if (t[i] == 0) {
+            ++r.numEntradas;
+            r.quantidadeEntradas += q[i];
+        } else {
+            ++r.numSaidas;
+            r.quantidadeSaidas += q[i];
+        }
+    }
+}
+
+#ifdef ESTOQUE_X86_GNU
+
+// === AVX2: 8 valores por iteração ===
+
+ALVO_AVX2 static long long somarLanes64Avx2(__m256i v) {
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+}
+
+ALVO_AVX2 static long long somarLanes32Avx2(__m256i v) {
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    long long total = 0;
+    for (int i = 0; i < 8; ++i) total += static_cast<uint32_t>(lanes[i]);
+    return total;
+}
+
+ALVO_AVX2 static size_t agregarAvx2(const int32_t* v, size_t n, int limite, AgregadosQuantidade& r) {
+    __m256i somaBaixa = _mm256_setzero_si256(), somaAlta = _mm256_setzero_si256();
+    __m256i menor = _mm256_set1_epi32(r.minimo), maior = _mm256_set1_epi32(r.maximo);
+    __m256i abaixo = _mm256_setzero_si256(), vLimite = _mm256_set1_epi32(limite);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+        // Soma em 64 bits: metade baixa e alta estendidas com sinal
+        somaBaixa = _mm256_add_epi64(somaBaixa, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        somaAlta = _mm256_add_epi64(somaAlta, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+        menor = _mm256_min_epi32(menor, x);
+        maior = _mm256_max_epi32(maior, x);
+        abaixo = _mm256_sub_epi32(abaixo, _mm256_cmpgt_epi32(vLimite, x));  // comparação = -1
+    }
+    r.soma += somarLanes64Avx2(_mm256_add_epi64(somaBaixa, somaAlta));
+    r.abaixoDoLimite += static_cast<size_t>(somarLanes32Avx2(abaixo));
+    alignas(32) int32_t lanesMenor[8], lanesMaior[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanesMenor), menor);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanesMaior), maior);
+    for (int j = 0; j < 8; ++j) {
+        if (lanesMenor[j] < r.minimo) r.minimo = lanesMenor[j];
+        if (lanesMaior[j] > r.maximo) r.maximo = lanesMaior[j];
+    }
+    return i;
+}
+
+ALVO_AVX2 static size_t contarAbaixoAvx2(const int32_t* v, size_t n, const int* limites, size_t k, size_t* abaixo) {
+    __m256i acumulado[MAX_LIMITES_FAIXAS];
+    __m256i vLimites[MAX_LIMITES_FAIXAS];
+    for (size_t j = 0; j < k; ++j) {
+        acumulado[j] = _mm256_setzero_si256();
+        vLimites[j] = _mm256_set1_epi32(limites[j]);
+    }
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+        for (size_t j = 0; j < k; ++j) {
+            acumulado[j] = _mm256_sub_epi32(acumulado[j], _mm256_cmpgt_epi32(vLimites[j], x));
+        }
+    }
+    for (size_t j = 0; j < k; ++j) {
+        abaixo[j] += static_cast<size_t>(somarLanes32Avx2(acumulado[j]));
+    }
+    return i;
+}
+
+ALVO_AVX2 static size_t totalizarAvx2(const int32_t* q, const uint8_t* t, size_t n, TotaisMovimentos& r) {
+    __m256i total = _mm256_setzero_si256(), entradas = _mm256_setzero_si256();
+    __m256i numEntradas = _mm256_setzero_si256(), zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + i));
+        // 8 tipos de 1 byte estendidos para 8 lanes de 32 bits
+        __m256i tipo = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(t + i)));
+        __m256i ehEntrada = _mm256_cmpeq_epi32(tipo, zero);
+        __m256i xEntrada = _mm256_and_si256(x, ehEntrada);
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+        entradas = _mm256_add_epi64(entradas, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(xEntrada)));
+        entradas = _mm256_add_epi64(entradas, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(xEntrada, 1)));
+        numEntradas = _mm256_sub_epi32(numEntradas, ehEntrada);
+    }
+    long long somaEntradas = somarLanes64Avx2(entradas);
+    size_t contEntradas = static_cast<size_t>(somarLanes32Avx2(numEntradas));
+    r.quantidadeEntradas += somaEntradas;
+    r.quantidadeSaidas += somarLanes64Avx2(total) - somaEntradas;
+    r.numEntradas += contEntradas;
+    r.numSaidas += i - contEntradas;
+    return i;
+}
+
+// === SSE4.1: 4 valores por iteração ===
+
+ALVO_SSE41 static long long somarLanes64Sse41(__m128i v) {
+    return _mm_cvtsi128_si64(v) + _mm_extract_epi64(v, 1);
+}
+
+ALVO_SSE41 static long long somarLanes32Sse41(__m128i v) {
+    return static_cast<long long>(static_cast<uint32_t>(_mm_extract_epi32(v, 0))) +
+           static_cast<uint32_t>(_mm_extract_epi32(v, 1)) +
+           static_cast<uint32_t>(_mm_extract_epi32(v, 2)) +
+           static_cast<uint32_t>(_mm_extract_epi32(v, 3));
+}
+
+ALVO_SSE41 static size_t agregarSse41(const int32_t* v, size_t n, int limite, AgregadosQuantidade& r) {
+    __m128i soma = _mm_setzero_si128();
+    __m128i menor = _mm_set1_epi32(r.minimo), maior = _mm_set1_epi32(r.maximo);
+    __m128i abaixo = _mm_setzero_si128(), vLimite = _mm_set1_epi32(limite);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i));
+        soma = _mm_add_epi64(soma, _mm_cvtepi32_epi64(x));
+        soma = _mm_add_epi64(soma, _mm_cvtepi32_epi64(_mm_srli_si128(x, 8)));
+        menor = _mm_min_epi32(menor, x);
+        maior = _mm_max_epi32(maior, x);
+        abaixo = _mm_sub_epi32(abaixo, _mm_cmpgt_epi32(vLimite, x));
+    }
+    r.soma += somarLanes64Sse41(soma);
+    r.abaixoDoLimite += static_cast<size_t>(somarLanes32Sse41(abaixo));
+    int32_t lanesMenor[4], lanesMaior[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanesMenor), menor);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanesMaior), maior);
+    for (int j = 0; j < 4; ++j) {
+        if (lanesMenor[j] < r.minimo) r.minimo = lanesMenor[j];
+        if (lanesMaior[j] > r.maximo) r.maximo = lanesMaior[j];
+    }
+    return i;
+}
+
+ALVO_SSE41 static size_t contarAbaixoSse41(const int32_t* v, size_t n, const int* limites, size_t k, size_t* abaixo) {
+    __m128i acumulado[MAX_LIMITES_FAIXAS];
+    __m128i vLimites[MAX_LIMITES_FAIXAS];
+    for (size_t j = 0; j < k; ++j) {
+        acumulado[j] = _mm_setzero_si128();
+        vLimites[j] = _mm_set1_epi32(limites[j]);
+    }
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i));
+        for (size_t j = 0; j < k; ++j) {
+            acumulado[j] = _mm_sub_epi32(acumulado[j], _mm_cmpgt_epi32(vLimites[j], x));
+        }
+    }
+    for (size_t j = 0; j < k; ++j) {
+        abaixo[j] += static_cast<size_t>(somarLanes32Sse41(acumulado[j]));
+    }
+    return i;
+}
+
+ALVO_SSE41 static size_t totalizarSse41(const int32_t* q, const uint8_t* t, size_t n, TotaisMovimentos& r) {
+    __m128i total = _mm_setzero_si128(), entradas = _mm_setzero_si128();
+    __m128i numEntradas = _mm_setzero_si128(), zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + i));
+        int32_t quatroTipos;
+        __builtin_memcpy(&quatroTipos, t + i, sizeof(quatroTipos));
+        __m128i tipo = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(quatroTipos));
+        __m128i ehEntrada = _mm_cmpeq_epi32(tipo, zero);
+        __m128i xEntrada = _mm_and_si128(x, ehEntrada);
+        total = _mm_add_epi64(total, _mm_cvtepi32_epi64(x));
+        total = _mm_add_epi64(total, _mm_cvtepi32_epi64(_mm_srli_si128(x, 8)));
+        entradas = _mm_add_epi64(entradas, _mm_cvtepi32_epi64(xEntrada));
+        entradas = _mm_add_epi64(entradas, _mm_cvtepi32_epi64(_mm_srli_si128(xEntrada, 8)));
+        numEntradas = _mm_sub_epi32(numEntradas, ehEntrada);
+    }
+    long long somaEntradas = somarLanes64Sse41(entradas);
+    size_t contEntradas = static_cast<size_t>(somarLanes32Sse41(numEntradas));
+    r.quantidadeEntradas += somaEntradas;
+    r.quantidadeSaidas += somarLanes64Sse41(total) - somaEntradas;
+    r.numEntradas += contEntradas;
+    r.numSaidas += i - contEntradas;
+    return i;
+}
+
+#endif // ESTOQUE_X86_GNU
+
+// === DESPACHO ===
+// Cada nível processa os blocos completos e devolve onde parou; a cauda é escalar
+
+AgregadosQuantidade agregarColuna(const int32_t* valores, size_t n, int limite) {
+    AgregadosQuantidade r;
+    r.itens = n;
+    r.soma = 0;
+    r.minimo = INT_MAX;
+    r.maximo = INT_MIN;
+    r.abaixoDoLimite = 0;
+    size_t feitos = 0;
+#ifdef ESTOQUE_X86_GNU
+    NivelSimd nivel = nivelSimdAtivo();
+    if (nivel == SIMD_AVX2) {
+        feitos = agregarAvx2(valores, n, limite, r);
+    } else if (nivel == SIMD_SSE41) {
+        feitos = agregarSse41(valores, n, limite, r);
+    }
+#endif
+    agregarEscalar(valores + feitos, n - feitos, limite, r);
+    if (n == 0) {
+        r.minimo = r.maximo = 0;
+    }
+    return r;
+}
+
+void contarPorFaixa(const int32_t* valores, size_t n, const int* limites, size_t numLimites, size_t* contagens) {
+    size_t abaixo[MAX_LIMITES_FAIXAS] = {};
+    size_t feitos = 0;
+#ifdef ESTOQUE_X86_GNU
+    NivelSimd nivel = nivelSimdAtivo();
+    if (nivel == SIMD_AVX2) {
+        feitos = contarAbaixoAvx2(valores, n, limites, numLimites, abaixo);
+    } else if (nivel == SIMD_SSE41) {
+        feitos = contarAbaixoSse41(valores, n, limites, numLimites, abaixo);
+    }
+#endif
+    contarAbaixoEscalar(valores + feitos, n - feitos, limites, numLimites, abaixo);
+
+    // Faixa j = abaixo do limite j menos abaixo do limite anterior
+    size_t anterior = 0;
+    for (size_t j = 0; j < numLimites; ++j) {
+        contagens[j] = abaixo[j] - anterior;
+        anterior = abaixo[j];
+    }
+    contagens[numLimites] = n - anterior;
+}
+
+TotaisMovimentos totalizarPorTipo(const int32_t* quantidades, const uint8_t* tipos, size_t n) {
+    TotaisMovimentos r;
+    r.numEntradas = r.numSaidas = 0;
+    r.quantidadeEntradas = r.quantidadeSaidas = 0;
+    size_t feitos = 0;
+#ifdef ESTOQUE_X86_GNU
+    NivelSimd nivel = nivelSimdAtivo();
+    if (nivel == SIMD_AVX2) {
+        feitos = totalizarAvx2(quantidades, tipos, n, r);
+    } else if (nivel == SIMD_SSE41) {
+        feitos = totalizarSse41(quantidades, tipos, n, r);
+    }
+#endif
+    totalizarEscalar(quantidades + feitos, tipos + feitos, n - feitos, r);
+    return r;
+}
@@ -0,0 +1,63 @@
+#ifndef AGREGADOSSIMD_H
+#define AGREGADOSSIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Agregados sobre as quantidades dos itens (Estoque::agregarQuantidades).
+ * Com itens == 0, minimo e maximo valem 0.
+ */
+struct AgregadosQuantidade {
+    std::size_t itens;
+    long long soma;
+    int minimo;
+    int maximo;
+    std::size_t abaixoDoLimite;   // Itens com quantidade < limite pedido
+};
+
+/**
+ * Totais do histórico por TipoMovimento (Estoque::totalizarMovimentos).
+ */
+struct TotaisMovimentos {
+    std::size_t numEntradas;
+    std::size_t numSaidas;
+    long long quantidadeEntradas;
+    long long quantidadeSaidas;
+};
+
+/**
+ * Kernels vetoriais sobre colunas contíguas de int32.
+ *
+ * Cada função escolhe em tempo de execução a versão AVX2 (8 valores por
+ * instrução), SSE4.1 (4) ou escalar (DeteccaoCPU.h); as três dão o mesmo
+ * resultado. Somas acumulam em 64 bits; contagens em lanes de 32 bits
+ * (até 2^31 valores por lane).
+ */
+
+// Maior número de limites aceito por contarPorFaixa (acumuladores em registradores/pilha)
+const std::size_t MAX_LIMITES_FAIXAS = 32;
+
+/**
+ * Soma, mínimo, máximo e quantos valores são menores que 'limite', em uma passada.
+ */
+AgregadosQuantidade agregarColuna(const std::int32_t* valores, std::size_t n, int limite);
+
+/**
+ * Histograma por faixas: limites em ordem estritamente crescente definem
+ * numLimites + 1 faixas: (-inf, l0), [l0, l1), ..., [l(k-1), +inf).
+ *
+ * Parâmetro:
+ *   - contagens: vetor com numLimites + 1 posições (sobrescrito)
+ * Pré-condição: numLimites <= MAX_LIMITES_FAIXAS e limites crescentes
+ */
+void contarPorFaixa(const std::int32_t* valores, std::size_t n,
+                    const int* limites, std::size_t numLimites, std::size_t* contagens);
+
+/**
+ * Soma e contagem de quantidades por tipo (0 = ENTRADA, demais = SAIDA).
+ * 'tipos' é a coluna paralela de TipoMovimento em 1 byte por movimento.
+ */
+TotaisMovimentos totalizarPorTipo(const std::int32_t* quantidades, const std::uint8_t* tipos, std::size_t n);
+
+#endif // AGREGADOSSIMD_H
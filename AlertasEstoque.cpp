@@ -0,0 +1,53 @@
+// AlertasEstoque.cpp - Índice de itens abaixo do estoque mínimo e callbacks de alerta
+#include "AlertasEstoque.h"
+#include "Item.h"
+#include <algorithm>
+
+using std::vector;
+
+// Chamado pelo Item somente quando a quantidade cruza o mínimo
+void AlertasEstoque::minimoCruzado(const Item& item, bool abaixo) {
+    if (abaixo) {
+        idsBaixos.insert(item.getId());
+    } else {
+        idsBaixos.erase(item.getId());
+    }
+    if (callbacks.empty()) {
+        return;
+    }
+    AlertaEstoqueBaixo alerta;
+    alerta.idItem = item.getId();
+    alerta.nome = item.getNome();
+    alerta.quantidade = item.getQuantidade();
+    alerta.minimo = item.getMinimo();
+    alerta.abaixo = abaixo;
+    for (std::size_t i = 0; i < callbacks.size(); ++i) {
+        callbacks[i](alerta);
+    }
+}
+
+// Item novo não "cruza" o mínimo: entra direto no índice, sem callback
+void AlertasEstoque::registrarItem(const Item& item) {
+    if (item.estaAbaixoDoMinimo()) {
+        idsBaixos.insert(item.getId());
+    }
+}
+
+void AlertasEstoque::removerItem(int idItem) {
+    idsBaixos.erase(idItem);
+}
+
+void AlertasEstoque::limpar() {
+    idsBaixos.clear();
+}
+
+// Cópia ordenada: saída estável para menus e protocolo
+vector<int> AlertasEstoque::idsAbaixoDoMinimo() const {
+    vector<int> ids(idsBaixos.begin(), idsBaixos.end());
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void AlertasEstoque::adicionarCallback(const CallbackEstoqueBaixo& callback) {
+    callbacks.push_back(callback);
+}
@@ -0,0 +1,59 @@
+#ifndef ALERTASESTOQUE_H
+#define ALERTASESTOQUE_H
+
+#include "IObservadorItem.h"
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Aviso entregue aos callbacks quando um item cruza o estoque mínimo.
+ */
+struct AlertaEstoqueBaixo {
+    int idItem;
+    std::string nome;
+    int quantidade;     // Quantidade depois da alteração
+    int minimo;
+    bool abaixo;        // true = ficou abaixo do mínimo; false = voltou ao normal
+};
+
+// Função chamada a cada cruzamento do mínimo
+typedef std::function<void(const AlertaEstoqueBaixo&)> CallbackEstoqueBaixo;
+
+/**
+ * Índice dos itens abaixo do estoque mínimo, mantido pelos próprios itens.
+ *
+ * Cada Item do Estoque aponta para esta instância (IObservadorItem) e a
+ * notifica apenas quando a quantidade cruza o mínimo: inserção/remoção O(1)
+ * no conjunto, sem varrer o catálogo. Listar os itens baixos custa O(k),
+ * k = itens abaixo do mínimo.
+ *
+ * Sem trava própria: todas as chamadas acontecem com mutexEstado do Estoque travado.
+ */
+class AlertasEstoque : public IObservadorItem {
+public:
+    // Atualiza o índice e dispara os callbacks
+    virtual void minimoCruzado(const Item& item, bool abaixo);
+
+    // Inclui um item recém-adicionado ao Estoque (entra no índice se já estiver baixo)
+    void registrarItem(const Item& item);
+
+    // Retira um item removido do Estoque
+    void removerItem(int idItem);
+
+    // Esvazia o índice (antes de reconstruir com registrarItem)
+    void limpar();
+
+    // IDs dos itens abaixo do mínimo, em ordem crescente
+    std::vector<int> idsAbaixoDoMinimo() const;
+
+    // Acrescenta um callback (chamado com mutexEstado travado: não chamar o Estoque)
+    void adicionarCallback(const CallbackEstoqueBaixo& callback);
+
+private:
+    std::unordered_set<int> idsBaixos;
+    std::vector<CallbackEstoqueBaixo> callbacks;
+};
+
+#endif // ALERTASESTOQUE_H
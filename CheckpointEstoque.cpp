@@ -0,0 +1,385 @@
+// CheckpointEstoque.cpp - Checkpoint binário do catálogo (estoque.ckp), itens.txt e diário
+#include "CheckpointEstoque.h"
+#include "EstoqueException.h"
+#include "DivisorCampos.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <cstdio>   // Para std::rename
+#include <cstring>  // Para std::memcpy e std::strlen
+#include <cstdint>
+#include <cerrno>
+#ifndef _WIN32
+#include <unistd.h> // Para write (SaidaDescritor)
+#endif
+
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::ifstream;
+using std::unordered_map;
+using std::exception;
+using std::cerr;
+using std::endl;
+using std::uint32_t;
+using std::uint64_t;
+
+static const char ASSINATURA[] = "ESTQCKP1";
+static const std::size_t TAMANHO_ASSINATURA = sizeof(ASSINATURA) - 1;
+
+static const uint64_t FNV_INICIAL = 14695981039346656037ull;
+
+// FNV-1a de 64 bits (mesma família do hash das tags)
+// h: valor acumulado dos bytes anteriores (continuação em blocos)
+static uint64_t fnv1a64(const char* dados, std::size_t n, uint64_t h = FNV_INICIAL) {
+    for (std::size_t i = 0; i < n; ++i) {
+        h = (h ^ static_cast<unsigned char>(dados[i])) * 1099511628211ull;
+    }
+    return h;
+}
+
+// === ESCRITA ===
+
+#ifndef _WIN32
+SaidaDescritor::SaidaDescritor(int fd, char* buffer, std::size_t capacidade)
+    : fd(fd), buffer(buffer), capacidade(capacidade), usado(0), falha(false) {
+}
+
+void SaidaDescritor::escrever(const char* dados, std::size_t n) {
+    while (n > 0 && !falha) {
+        if (usado == capacidade && !descarregar()) {
+            return;
+        }
+        std::size_t parte = std::min(n, capacidade - usado);
+        std::memcpy(buffer + usado, dados, parte);
+        usado += parte;
+        dados += parte;
+        n -= parte;
+    }
+}
+
+SaidaDescritor& SaidaDescritor::operator<<(const string& texto) {
+    escrever(texto.data(), texto.size());
+    return *this;
+}
+
+SaidaDescritor& SaidaDescritor::operator<<(const char* texto) {
+    escrever(texto, std::strlen(texto));
+    return *this;
+}
+
+// Decimal formatado à mão (sem snprintf/locale), como ostream << int
+SaidaDescritor& SaidaDescritor::operator<<(int valor) {
+    char digitos[12];
+    char* p = digitos + sizeof(digitos);
+    unsigned int magnitude = valor < 0 ? 0u - static_cast<unsigned int>(valor) : static_cast<unsigned int>(valor);
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (valor < 0) {
+        *--p = '-';
+    }
+    escrever(p, static_cast<std::size_t>(digitos + sizeof(digitos) - p));
+    return *this;
+}
+
+bool SaidaDescritor::descarregar() {
+    const char* p = buffer;
+    while (usado > 0 && !falha) {
+        ssize_t n = write(fd, p, usado);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            falha = true;
+            break;
+        }
+        p += n;
+        usado -= static_cast<std::size_t>(n);
+    }
+    usado = 0;
+    return !falha;
+}
+#endif
+
+// Acrescenta a um std::string (gravar)
+struct DestinoTexto {
+    string& buffer;
+    void escrever(const char* dados, std::size_t n) { buffer.append(dados, n); }
+};
+
+// Repassa ao destino acumulando o FNV do que passou (trailer do checkpoint)
+template <typename Destino>
+struct DestinoComFnv {
+    Destino& destino;
+    uint64_t fnv;
+    void escrever(const char* dados, std::size_t n) {
+        fnv = fnv1a64(dados, n, fnv);
+        destino.escrever(dados, n);
+    }
+};
+
+template <typename Destino, typename T>
+static void escreverValor(Destino& destino, T valor) {
+    destino.escrever(reinterpret_cast<const char*>(&valor), sizeof(valor));
+}
+
+template <typename Destino>
+static void escreverTexto(Destino& destino, const string& texto) {
+    escreverValor(destino, static_cast<uint32_t>(texto.size()));
+    destino.escrever(texto.data(), texto.size());
+}
+
+// Tags constantes (nomeTipoItem), sem std::string temporária
+template <typename Destino>
+static void escreverTexto(Destino& destino, const char* texto) {
+    const std::size_t tamanho = std::strlen(texto);
+    escreverValor(destino, static_cast<uint32_t>(tamanho));
+    destino.escrever(texto, tamanho);
+}
+
+// Formato do checkpoint (ver CheckpointEstoque.h); sem alocação própria
+template <typename Destino>
+static void serializarEm(Destino& destinoFinal, unsigned long long seq, int proximoIdItem,
+                         const vector<shared_ptr<const EstadoItem> >& itens) {
+    DestinoComFnv<Destino> destino = { destinoFinal, FNV_INICIAL };
+    destino.escrever(ASSINATURA, TAMANHO_ASSINATURA);
+    escreverValor(destino, static_cast<uint64_t>(seq));
+    escreverValor(destino, static_cast<std::int32_t>(proximoIdItem));
+    escreverValor(destino, static_cast<uint32_t>(itens.size()));
+    for (std::size_t i = 0; i < itens.size(); ++i) {
+        const EstadoItem& item = *itens[i];
+        escreverTexto(destino, nomeTipoItem(item.tipo));
+        escreverValor(destino, static_cast<std::int32_t>(item.id));
+        escreverTexto(destino, item.nome);
+        escreverTexto(destino, item.descricao);
+        escreverValor(destino, static_cast<std::int32_t>(item.quantidade));
+        escreverTexto(destino, item.link);
+        escreverTexto(destino, item.detalhe);
+        escreverValor(destino, static_cast<std::int32_t>(item.minimo));
+    }
+    escreverValor(destinoFinal, destino.fnv);
+}
+
+#ifndef _WIN32
+void CheckpointEstoque::serializar(SaidaDescritor& saida, unsigned long long seq, int proximoIdItem,
+                                   const vector<shared_ptr<const EstadoItem> >& itens) {
+    serializarEm(saida, seq, proximoIdItem, itens);
+}
+#endif
+
+void CheckpointEstoque::gravar(const string& caminho, unsigned long long seq, int proximoIdItem,
+                               const vector<shared_ptr<const EstadoItem> >& itens) {
+    string buffer;
+    buffer.reserve(64 + itens.size() * 96);
+    DestinoTexto destino = { buffer };
+    serializarEm(destino, seq, proximoIdItem, itens);
+    const string temporario = caminho + ".tmp";
+    std::ofstream arq(temporario, std::ios::binary | std::ios::trunc);
+    if (!arq.is_open()) {
+        throw EstoqueException("Nao foi possivel abrir " + temporario + ".");
+    }
+    arq.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    arq.close();
+    if (arq.fail() || std::rename(temporario.c_str(), caminho.c_str()) != 0) {
+        throw EstoqueException("Falha ao gravar " + caminho + ".");
+    }
+}
+
+// === LEITURA (cursor sobre o arquivo inteiro em memória) ===
+
+// Avança sobre o buffer; qualquer leitura além do fim marca erro
+struct CursorBinario {
+    const char* atual;
+    const char* fim;
+    bool erro;
+
+    template <typename T>
+    T valor() {
+        T v = T();
+        if (static_cast<std::size_t>(fim - atual) < sizeof(T)) {
+            erro = true;
+            return v;
+        }
+        std::memcpy(&v, atual, sizeof(T));
+        atual += sizeof(T);
+        return v;
+    }
+
+    void texto(string& destino) {
+        uint32_t tamanho = valor<uint32_t>();
+        if (erro || static_cast<std::size_t>(fim - atual) < tamanho) {
+            erro = true;
+            return;
+        }
+        destino.assign(atual, tamanho);
+        atual += tamanho;
+    }
+};
+
+bool CheckpointEstoque::ler(const string& caminho, unsigned long long& seq, int& proximoIdItem,
+                            vector<RegistroItem>& itens) {
+    seq = 0;
+    proximoIdItem = 0;
+    itens.clear();
+
+    std::ifstream arq(caminho, std::ios::binary);
+    if (!arq.is_open()) {
+        return false;
+    }
+    arq.seekg(0, std::ios::end);
+    std::streamoff tamanho = arq.tellg();
+    if (tamanho < static_cast<std::streamoff>(TAMANHO_ASSINATURA + sizeof(uint64_t))) {
+        return false;
+    }
+    string buffer(static_cast<std::size_t>(tamanho), '\0');
+    arq.seekg(0);
+    if (!arq.read(&buffer[0], tamanho)) {
+        return false;
+    }
+
+    // Conteúdo íntegro antes de interpretar qualquer campo
+    const std::size_t tamanhoDados = buffer.size() - sizeof(uint64_t);
+    uint64_t fnvGravado;
+    std::memcpy(&fnvGravado, buffer.data() + tamanhoDados, sizeof(fnvGravado));
+    if (buffer.compare(0, TAMANHO_ASSINATURA, ASSINATURA) != 0 ||
+        fnv1a64(buffer.data(), tamanhoDados) != fnvGravado) {
+        return false;
+    }
+
+    CursorBinario cursor = { buffer.data() + TAMANHO_ASSINATURA, buffer.data() + tamanhoDados, false };
+    unsigned long long seqLido = cursor.valor<uint64_t>();
+    int proximoLido = cursor.valor<std::int32_t>();
+    uint32_t numItens = cursor.valor<uint32_t>();
+    if (cursor.erro) {
+        return false;
+    }
+
+    vector<RegistroItem> lidos(numItens);
+    for (uint32_t i = 0; i < numItens && !cursor.erro; ++i) {
+        RegistroItem& registro = lidos[i];
+        cursor.texto(registro.tipo);
+        registro.campos.id = cursor.valor<std::int32_t>();
+        cursor.texto(registro.campos.nome);
+        cursor.texto(registro.campos.descricao);
+        registro.campos.quantidade = cursor.valor<std::int32_t>();
+        cursor.texto(registro.campos.link);
+        cursor.texto(registro.campos.detalhe);
+        registro.minimo = cursor.valor<std::int32_t>();
+    }
+    if (cursor.erro || cursor.atual != cursor.fim) {
+        return false;
+    }
+
+    seq = seqLido;
+    proximoIdItem = proximoLido;
+    itens.swap(lidos);
+    return true;
+}
+
+// === FONTES EM TEXTO (itens.txt e diário) ===
+
+// Lê TYPE;ID;NAME;DESC;QTY;LINK;DETAIL[;MIN] a partir do campo 'primeiro' da linha
+// (linha de itens.txt ou resto de uma entrada ITEM do diário)
+// Lança: EstoqueException se algum número for inválido
+static void lerCamposItem(const LeitorRegistros& leitor, std::size_t primeiro, RegistroItem& registro) {
+    CamposItem& campos = registro.campos;
+
+    registro.tipo = leitor.campo(primeiro);             // PRODUTO ou MATERIA
+    campos.id = leitor.campoInteiro(primeiro + 1);      // ID
+    campos.nome = leitor.campo(primeiro + 2);           // Nome
+    campos.descricao = leitor.campo(primeiro + 3);      // Descrição
+    campos.quantidade = leitor.campoInteiro(primeiro + 4);  // Quantidade
+    campos.link = leitor.campo(primeiro + 5);           // Link
+    campos.detalhe = leitor.campo(primeiro + 6);        // Categoria ou Fornecedor
+    // Estoque mínimo (opcional)
+    registro.minimo = leitor.tamanhoCampo(primeiro + 7) == 0 ? 0 : leitor.campoInteiro(primeiro + 7);
+    if (registro.minimo < 0) {
+        throw EstoqueException("estoque minimo negativo");
+    }
+}
+
+// Lê itens.txt linha a linha; linhas inválidas são avisadas e puladas
+bool CheckpointEstoque::lerItensTexto(const string& caminho, vector<RegistroItem>& itens) {
+    itens.clear();
+    ifstream arq(caminho);
+    if (!arq.is_open()) {
+        return false;
+    }
+    LeitorRegistros leitor(arq);
+    while (leitor.proximo()) {
+        RegistroItem registro;
+        try {
+            lerCamposItem(leitor, 0, registro);
+            itens.push_back(registro);
+        } catch (const exception& e) {
+            cerr << "Erro ao ler linha de " << caminho << ": " << e.what() << endl;
+        }
+    }
+    return true;
+}
+
+// Reaplica o diário sobre os registros (ver CheckpointEstoque.h)
+// Entradas: SEQ;ITEM;<linha de itens.txt> (estado completo: insere ou substitui)
+//           SEQ;REMOVER;ID
+// Entradas com SEQ <= seqCheckpoint já estão no checkpoint e são ignoradas
+std::size_t CheckpointEstoque::reaplicarDiario(const string& caminho, unsigned long long seqCheckpoint,
+                                              vector<RegistroItem>& registros, unsigned long long& ultimaSeq,
+                                              int& maiorId, bool& terminaEmQuebra) {
+    ultimaSeq = seqCheckpoint;
+    terminaEmQuebra = true;
+    ifstream arq(caminho);
+    if (!arq.is_open()) {
+        return 0;  // Sem diário: nada alterado desde o checkpoint
+    }
+
+    // Posição de cada ID nos registros (substituição e remoção em O(1))
+    unordered_map<int, std::size_t> posicao;
+    posicao.reserve(registros.size());
+    for (std::size_t i = 0; i < registros.size(); ++i) {
+        posicao[registros[i].campos.id] = i;
+    }
+
+    std::size_t reaplicadas = 0;
+    LeitorRegistros leitor(arq);
+    while (leitor.proximo()) {
+        terminaEmQuebra = leitor.terminaEmQuebra();
+        if (!terminaEmQuebra) {
+            break;  // Acréscimo interrompido: ex. "7;ITEM;...;1" de uma quantidade 15
+        }
+        if (leitor.numCampos() == 1 && leitor.tamanhoCampo(0) == 0) {
+            continue;  // Linha vazia
+        }
+        try {
+            unsigned long long seq = leitor.campoSemSinal(0);
+            if (seq > ultimaSeq) ultimaSeq = seq;
+            if (seq <= seqCheckpoint) {
+                continue;  // Checkpoint gravado antes de esvaziar o diário
+            }
+            if (leitor.campoIgual(1, "ITEM")) {
+                RegistroItem registro;
+                lerCamposItem(leitor, 2, registro);
+                if (registro.campos.id > maiorId) maiorId = registro.campos.id;
+                unordered_map<int, std::size_t>::const_iterator it = posicao.find(registro.campos.id);
+                if (it != posicao.end()) {
+                    registros[it->second] = registro;  // Mantém a posição (ordem de cadastro)
+                } else {
+                    posicao[registro.campos.id] = registros.size();
+                    registros.push_back(registro);
+                }
+            } else if (leitor.campoIgual(1, "REMOVER")) {
+                unordered_map<int, std::size_t>::iterator it = posicao.find(leitor.campoInteiro(2));
+                if (it != posicao.end()) {
+                    registros[it->second].campos.id = 0;  // Não é criado na carga
+                    posicao.erase(it);
+                }
+            } else {
+                throw EstoqueException("operacao desconhecida: " + leitor.campo(1));
+            }
+            ++reaplicadas;
+        } catch (const exception& e) {
+            cerr << "Erro ao ler linha de " << caminho << ": " << e.what() << endl;
+        }
+    }
+    return reaplicadas;
+}
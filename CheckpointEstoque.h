@@ -0,0 +1,160 @@
+#ifndef CHECKPOINTESTOQUE_H
+#define CHECKPOINTESTOQUE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include "RegistroTiposItem.h"
+#include "SnapshotEstoque.h"
+
+/**
+ * Item lido de um checkpoint, de itens.txt ou do diário, ainda sem objeto Item.
+ * O loader aplica o diário sobre esses registros e só então cria os itens.
+ */
+struct RegistroItem {
+    std::string tipo;        // Tag do tipo (ex: "PRODUTO"), resolvida por localizarTipo
+    CamposItem campos;       // campos.id == 0: item removido pelo diário
+    int minimo;              // Estoque mínimo (0 = sem alerta)
+};
+
+#ifndef _WIN32
+/**
+ * Saída para um descritor de arquivo por um buffer fixo da chamadora, só
+ * com memcpy e write(2): sem alocação, iostream nem exceções.
+ *
+ * Para o filho do fork do salvamento em segundo plano
+ * (Estoque::salvarEmSegundoPlano), onde só chamadas async-signal-safe são
+ * permitidas: o pai reserva o buffer antes do fork e o filho serializa
+ * por ele, bloco a bloco, em vez de herdar o arquivo inteiro já montado.
+ *
+ * operator<< escreve os mesmos bytes que o de std::ostream (inteiros em
+ * decimal), para as funções de gravação em texto servirem às duas saídas.
+ * Uma falha de escrita é guardada e as escritas seguintes são ignoradas.
+ *
+ * Exemplo (no filho):
+ *   SaidaDescritor saida(fd, &buffer[0], buffer.size());
+ *   saida << 42 << ";" << nome << "\n";
+ *   bool ok = saida.descarregar();
+ */
+class SaidaDescritor {
+public:
+    SaidaDescritor(int fd, char* buffer, std::size_t capacidade);
+
+    void escrever(const char* dados, std::size_t n);
+
+    SaidaDescritor& operator<<(const std::string& texto);
+    SaidaDescritor& operator<<(const char* texto);
+    SaidaDescritor& operator<<(int valor);
+
+    /**
+     * Grava o que restou no buffer.
+     * Retorna: false se alguma escrita falhou
+     */
+    bool descarregar();
+
+private:
+    int fd;
+    char* buffer;
+    std::size_t capacidade;
+    std::size_t usado;
+    bool falha;
+
+    // Não copiável: o buffer pendente seria gravado duas vezes
+    SaidaDescritor(const SaidaDescritor&);
+    SaidaDescritor& operator=(const SaidaDescritor&);
+};
+#endif
+
+/**
+ * Checkpoint binário do catálogo (estoque.ckp) e leitura das fontes em
+ * texto (itens.txt e diário), compartilhadas por Estoque e pelo
+ * verificador de integridade.
+ *
+ * Checkpoint:
+ *
+ * Estado completo dos itens acompanhado do número de sequência do diário
+ * (diario_itens.txt) já incorporado: a recuperação lê o checkpoint e
+ * reaplica só as entradas do diário com sequência maior.
+ *
+ * Formato (inteiros na ordem de bytes da máquina):
+ *   "ESTQCKP1" | seq (u64) | proximoIdItem (i32) | numItens (u32)
+ *   por item: tag, id (i32), nome, descricao, quantidade (i32), link, detalhe, minimo (i32)
+ *   (textos: tamanho u32 + bytes)
+ *   FNV-1a de 64 bits de tudo o que vem antes (u64)
+ *
+ * Gravação em arquivo temporário + rename: um checkpoint incompleto nunca
+ * substitui o anterior. Leitura em um único read e verificação do FNV
+ * antes de interpretar qualquer campo.
+ */
+class CheckpointEstoque {
+public:
+    /**
+     * Grava o checkpoint com os itens do snapshot.
+     *
+     * Parâmetro:
+     *   - caminho: arquivo final (o temporário é caminho + ".tmp")
+     *   - seq: última entrada do diário refletida nos itens
+     *   - proximoIdItem: valor de Item::proximoId (IDs de itens removidos não voltam)
+     *   - itens: estados na ordem de cadastro
+     *
+     * Lança: EstoqueException se não conseguir gravar
+     */
+    static void gravar(const std::string& caminho, unsigned long long seq, int proximoIdItem,
+                       const std::vector<std::shared_ptr<const EstadoItem> >& itens);
+
+#ifndef _WIN32
+    /**
+     * Escreve em 'saida' o mesmo conteúdo que gravar() grava (assinatura,
+     * campos e FNV calculado durante a escrita), sem alocar: usado pelo
+     * filho do salvamento em segundo plano (Estoque::salvarEmSegundoPlano).
+     * Falhas ficam em saida (ver SaidaDescritor::descarregar).
+     */
+    static void serializar(SaidaDescritor& saida, unsigned long long seq, int proximoIdItem,
+                           const std::vector<std::shared_ptr<const EstadoItem> >& itens);
+#endif
+
+    /**
+     * Lê um checkpoint.
+     *
+     * Retorna: false se o arquivo não existe ou está corrompido
+     *          (assinatura, tamanho ou FNV não conferem); nesse caso as
+     *          saídas ficam vazias e a chamadora usa outra fonte
+     */
+    static bool ler(const std::string& caminho, unsigned long long& seq, int& proximoIdItem,
+                    std::vector<RegistroItem>& itens);
+
+    /**
+     * Lê itens.txt (TYPE;ID;NAME;DESC;QTY;LINK;DETAIL[;MIN]), fonte usada
+     * quando não há checkpoint válido. Linhas inválidas são avisadas em
+     * cerr e puladas.
+     *
+     * Retorna: false se o arquivo não existe
+     */
+    static bool lerItensTexto(const std::string& caminho, std::vector<RegistroItem>& itens);
+
+    /**
+     * Reaplica o diário (diario_itens.txt) sobre os registros lidos do
+     * checkpoint ou de itens.txt.
+     *
+     * Entradas: SEQ;ITEM;<linha de itens.txt> (insere ou substitui) e
+     * SEQ;REMOVER;ID (campos.id = 0). Entradas com SEQ <= seqCheckpoint
+     * já estão no checkpoint e são ignoradas. A última linha sem '\n'
+     * (acréscimo interrompido) também: os campos podem estar cortados.
+     *
+     * Parâmetro:
+     *   - caminho: arquivo do diário (ausente = nada a reaplicar)
+     *   - seqCheckpoint: seq do checkpoint lido (0 sem checkpoint)
+     *   - registros: atualizados no lugar, na ordem de cadastro
+     *   - ultimaSeq: saída, maior SEQ lida (entradas completas)
+     *   - maiorId: atualizado com IDs do diário (removidos inclusive)
+     *   - terminaEmQuebra: saída, false se a última linha ficou incompleta
+     *
+     * Retorna: número de entradas reaplicadas
+     */
+    static std::size_t reaplicarDiario(const std::string& caminho, unsigned long long seqCheckpoint,
+                                       std::vector<RegistroItem>& registros, unsigned long long& ultimaSeq,
+                                       int& maiorId, bool& terminaEmQuebra);
+};
+
+#endif // CHECKPOINTESTOQUE_H
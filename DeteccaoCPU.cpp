@@ -0,0 +1,62 @@
+// DeteccaoCPU.cpp - Nível SIMD suportado e em uso (consultado uma vez por processo)
+#include "DeteccaoCPU.h"
+#include <atomic>
+#include <cstdlib>  // Para std::getenv
+#include <cstring>  // Para std::strcmp
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ESTOQUE_X86_GNU 1
+#endif
+
+// Consulta cpuid (via builtins do compilador)
+static NivelSimd detectarNivel() {
+#ifdef ESTOQUE_X86_GNU
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SIMD_SSE41;
+    }
+#endif
+    return SIMD_ESCALAR;
+}
+
+NivelSimd nivelSimdSuportado() {
+    static const NivelSimd suportado = detectarNivel();  // Inicialização thread-safe (C++11)
+    return suportado;
+}
+
+// Nível pedido em ESTOQUE_SIMD (ausente ou desconhecido = sem limite)
+static NivelSimd limiteDoAmbiente() {
+    const char* valor = std::getenv("ESTOQUE_SIMD");
+    if (valor != nullptr) {
+        if (std::strcmp(valor, "escalar") == 0) return SIMD_ESCALAR;
+        if (std::strcmp(valor, "sse41") == 0) return SIMD_SSE41;
+    }
+    return SIMD_AVX2;
+}
+
+// Limite atual: começa no do ambiente
+static std::atomic<int>& limiteAtual() {
+    static std::atomic<int> limite(limiteDoAmbiente());
+    return limite;
+}
+
+NivelSimd nivelSimdAtivo() {
+    int limite = limiteAtual().load(std::memory_order_relaxed);
+    int suportado = nivelSimdSuportado();
+    return static_cast<NivelSimd>(limite < suportado ? limite : suportado);
+}
+
+void limitarNivelSimd(NivelSimd maximo) {
+    limiteAtual().store(maximo, std::memory_order_relaxed);
+}
+
+const char* nomeNivelSimd(NivelSimd nivel) {
+    switch (nivel) {
+        case SIMD_AVX2:  return "avx2";
+        case SIMD_SSE41: return "sse41";
+        default:         return "escalar";
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef DETECCAOCPU_H
+#define DETECCAOCPU_H
+
+/**
+ * Seleção em tempo de execução dos kernels vetoriais (SIMD).
+ *
+ * O binário é compilado para x86-64 genérico; as funções AVX2 e SSE4.1
+ * são compiladas com atributos de alvo e só são chamadas quando a CPU
+ * as suporta (cpuid consultado uma única vez). Fora de x86-64 com
+ * GCC/Clang, somente o nível escalar existe.
+ *
+ * Variável de ambiente ESTOQUE_SIMD=escalar|sse41|avx2 limita o nível
+ * (comparação de desempenho e testes de equivalência).
+ */
+enum NivelSimd {
+    SIMD_ESCALAR,
+    SIMD_SSE41,
+    SIMD_AVX2
+};
+
+// Maior nível suportado pela CPU
+NivelSimd nivelSimdSuportado();
+
+// Nível em uso pelos kernels: suportado, limitado por ESTOQUE_SIMD ou limitarNivelSimd
+NivelSimd nivelSimdAtivo();
+
+// Limita o nível em uso (nunca acima do suportado)
+void limitarNivelSimd(NivelSimd maximo);
+
+// "escalar", "sse41" ou "avx2"
+const char* nomeNivelSimd(NivelSimd nivel);
+
+#endif // DETECCAOCPU_H
@@ -0,0 +1,241 @@
+// DivisorCampos.cpp - Localização vetorial de delimitadores e leitor de registros em blocos
+#include "DivisorCampos.h"
+#include "DeteccaoCPU.h"
+#include "EstoqueException.h"
+#include <cctype>
+#include <climits>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ESTOQUE_X86_GNU 1
+#include <immintrin.h>
+// SSE2 faz parte do x86-64 base; só AVX2 precisa de atributo de alvo
+#define ALVO_AVX2 __attribute__((target("avx2")))
+#endif
+
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::string;
+
+// Bytes lidos do arquivo por vez (o buffer só cresce para linhas maiores que isso)
+static const size_t TAMANHO_BLOCO = 1 << 20;
+
+// === KERNELS ===
+
+static size_t localizarEscalar(const char* dados, size_t inicio, size_t n, char separador,
+                               uint32_t* posicoes, size_t encontrados) {
+    for (size_t i = inicio; i < n; ++i) {
+        if (dados[i] == separador || dados[i] == '\n') {
+            posicoes[encontrados++] = static_cast<uint32_t>(i);
+        }
+    }
+    return encontrados;
+}
+
+#ifdef ESTOQUE_X86_GNU
+
+// Converte os bits ligados da máscara em posições (um por delimitador)
+static inline size_t emitirPosicoes(uint64_t mascara, size_t base, uint32_t* posicoes, size_t encontrados) {
+    while (mascara) {
+        posicoes[encontrados++] = static_cast<uint32_t>(base + __builtin_ctzll(mascara));
+        mascara &= mascara - 1;  // Desliga o bit mais baixo
+    }
+    return encontrados;
+}
+
+// AVX2: 64 bytes por iteração (duas comparações de 32 bytes -> máscara de 64 bits)
+ALVO_AVX2 static size_t localizarAvx2(const char* dados, size_t n, char separador,
+                                      uint32_t* posicoes, size_t& encontrados) {
+    const __m256i vSeparador = _mm256_set1_epi8(separador);
+    const __m256i vQuebra = _mm256_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dados + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dados + i + 32));
+        uint32_t ma = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(a, vSeparador), _mm256_cmpeq_epi8(a, vQuebra))));
+        uint32_t mb = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(b, vSeparador), _mm256_cmpeq_epi8(b, vQuebra))));
+        encontrados = emitirPosicoes(ma | (static_cast<uint64_t>(mb) << 32), i, posicoes, encontrados);
+    }
+    return i;
+}
+
+// SSE2: 32 bytes por iteração (duas comparações de 16 bytes -> máscara de 32 bits)
+static size_t localizarSse2(const char* dados, size_t n, char separador,
+                            uint32_t* posicoes, size_t& encontrados) {
+    const __m128i vSeparador = _mm_set1_epi8(separador);
+    const __m128i vQuebra = _mm_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dados + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dados + i + 16));
+        uint32_t ma = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(a, vSeparador), _mm_cmpeq_epi8(a, vQuebra))));
+        uint32_t mb = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(b, vSeparador), _mm_cmpeq_epi8(b, vQuebra))));
+        encontrados = emitirPosicoes(ma | (mb << 16), i, posicoes, encontrados);
+    }
+    return i;
+}
+
+#endif // ESTOQUE_X86_GNU
+
+// Blocos completos no nível ativo; a cauda é escalar
+size_t localizarDelimitadores(const char* dados, size_t n, char separador, uint32_t* posicoes) {
+    size_t encontrados = 0;
+    size_t feitos = 0;
+#ifdef ESTOQUE_X86_GNU
+    NivelSimd nivel = nivelSimdAtivo();
+    if (nivel == SIMD_AVX2) {
+        feitos = localizarAvx2(dados, n, separador, posicoes, encontrados);
+    } else if (nivel == SIMD_SSE41) {
+        feitos = localizarSse2(dados, n, separador, posicoes, encontrados);
+    }
+#endif
+    return localizarEscalar(dados, feitos, n, separador, posicoes, encontrados);
+}
+
+// === LEITOR DE REGISTROS ===
+
+LeitorRegistros::LeitorRegistros(std::istream& entrada, char separador)
+    : entrada(entrada), separador(separador), buffer(TAMANHO_BLOCO), cursor(0), fimValido(0),
+      basePosicoes(0), proximaPosicao(0), numPosicoes(0), fimEntrada(false), quebra(true) {
+}
+
+// Cada delimitador fecha um campo; '\n' fecha também a linha.
+// Sem delimitadores restantes no bloco: recarrega e continua a mesma linha.
+bool LeitorRegistros::proximo() {
+    limites.clear();
+    size_t inicio = cursor;
+    for (;;) {
+        while (proximaPosicao < numPosicoes) {
+            size_t p = basePosicoes + posicoes[proximaPosicao++];
+            limites.push_back(inicio);
+            limites.push_back(p);
+            inicio = p + 1;
+            if (buffer[p] == '\n') {
+                cursor = inicio;
+                quebra = true;
+                return true;
+            }
+        }
+        if (fimEntrada) {
+            break;
+        }
+        // recarregar() move a linha pendente para o início do buffer
+        size_t deslocamento = cursor;
+        recarregar();
+        inicio -= deslocamento;
+        for (size_t i = 0; i < limites.size(); ++i) {
+            limites[i] -= deslocamento;
+        }
+    }
+
+    // Fim do arquivo: o que sobrou é a última linha, sem '\n'
+    if (inicio == fimValido && limites.empty()) {
+        cursor = fimValido;
+        return false;
+    }
+    limites.push_back(inicio);
+    limites.push_back(fimValido);
+    cursor = fimValido;
+    quebra = false;
+    return true;
+}
+
+void LeitorRegistros::recarregar() {
+    size_t pendente = fimValido - cursor;
+    if (cursor > 0 && pendente > 0) {
+        std::memmove(&buffer[0], &buffer[cursor], pendente);
+    }
+    cursor = 0;
+    fimValido = pendente;
+    if (fimValido == buffer.size()) {
+        buffer.resize(buffer.size() * 2);  // Linha maior que o buffer inteiro
+    }
+
+    size_t pedidos = buffer.size() - fimValido;
+    entrada.read(&buffer[fimValido], static_cast<std::streamsize>(pedidos));
+    size_t lidos = static_cast<size_t>(entrada.gcount());
+    if (lidos < pedidos) {
+        fimEntrada = true;  // read() só entrega menos que o pedido no fim do arquivo
+    }
+    if (posicoes.size() < lidos) {
+        posicoes.resize(lidos);
+    }
+    basePosicoes = fimValido;
+    numPosicoes = lidos ? localizarDelimitadores(&buffer[fimValido], lidos, separador, &posicoes[0]) : 0;
+    proximaPosicao = 0;
+    fimValido += lidos;
+}
+
+size_t LeitorRegistros::numCampos() const {
+    return limites.size() / 2;
+}
+
+const char* LeitorRegistros::inicioCampo(size_t i) const {
+    return i < numCampos() ? &buffer[limites[2 * i]] : "";
+}
+
+size_t LeitorRegistros::tamanhoCampo(size_t i) const {
+    return i < numCampos() ? limites[2 * i + 1] - limites[2 * i] : 0;
+}
+
+string LeitorRegistros::campo(size_t i) const {
+    return string(inicioCampo(i), tamanhoCampo(i));
+}
+
+bool LeitorRegistros::campoIgual(size_t i, const char* texto) const {
+    size_t tamanho = std::strlen(texto);
+    return tamanhoCampo(i) == tamanho && std::memcmp(inicioCampo(i), texto, tamanho) == 0;
+}
+
+// Regra de std::stoi: espaços, sinal, dígitos; o que vem depois é ignorado
+// Retorna false sem dígitos ou com magnitude acima de 'maximo'
+static bool lerMagnitude(const char* p, const char* fim, unsigned long long maximo,
+                         unsigned long long& magnitude, bool& negativo) {
+    while (p < fim && std::isspace(static_cast<unsigned char>(*p))) ++p;
+    negativo = false;
+    if (p < fim && (*p == '+' || *p == '-')) {
+        negativo = (*p == '-');
+        ++p;
+    }
+    const char* digitos = p;
+    magnitude = 0;
+    for (; p < fim && *p >= '0' && *p <= '9'; ++p) {
+        unsigned d = static_cast<unsigned>(*p - '0');
+        if (magnitude > (maximo - d) / 10) {
+            return false;
+        }
+        magnitude = magnitude * 10 + d;
+    }
+    return p != digitos;
+}
+
+int LeitorRegistros::campoInteiro(size_t i) const {
+    const char* p = inicioCampo(i);
+    unsigned long long magnitude;
+    bool negativo;
+    // INT_MAX + 1 cabe apenas como negativo (INT_MIN)
+    if (!lerMagnitude(p, p + tamanhoCampo(i), static_cast<unsigned long long>(INT_MAX) + 1, magnitude, negativo)
+        || (!negativo && magnitude > static_cast<unsigned long long>(INT_MAX))) {
+        throw EstoqueException("numero invalido: '" + campo(i) + "'");
+    }
+    return negativo ? static_cast<int>(-static_cast<long long>(magnitude)) : static_cast<int>(magnitude);
+}
+
+unsigned long long LeitorRegistros::campoSemSinal(size_t i) const {
+    const char* p = inicioCampo(i);
+    unsigned long long magnitude;
+    bool negativo;
+    if (!lerMagnitude(p, p + tamanhoCampo(i), ULLONG_MAX, magnitude, negativo) || negativo) {
+        throw EstoqueException("numero invalido: '" + campo(i) + "'");
+    }
+    return magnitude;
+}
+
+bool LeitorRegistros::terminaEmQuebra() const {
+    return quebra;
+}
@@ -0,0 +1,100 @@
+#ifndef DIVISORCAMPOS_H
+#define DIVISORCAMPOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * Localiza o separador e '\n' em dados[0, n), em ordem.
+ *
+ * Compara 64 bytes por iteração (AVX2), 32 (SSE2) ou 1 (escalar), conforme
+ * nivelSimdAtivo() (DeteccaoCPU.h); o nível SSE4.1 usa apenas SSE2.
+ * As três versões dão o mesmo resultado.
+ *
+ * Parâmetro:
+ *   - posicoes: vetor com ao menos n posições; recebe o índice de cada delimitador
+ * Retorna: número de delimitadores encontrados
+ */
+std::size_t localizarDelimitadores(const char* dados, std::size_t n, char separador,
+                                   std::uint32_t* posicoes);
+
+/**
+ * Leitor de registros de texto delimitado (itens.txt, movimentos.txt, diário).
+ *
+ * Substitui getline(arquivo) + stringstream + getline(ss, campo, ';'):
+ * lê o arquivo em blocos de 1 MB, localiza todos os delimitadores do bloco
+ * de uma vez (localizarDelimitadores) e expõe os campos de cada linha como
+ * trechos do bloco, sem cópia nem alocação por campo.
+ *
+ * Mesma divisão do getline: '\r' final fica no último campo; campos
+ * ausentes valem "" (campo(i) com i >= numCampos()).
+ *
+ * Exemplo:
+ *   std::ifstream arq("movimentos.txt");
+ *   LeitorRegistros leitor(arq);
+ *   while (leitor.proximo()) {
+ *       int id = leitor.campoInteiro(0);
+ *       std::string data = leitor.campo(1);
+ *   }
+ */
+class LeitorRegistros {
+public:
+    explicit LeitorRegistros(std::istream& entrada, char separador = ';');
+
+    /**
+     * Avança para a próxima linha.
+     * Retorna: false no fim do arquivo (linha final vazia não é registro)
+     */
+    bool proximo();
+
+    // Campos da linha atual
+    std::size_t numCampos() const;
+
+    // Trecho do campo i (válido até a próxima chamada de proximo); "" fora do intervalo
+    const char* inicioCampo(std::size_t i) const;
+    std::size_t tamanhoCampo(std::size_t i) const;
+
+    // Cópia do campo i
+    std::string campo(std::size_t i) const;
+
+    // Compara o campo i com texto (sem cópia)
+    bool campoIgual(std::size_t i, const char* texto) const;
+
+    /**
+     * Converte o campo i com a mesma regra de std::stoi: espaços iniciais
+     * e sinal opcionais, ao menos um dígito, o restante é ignorado.
+     * Lança: EstoqueException se não houver dígitos ou o valor não couber em int
+     */
+    int campoInteiro(std::size_t i) const;
+
+    /**
+     * Converte o campo i como inteiro sem sinal de 64 bits (sequência do diário).
+     * Lança: EstoqueException se não houver dígitos ou o valor não couber
+     */
+    unsigned long long campoSemSinal(std::size_t i) const;
+
+    // false se a linha atual é a última do arquivo e não termina em '\n' (gravação interrompida)
+    bool terminaEmQuebra() const;
+
+private:
+    // Traz mais bytes do arquivo; desloca a linha incompleta para o início do buffer
+    void recarregar();
+
+    std::istream& entrada;
+    char separador;
+    std::vector<char> buffer;
+    std::size_t cursor;                    // Início da próxima linha
+    std::size_t fimValido;                 // Bytes lidos em buffer
+    std::vector<std::uint32_t> posicoes;   // Delimitadores do último bloco lido
+    std::size_t basePosicoes;              // Posição do bloco no buffer
+    std::size_t proximaPosicao;
+    std::size_t numPosicoes;
+    bool fimEntrada;
+    std::vector<std::size_t> limites;      // Campo i = [limites[2i], limites[2i+1])
+    bool quebra;
+};
+
+#endif // DIVISORCAMPOS_H
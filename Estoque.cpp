@@ -3,10 +3,26 @@
 #include "Estoque.h"
 #include "ItemProduto.h"
 #include "ItemMateria.h"
+#include "RegistroTiposItem.h"
+#include "CheckpointEstoque.h"
+#include "PoolTarefas.h"
+#include "DivisorCampos.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <limits> // Para std::numeric_limits
+#include <utility> // Para std::move
+#include <algorithm> // Para std::partial_sort
+#include <ctime> // Janela de datas dos rankings e da compactação
+#include <cstdio> // Para std::rename (resumo gravado de forma atômica)
+#include <cstdlib> // Para std::strtol (ID da última linha de movimentos.txt)
+#include <cerrno>
+#include <cstring> // Para std::strerror (falha do fork)
+#ifndef _WIN32
+#include <fcntl.h> // Para open (gravação no filho do salvamento em segundo plano)
+#include <sys/wait.h> // Para waitpid (salvamento em segundo plano)
+#include <unistd.h> // Para sysconf (tamanho de página no cálculo do RSS), fork, write e _exit
+#endif
 
 using std::string;
 using std::cout;
@@ -19,6 +35,11 @@ using std::getline;
 using std::stoi;
 using std::to_string;
 using std::exception;
+using std::shared_ptr;
+using std::vector;
+using std::lock_guard;
+using std::mutex;
+using std::unordered_map;
 
 // Função utilitária local: lê string do usuário via std::cin
 // Usada apenas em editarItem()
@@ -34,6 +55,25 @@ static string lerString(const string& prompt) {
 // são feitas em `main.cpp`. Mantemos aqui apenas helpers de string
 // que são usados internamente por `Estoque::editarItem`.
 
+// Copia o estado atual de um item para um EstadoItem imutável (snapshot)
+// Tipo e detalhe via etiqueta (RegistroTiposItem.h): sem chamadas virtuais
+static shared_ptr<const EstadoItem> capturarEstado(const Item* item) {
+    shared_ptr<EstadoItem> estado(new EstadoItem());
+    estado->id = item->getId();
+    estado->tipo = item->getTipoItem();
+    estado->nome = item->getNome();
+    estado->descricao = item->getDescricao();
+    estado->quantidade = item->getQuantidade();
+    estado->link = item->getLink();
+    estado->detalhe = detalheItem(*item);
+    estado->minimo = item->getMinimo();
+    estado->versao = item->getVersao();
+    return estado;
+}
+
+// Definição do membro estático (necessária em C++11 quando usado por referência)
+const std::size_t Estoque::MIN_ENTRADAS_CHECKPOINT;
+
 // === CONSTRUTOR E DESTRUTOR ===
 
 // Construtor do Estoque
@@ -41,30 +81,38 @@ static string lerString(const string& prompt) {
 // - Cria listas vazias (itens, historico)
 // - Chama carregarDados() para carregar estado anterior dos arquivos
 // - Se arquivos não existem: começa com estoque vazio
-Estoque::Estoque() {
+Estoque::Estoque()
+    : versao(0), proximoIdReserva(1), versaoColunaQuantidades(0), colunaQuantidadesValida(false),
+      ultimoMovimentoArquivado(0),
+      historicoCarregado(false), ultimoMovimentoEmDisco(0), ultimoMovimentoGravado(0),
+      faltaQuebraLinha(false), regravarMovimentos(false), seqDiario(0), entradasDiario(0),
+      checkpointEmDia(false), faltaQuebraDiario(false), checkpointAgendado(false),
+      pidSalvamento(0), movimentosNoSalvamento(false),
+      epocaAtual(std::make_shared<EpocaHistorico>()) {
+    StatusSalvamento nenhum = { SALVAMENTO_NENHUM, 0, 0, 0 };
+    ultimoSalvamento = nenhum;
     // Ao criar o objeto, tenta carregar dados persistidos
     carregarDados();
 }
 
 // Destrutor do Estoque
 // Comportamento:
-// - Salva dados atuais em arquivo (itens.txt, movimentos.txt)
-// - Libera memória alocada dinamicamente:
-//   * Itera por todos Item* e chama delete
-//   * Itera por todos MovimentoEstoque* e chama delete
-// - Evita memory leaks críticos
+// - Salva dados atuais em arquivo (diário, movimentos.txt)
+// - Espera o checkpoint em fundo (se agendado) e grava o checkpoint final
+//   (itens.txt, estoque.ckp): a próxima carga não reaplica diário
+// - Itens e movimentos são liberados pelas listas (unique_ptr)
 Estoque::~Estoque() {
     // Salva dados antes de destruir (persistência)
     salvarDados();
-
-    // Libera a memória alocada para os itens (cada ponteiro Item* foi criado com new)
-    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
-        delete itens.get(i);  // delete chama destrutor do Item antes de liberar memória
-    }
-
-    // Libera a memória alocada para o histórico (cada MovimentoEstoque* foi criado com new)
-    for (std::size_t i = 0; i < historico.tamanho(); ++i) {
-        delete historico.get(i);  // delete chama destrutor do MovimentoEstoque
+    try {
+        tarefasFundo.aguardar();  // Tarefas de fundo usam this
+        // Diário curto: a próxima carga o reaplica; checkpoint só se o
+        // automático não o esvaziou (ex: descartado por entradas novas)
+        if (diarioNoLimiteCheckpoint(versoesGravadas.size())) {
+            gravarCheckpoint();
+        }
+    } catch (const EstoqueException& e) {
+        cerr << "Erro: " << e.what() << endl;  // Diário preservado: nada se perde
     }
 }
 
@@ -77,11 +125,167 @@ Estoque::~Estoque() {
 // Validação:
 //   - Verifica se item != nullptr (não valida duplicata de ID)
 // 
+// Quantidade do cadastro entra no histórico como ENTRADA (saldo inicial)
+// 
 // Requisito POO: recebe Item* (tipo base, polimórfico)
 void Estoque::adicionarItem(Item* item) {
+    ESTOQUE_MEDIR(metricas, OP_ADICIONAR_ITEM);
     if (item != nullptr) {  // Validação básica: não é nullptr
-        itens.adicionar(item);  // Adiciona à lista genérica
+        lock_guard<mutex> trava(mutexEstado);
+        inserirItem(item);
+        registrarSaldoInicial(*item);
+
+        OperacaoDesfazivel operacao;
+        operacao.tipo = DESFAZ_ADICIONAR_ITEM;
+        operacao.idItem = item->getId();
+        operacao.quantidade = 0;
+        operacao.item = item;
+        logDesfazer.registrar(std::move(operacao));
+        ++versao;
+    }
+}
+
+// Lista + índice de IDs + observador + índices de texto e de detalhe
+void Estoque::inserirItem(Item* item) {
+    itens.adicionar(std::unique_ptr<Item>(item));  // A lista passa a ser dona do item
+    {
+        ParticaoIds& particao = particaoId(item->getId());
+        lock_guard<mutex> trava(particao.trava);
+        particao.itens[item->getId()] = item;
+    }
+    item->setObservador(this);  // Alertas de estoque baixo e índices de texto
+    alertas.registrarItem(*item);
+    indiceNomes.adicionar(item->getId(), item->getNome());
+    indiceDescricoes.adicionar(item->getId(), item->getDescricao());
+    indicesDetalhe[item->getTipoItem()].adicionar(item->getId(), detalheItem(*item));
+}
+
+// Inverso de inserirItem: o objeto continua vivo (removerItem o entrega ao log)
+Item* Estoque::retirarItem(int id) {
+    // Itera por todos os items
+    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
+        Item* item = itens[i].get();
+        // Testa se ID corresponde
+        if (item->getId() == id) {
+            // Reservas ativas apontam para o item: precisam ser confirmadas ou liberadas antes
+            // Verificado sob a trava da partição: reservar() não entra no meio
+            {
+                ParticaoIds& particao = particaoId(id);
+                lock_guard<mutex> trava(particao.trava);
+                if (item->getReservado() > 0) {
+                    throw EstoqueException("Item com ID " + to_string(id) + " possui reservas ativas.");
+                }
+                particao.itens.erase(id);
+            }
+            // Snapshots já publicados guardam cópia do estado (não o ponteiro)
+            estadosPublicados.erase(id);
+            alertas.removerItem(id);
+            indiceNomes.remover(id);
+            indiceDescricoes.remover(id, item->getDescricao());
+            indicesDetalhe[item->getTipoItem()].remover(id, detalheItem(*item));
+            itens[i].release();   // Posse passa para quem chamou
+            itens.remover(i);     // Remove o ponteiro da lista
+            return item;
+        }
+    }
+    // Se chegar aqui, não encontrou
+    throw EstoqueException("Item com ID " + to_string(id) + " nao encontrado para remocao.");
+}
+
+// Adiciona itens em lote (importador CSV, cargas grandes)
+// Diferença para adicionarItem: uma reserva de capacidade e uma
+// reconstrução de índices para o lote inteiro
+void Estoque::adicionarItens(const vector<Item*>& novos, bool registrarSaldos) {
+    lock_guard<mutex> trava(mutexEstado);
+    itens.reservar(itens.tamanho() + novos.size());
+    for (std::size_t i = 0; i < novos.size(); ++i) {
+        if (novos[i] != nullptr) {
+            itens.adicionar(std::unique_ptr<Item>(novos[i]));
+            if (registrarSaldos) {
+                registrarSaldoInicial(*novos[i]);
+            }
+        }
+    }
+    reconstruirIndices();
+    ++versao;
+}
+
+// Cadastro com quantidade > 0: ENTRADA no histórico, para que o saldo
+// reconstruído só dos movimentos (verificar_integridade) confira
+void Estoque::registrarSaldoInicial(const Item& item) {
+    if (item.getQuantidade() > 0) {
+        anexarMovimento(new MovimentoEstoque(ENTRADA, item.getQuantidade(), item.getId(), item.getNome()));
+    }
+}
+
+// Reconstrói os índices a partir da lista (O(n), uma vez por lote)
+// Os quatro grupos de índices são independentes: lotes grandes reconstroem
+// cada grupo em uma tarefa do pool (prioridade alta: a trava do Estoque
+// fica presa até o fim)
+void Estoque::reconstruirIndices() {
+    const std::size_t n = itens.tamanho();
+    std::function<void()> grupos[4] = {
+        [this, n]() {
+            // Partições montadas fora das travas e trocadas de uma vez
+            std::unordered_map<int, Item*> novas[NUM_PARTICOES_IDS];
+            for (std::size_t p = 0; p < NUM_PARTICOES_IDS; ++p) {
+                novas[p].reserve(n / NUM_PARTICOES_IDS + 1);
+            }
+            alertas.limpar();
+            for (std::size_t i = 0; i < n; ++i) {
+                Item* item = itens[i].get();
+                novas[static_cast<unsigned>(item->getId()) % NUM_PARTICOES_IDS][item->getId()] = item;
+                item->setObservador(this);
+                alertas.registrarItem(*item);
+            }
+            for (std::size_t p = 0; p < NUM_PARTICOES_IDS; ++p) {
+                lock_guard<mutex> trava(particoesIds[p].trava);
+                particoesIds[p].itens.swap(novas[p]);
+            }
+        },
+        [this, n]() {
+            indiceNomes.limpar();
+            indiceNomes.reservar(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                indiceNomes.adicionar(itens[i]->getId(), itens[i]->getNome());
+            }
+        },
+        [this, n]() {
+            indiceDescricoes.limpar();
+            for (std::size_t i = 0; i < n; ++i) {
+                indiceDescricoes.adicionar(itens[i]->getId(), itens[i]->getDescricao());
+            }
+        },
+        [this, n]() {
+            for (int t = 0; t < NUM_TIPOS_ITEM; ++t) {
+                indicesDetalhe[t].limpar();
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                const Item& item = *itens[i];
+                indicesDetalhe[item.getTipoItem()].adicionar(item.getId(), detalheItem(item));
+            }
+        }
+    };
+    if (n < MIN_ITENS_INDICES_PARALELOS) {
+        for (int g = 0; g < 4; ++g) grupos[g]();
+        return;
+    }
+    GrupoTarefas tarefas;
+    for (int g = 1; g < 4; ++g) {
+        tarefas.submeter(grupos[g], PRIORIDADE_ALTA);
     }
+    grupos[0]();
+    tarefas.aguardar();
+}
+
+// Procura pelo índice de IDs, sem exceção (uso interno)
+// Sem a trava da partição: quem escreve no índice também segura mutexEstado
+// Retorna: ponteiro para o Item ou nullptr se não existe
+// Complexidade: O(1) médio
+Item* Estoque::localizarItemPorId(int id) const {
+    const ParticaoIds& particao = particaoId(id);
+    std::unordered_map<int, Item*>::const_iterator it = particao.itens.find(id);
+    return (it != particao.itens.end()) ? it->second : nullptr;
 }
 
 // Busca um item pelo ID (procura linear)
@@ -92,15 +296,14 @@ void Estoque::adicionarItem(Item* item) {
 // 
 // Lança: EstoqueException se ID não existe
 // 
-// Algoritmo: iteração linear pela lista até encontrar
-// Complexidade: O(n) onde n = número de items
+// Algoritmo: consulta ao índice de IDs (particoesIds)
+// Complexidade: O(1) médio
 Item* Estoque::buscarItemPorId(int id) {
-    // Itera por todos os items
-    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
-        // Testa se ID corresponde
-        if (itens.get(i)->getId() == id) {
-            return itens.get(i);  // Encontrou! Retorna o ponteiro
-        }
+    ESTOQUE_MEDIR(metricas, OP_BUSCAR_POR_ID);
+    lock_guard<mutex> trava(mutexEstado);
+    Item* item = localizarItemPorId(id);
+    if (item != nullptr) {
+        return item;  // Encontrou! Retorna o ponteiro
     }
     // Se chegar aqui, não encontrou
     throw EstoqueException("Item com ID " + to_string(id) + " nao encontrado.");
@@ -117,43 +320,73 @@ Item* Estoque::buscarItemPorId(int id) {
 // Algoritmo: iteração linear pela lista até encontrar
 // Complexidade: O(n) onde n = número de items
 Item* Estoque::buscarItemPorNome(const string& nome) {
+    ESTOQUE_MEDIR(metricas, OP_BUSCAR_POR_NOME);
+    lock_guard<mutex> trava(mutexEstado);
     // Itera por todos os items
-    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
+    for (const std::unique_ptr<Item>& item : itens) {
         // Testa se nome corresponde
-        if (itens.get(i)->getNome() == nome) {
-            return itens.get(i);  // Encontrou! Retorna o ponteiro
+        if (item->getNome() == nome) {
+            return item.get();  // Encontrou! Retorna o ponteiro (a lista continua dona)
         }
     }
     // Se chegar aqui, não encontrou
     throw EstoqueException("Item com nome '" + nome + "' nao encontrado.");
 }
 
+// Busca aproximada pelo índice de trigramas
+// Retorna: itens ordenados do mais parecido para o menos (vazio se nenhum)
+vector<Item*> Estoque::buscarItensPorNomeAproximado(const string& consulta, std::size_t limite) {
+    ESTOQUE_MEDIR(metricas, OP_BUSCAR_POR_NOME_APROXIMADO);
+    lock_guard<mutex> trava(mutexEstado);
+    vector<CandidatoNome> candidatos = indiceNomes.buscar(consulta, limite);
+    vector<Item*> encontrados;
+    encontrados.reserve(candidatos.size());
+    for (std::size_t i = 0; i < candidatos.size(); ++i) {
+        encontrados.push_back(localizarItemPorId(candidatos[i].idItem));
+    }
+    return encontrados;
+}
+
+// Busca pelas palavras da descrição (índice invertido)
+// Retorna: itens em ordem de ID
+vector<Item*> Estoque::buscarPorDescricao(const string& consulta) {
+    ESTOQUE_MEDIR(metricas, OP_BUSCAR_POR_DESCRICAO);
+    lock_guard<mutex> trava(mutexEstado);
+    vector<int> ids = indiceDescricoes.consultar(consulta);
+    vector<Item*> encontrados;
+    encontrados.reserve(ids.size());
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        encontrados.push_back(localizarItemPorId(ids[i]));
+    }
+    return encontrados;
+}
+
 // Remove um item do estoque pelo ID
 // Parâmetro:
 //   - id: ID único do item a remover
 // 
 // Comportamento:
-//   - Busca item com este ID
-//   - delete libera memória do Item
-//   - Remove ponteiro da lista
+//   - Busca item com este ID e retira da lista e dos índices
+//   - O objeto não é apagado: fica no log de desfazer (desfazer() o devolve)
+//     e é liberado quando sai do log
 //   - Exibe mensagem de sucesso
 // 
 // Lança: EstoqueException se ID não existe
 // 
 // Nota: movimentos históricos do item permanecem (auditoria)
 void Estoque::removerItem(int id) {
-    // Itera por todos os items
-    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
-        // Testa se ID corresponde
-        if (itens.get(i)->getId() == id) {
-            delete itens.get(i);  // Libera a memória do Item
-            itens.remover(i);     // Remove o ponteiro da lista
-            cout << "Item removido com sucesso." << endl;
-            return;  // Saiu
-        }
-    }
-    // Se chegar aqui, não encontrou
-    throw EstoqueException("Item com ID " + to_string(id) + " nao encontrado para remocao.");
+    ESTOQUE_MEDIR(metricas, OP_REMOVER_ITEM);
+    lock_guard<mutex> trava(mutexEstado);
+    Item* item = retirarItem(id);  // Lança exceção se não existe ou tem reservas
+
+    OperacaoDesfazivel operacao;
+    operacao.tipo = DESFAZ_REMOVER_ITEM;
+    operacao.idItem = id;
+    operacao.quantidade = 0;
+    operacao.item = item;  // O log passa a ser dono do objeto
+    logDesfazer.registrar(std::move(operacao));
+    ++versao;
+    cout << "Item removido com sucesso." << endl;
 }
 
 // Edita dados de um item existente
@@ -188,8 +421,22 @@ void Estoque::editarItem(int id) {
     if (novaDesc.empty()) novaDesc = item->getDescricao();
     if (novoLink.empty()) novoLink = item->getLink();
 
-    // Atualiza dados do item
-    item->atualizarDados(novoNome, novaDesc, novoLink);
+    // Atualiza dados do item (sob trava: leitura interativa acima fica fora dela)
+    {
+        lock_guard<mutex> trava(mutexEstado);
+        OperacaoDesfazivel operacao;
+        operacao.tipo = DESFAZ_EDITAR_ITEM;
+        operacao.idItem = id;
+        operacao.quantidade = 0;
+        operacao.item = nullptr;
+        operacao.nome = item->getNome();
+        operacao.descricao = item->getDescricao();
+        operacao.link = item->getLink();
+
+        item->atualizarDados(novoNome, novaDesc, novoLink);
+        logDesfazer.registrar(std::move(operacao));
+        ++versao;
+    }
 
     // Nota: A especificação não pede para editar categoria/fornecedor,
     // mas poderia ser adicionado aqui com um dynamic_cast para ItemProduto/ItemMateria.
@@ -210,19 +457,27 @@ void Estoque::editarItem(int id) {
 // - exibirDetalhes() é virtual, chama método correto
 // - ItemProduto exibe categoria, ItemMateria exibe fornecedor
 // 
+// Leitura feita sobre um snapshot: não bloqueia movimentações durante a listagem
+// (só os itens são usados: o histórico gravado não é carregado)
+// 
 // const: método apenas lê, não modifica estoque
 void Estoque::listarItens() const {
+    shared_ptr<const SnapshotEstoque> snapshot;
+    {
+        lock_guard<mutex> trava(mutexEstado);
+        snapshot = montarSnapshot();
+    }
+    const vector<shared_ptr<const EstadoItem> >& estados = snapshot->getItens();
+
     // Verifica se há items
-    if (itens.tamanho() == 0) {
+    if (estados.empty()) {
         cout << "Nenhum item no estoque." << endl;
         return;
     }
     
-    // Polimorfismo acontece aqui!
-    // A lista chama o método exibirDetalhes() correto
-    // para ItemProduto ou ItemMateria conforme tipo real.
-    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
-        itens.get(i)->exibirDetalhes();  // Chamada virtual - comportamento polimórfico
+    // Cada EstadoItem exibe com o layout de ItemProduto ou ItemMateria
+    for (std::size_t i = 0; i < estados.size(); ++i) {
+        estados[i]->exibirDetalhes();
     }
 }
 
@@ -234,16 +489,169 @@ void Estoque::listarItens() const {
 // 
 // const: método apenas lê, não modifica histórico
 void Estoque::exibirHistorico() const {
+    shared_ptr<const SnapshotEstoque> snapshot = obterSnapshot();
+
     // Verifica se há movimentos
-    if (historico.tamanho() == 0) {
+    if (snapshot->tamanhoHistorico() == 0) {
         cout << "Nenhuma movimentacao no historico." << endl;
         return;
     }
     
     // Itera e exibe cada movimento com resumo formatado
-    for (std::size_t i = 0; i < historico.tamanho(); ++i) {
-        cout << historico.get(i)->gerarResumo() << endl;
+    for (std::size_t i = 0; i < snapshot->tamanhoHistorico(); ++i) {
+        cout << snapshot->movimento(i)->gerarResumo() << endl;
+    }
+}
+
+// Snapshot completo: garante o histórico gravado antes de montar
+shared_ptr<const SnapshotEstoque> Estoque::obterSnapshot() const {
+    lock_guard<mutex> trava(mutexEstado);
+    carregarHistorico();
+    return montarSnapshot();
+}
+
+// Monta (ou reaproveita) o snapshot MVCC do estoque
+// 
+// Algoritmo:
+// 1. Para cada item, reutiliza o EstadoItem publicado se a versão do Item não mudou;
+//    caso contrário copia o estado atual (copy-on-write)
+// 2. Se nenhum item mudou e a versão/histórico são os mesmos: devolve o snapshot anterior
+// 3. Sela os blocos cheios do histórico que ainda não foram selados
+// 4. Copia apenas o bloco final (parcial) do histórico
+// 
+// Complexidade: O(n itens) comparações + O(itens alterados + movimentos novos) cópias
+shared_ptr<const SnapshotEstoque> Estoque::montarSnapshot() const {
+    bool mudou = !snapshotAtual
+              || snapshotAtual->getVersao() != versao
+              || snapshotAtual->getItens().size() != itens.tamanho()
+              || snapshotAtual->tamanhoHistorico() != historico.tamanho();
+
+    vector<shared_ptr<const EstadoItem> > estados;
+    estados.reserve(itens.tamanho());
+    for (const std::unique_ptr<Item>& item : itens) {
+        shared_ptr<const EstadoItem>& publicado = estadosPublicados[item->getId()];
+        if (!publicado || publicado->versao != item->getVersao()) {
+            publicado = capturarEstado(item.get());  // Item alterado: nova cópia
+            mudou = true;
+        }
+        estados.push_back(publicado);
+    }
+
+    if (!mudou) {
+        return snapshotAtual;  // Nada mudou: mesmo snapshot para todos os leitores
+    }
+
+    // Sela blocos cheios ainda não selados
+    const std::size_t tamBloco = SnapshotEstoque::TAMANHO_BLOCO;
+    while ((blocosSelados.size() + 1) * tamBloco <= historico.tamanho()) {
+        std::size_t inicio = blocosSelados.size() * tamBloco;
+        shared_ptr<BlocoHistorico> bloco(new BlocoHistorico());
+        bloco->reserve(tamBloco);
+        for (std::size_t i = inicio; i < inicio + tamBloco; ++i) {
+            bloco->push_back(historico[i].get());
+        }
+        blocosSelados.push_back(bloco);
+    }
+
+    // Bloco final parcial: único trecho do histórico copiado a cada snapshot
+    vector<shared_ptr<const BlocoHistorico> > blocos(blocosSelados);
+    std::size_t inicioParcial = blocosSelados.size() * tamBloco;
+    if (inicioParcial < historico.tamanho()) {
+        shared_ptr<BlocoHistorico> parcial(new BlocoHistorico());
+        parcial->reserve(historico.tamanho() - inicioParcial);
+        for (std::size_t i = inicioParcial; i < historico.tamanho(); ++i) {
+            parcial->push_back(historico[i].get());
+        }
+        blocos.push_back(parcial);
+    }
+
+    snapshotAtual = std::make_shared<const SnapshotEstoque>(versao, std::move(estados),
+                                                            std::move(blocos), historico.tamanho(),
+                                                            epocaAtual);
+    return snapshotAtual;
+}
+
+// === MEMÓRIA ===
+
+// Estimativa de bytes de uma tabela hash (nós + vetor de buckets)
+// Cada nó guarda o par chave/valor e o ponteiro para o próximo nó
+template <typename Mapa>
+static std::size_t bytesTabelaHash(const Mapa& mapa) {
+    return mapa.size() * (sizeof(typename Mapa::value_type) + sizeof(void*)) +
+           mapa.bucket_count() * sizeof(void*);
+}
+
+// Memória residente do processo (0 se indisponível)
+static std::size_t lerRssProcesso() {
+#ifdef __linux__
+    ifstream statm("/proc/self/statm");
+    std::size_t paginasTotal = 0, paginasResidentes = 0;
+    if (statm >> paginasTotal >> paginasResidentes) {
+        return paginasResidentes * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+// Gera o relatório de memória percorrendo itens, histórico, índices e cache
+// Cada objeto contabiliza seus próprios campos (contabilizarMemoria)
+RelatorioMemoria Estoque::gerarRelatorioMemoria() const {
+    RelatorioMemoria relatorio;
+    {
+        lock_guard<mutex> trava(mutexEstado);
+
+        relatorio.numItens = itens.tamanho();
+        for (const std::unique_ptr<Item>& item : itens) {
+            item->contabilizarMemoria(relatorio);
+        }
+        for (const std::unique_ptr<MovimentoEstoque>& mov : historico) {
+            mov->contabilizarMemoria(relatorio);
+        }
+
+        relatorio.tamanhoListaItens = itens.tamanho();
+        relatorio.capacidadeListaItens = itens.capacidade();
+        relatorio.tamanhoListaHistorico = historico.tamanho();
+        relatorio.capacidadeListaHistorico = historico.capacidade();
+
+        relatorio.entradasIndices = 0;
+        relatorio.bytesIndices = indiceNomes.bytesOcupados() + indiceDescricoes.bytesOcupados();
+        for (std::size_t p = 0; p < NUM_PARTICOES_IDS; ++p) {
+            relatorio.entradasIndices += particoesIds[p].itens.size();
+            relatorio.bytesIndices += bytesTabelaHash(particoesIds[p].itens);
+        }
+        for (int t = 0; t < NUM_TIPOS_ITEM; ++t) {
+            relatorio.bytesIndices += indicesDetalhe[t].bytesOcupados();
+        }
+        relatorio.bytesIndices += bytesTabelaHash(totalSaidasPorItem);
+
+        // Estados publicados: objeto + bloco de controle do shared_ptr + strings
+        relatorio.estadosPublicados = estadosPublicados.size();
+        relatorio.bytesSnapshots = bytesTabelaHash(estadosPublicados);
+        std::unordered_map<int, shared_ptr<const EstadoItem> >::const_iterator it;
+        for (it = estadosPublicados.begin(); it != estadosPublicados.end(); ++it) {
+            const EstadoItem& e = *it->second;
+            relatorio.bytesSnapshots += sizeof(EstadoItem) + 2 * sizeof(long) +
+                bytesHeapString(e.nome) + bytesHeapString(e.descricao) +
+                bytesHeapString(e.link) + bytesHeapString(e.detalhe);
+        }
+        for (std::size_t b = 0; b < blocosSelados.size(); ++b) {
+            relatorio.bytesSnapshots += sizeof(BlocoHistorico) + blocosSelados[b]->capacity() * sizeof(void*);
+        }
     }
+    relatorio.rssBytes = lerRssProcesso();
+    return relatorio;
+}
+
+// === MÉTRICAS ===
+
+// Histogramas de latência (somente leitura)
+const MetricasEstoque& Estoque::obterMetricas() const {
+    return metricas;
+}
+
+// Zera os histogramas (registros concorrentes continuam válidos)
+void Estoque::zerarMetricas() {
+    metricas.zerar();
 }
 
 // === MOVIMENTAÇÕES ===
@@ -262,15 +670,29 @@ void Estoque::exibirHistorico() const {
 // 
 // Lança: EstoqueException se ID inválido ou qtd negativa
 void Estoque::registrarEntrada(int idItem, int qtd) {
+    ESTOQUE_MEDIR(metricas, OP_REGISTRAR_ENTRADA);
+    lock_guard<mutex> trava(mutexEstado);
+
     // Busca o item ou falha
-    Item* item = buscarItemPorId(idItem);
+    Item* item = localizarItemPorId(idItem);
+    if (item == nullptr) {
+        throw EstoqueException("Item com ID " + to_string(idItem) + " nao encontrado.");
+    }
     
     // Aumenta quantidade do item (valida e lança exceção se qtd < 0)
     item->adicionarQtd(qtd);
 
     // Cria novo movimento registrando esta operação
     MovimentoEstoque* mov = new MovimentoEstoque(ENTRADA, qtd, item->getId(), item->getNome());
-    historico.adicionar(mov);  // Adiciona ao histórico para auditoria
+    anexarMovimento(mov);  // Adiciona ao histórico para auditoria
+
+    OperacaoDesfazivel operacao;
+    operacao.tipo = DESFAZ_ENTRADA;
+    operacao.idItem = idItem;
+    operacao.quantidade = qtd;
+    operacao.item = nullptr;
+    logDesfazer.registrar(std::move(operacao));
+    ++versao;
 
     cout << "Entrada registrada com sucesso." << endl;
 }
@@ -294,201 +716,1575 @@ void Estoque::registrarEntrada(int idItem, int qtd) {
 // 
 // Lança: EstoqueException se ID inválido, qtd negativa, ou insuficiente em estoque
 void Estoque::registrarSaida(int idItem, int qtd) {
+    ESTOQUE_MEDIR(metricas, OP_REGISTRAR_SAIDA);
+    lock_guard<mutex> trava(mutexEstado);
+
     // Busca o item ou falha
-    Item* item = buscarItemPorId(idItem);
+    Item* item = localizarItemPorId(idItem);
+    if (item == nullptr) {
+        throw EstoqueException("Item com ID " + to_string(idItem) + " nao encontrado.");
+    }
     
     // Diminui quantidade do item (valida quantidade suficiente e lança exceção se problema)
     item->removerQtd(qtd);
 
     // Cria novo movimento registrando esta operação
     MovimentoEstoque* mov = new MovimentoEstoque(SAIDA, qtd, item->getId(), item->getNome());
-    historico.adicionar(mov);  // Adiciona ao histórico para auditoria
+    anexarMovimento(mov);  // Adiciona ao histórico para auditoria
+
+    OperacaoDesfazivel operacao;
+    operacao.tipo = DESFAZ_SAIDA;
+    operacao.idItem = idItem;
+    operacao.quantidade = qtd;
+    operacao.item = nullptr;
+    logDesfazer.registrar(std::move(operacao));
+    ++versao;
 
     cout << "Saida registrada com sucesso." << endl;
 }
 
-// === PERSISTÊNCIA ===
+// === RESERVAS ===
 
-// Salva todos os dados (items e movimentos) em arquivos de texto
-// 
-// Processo:
-// 1. Abre itens.txt, escreve cada item em formato:
-//    TYPE;ID;NAME;DESC;QTY;LINK;DETAIL
-// 2. Abre movimentos.txt, escreve cada movimento em formato:
-//    ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
+// Reserva quantidade de um item
 // 
-// Polimorfismo usado:
-// - getTipo() retorna "PRODUTO" ou "MATERIA"
-// - getDetalheEspecifico() retorna categoria ou fornecedor conforme tipo
+// A verificação de disponibilidade e a reserva acontecem em um único
+// compare-and-swap no saldo do Item (Item::reservarQtd). Busca e CAS ficam
+// sob a trava da partição do índice de IDs, sem mutexEstado: retirarItem
+// verifica o saldo reservado sob a mesma trava, então o item não some entre
+// a busca e o CAS. A tabela de reservas usa a trava da partição da reserva,
+// nunca junto com a do índice
 // 
-// const: método apenas lê dados, não modifica
-void Estoque::salvarDados() const {
-    // === Salvar Items ===
-    ofstream arqItens(ARQUIVO_ITENS);  // Abre arquivo para escrita
-    if (!arqItens.is_open()) {  // Verifica se abriu corretamente
-        cerr << "Erro: Nao foi possivel abrir o arquivo " << ARQUIVO_ITENS << " para salvar." << endl;
-        return;  // Falha silenciosa (não interrompe programa)
+// Retorna: ID da nova reserva
+// Lança: EstoqueException se ID inválido, qtd <= 0 ou disponível insuficiente
+int Estoque::reservar(int idItem, int qtd) {
+    ESTOQUE_MEDIR(metricas, OP_RESERVAR);
+    Item* item;
+    {
+        ParticaoIds& particaoItem = particaoId(idItem);
+        lock_guard<mutex> trava(particaoItem.trava);
+        unordered_map<int, Item*>::const_iterator it = particaoItem.itens.find(idItem);
+        if (it == particaoItem.itens.end()) {
+            throw EstoqueException("Item com ID " + to_string(idItem) + " nao encontrado.");
+        }
+        item = it->second;
+        item->reservarQtd(qtd);  // Lança exceção sem alterar nada se não houver saldo
     }
+    // Saldo reservado > 0: removerItem recusa o item até a reserva terminar,
+    // então o ponteiro guardado na reserva continua válido
 
-    // Itera por todos os items
-    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
-        Item* item = itens.get(i);  // Obtém ponteiro do item
-        
-        // Escreve em formato: TYPE;ID;NAME;DESC;QTY;LINK;DETAIL
-        // Polimorfismo: getTipo() e getDetalheEspecifico() variam por tipo
-        arqItens << item->getTipo() << ";"              // PRODUTO ou MATERIA
-                 << item->getId() << ";"
-                 << item->getNome() << ";"
-                 << item->getDescricao() << ";"
-                 << item->getQuantidade() << ";"
-                 << item->getLink() << ";"
-                 << item->getDetalheEspecifico() << "\n";  // categoria ou fornecedor
-    }
-    arqItens.close();  // Fecha arquivo
+    ReservaEstoque reserva;
+    reserva.id = proximoIdReserva.fetch_add(1, std::memory_order_relaxed);
+    reserva.idItem = idItem;
+    reserva.item = item;
+    reserva.quantidade = qtd;
+    reserva.criadaEm = std::chrono::steady_clock::now();
+    ParticaoReservas& particao = particaoReserva(reserva.id);
+    lock_guard<mutex> trava(particao.trava);
+    particao.reservas[reserva.id] = reserva;
+    return reserva.id;
+}
 
-    // === Salvar Movimentos ===
-    ofstream arqMov(ARQUIVO_MOVIMENTOS);  // Abre arquivo para escrita
-    if (!arqMov.is_open()) {  // Verifica se abriu corretamente
-        cerr << "Erro: Nao foi possivel abrir o arquivo " << ARQUIVO_MOVIMENTOS << " para salvar." << endl;
-        return;  // Falha silenciosa
+// Retira a reserva da tabela sob a trava da partição
+ReservaEstoque Estoque::retirarReserva(int idReserva) {
+    ParticaoReservas& particao = particaoReserva(idReserva);
+    lock_guard<mutex> trava(particao.trava);
+    unordered_map<int, ReservaEstoque>::iterator it = particao.reservas.find(idReserva);
+    if (it == particao.reservas.end()) {
+        throw EstoqueException("Reserva " + to_string(idReserva) + " nao encontrada.");
+    }
+    ReservaEstoque reserva = it->second;
+    particao.reservas.erase(it);
+    return reserva;
+}
+
+// Confirma uma reserva: quantidade sai do estoque e vira movimento SAIDA
+// mutexEstado: o movimento entra no histórico e a queda de quantidade
+// chega aos alertas, como em registrarSaida
+// Lança: EstoqueException se a reserva não existe
+void Estoque::confirmarReserva(int idReserva) {
+    ESTOQUE_MEDIR(metricas, OP_CONFIRMAR_RESERVA);
+    ReservaEstoque reserva = retirarReserva(idReserva);
+    lock_guard<mutex> trava(mutexEstado);
+
+    Item* item = reserva.item;  // Fixado pela reserva: ainda existe
+    item->confirmarReservaQtd(reserva.quantidade);
+
+    MovimentoEstoque* mov = new MovimentoEstoque(SAIDA, reserva.quantidade, item->getId(), item->getNome());
+    anexarMovimento(mov);
+
+    // Desfazível como uma SAIDA comum: as unidades voltam ao disponível
+    // (a reserva não é recriada)
+    OperacaoDesfazivel operacao;
+    operacao.tipo = DESFAZ_SAIDA;
+    operacao.idItem = item->getId();
+    operacao.quantidade = reserva.quantidade;
+    operacao.item = nullptr;
+    logDesfazer.registrar(std::move(operacao));
+    ++versao;
+}
+
+// Libera uma reserva: quantidade volta a ficar disponível (sem movimento)
+// Só o CAS no Item fixado pela reserva: sem mutexEstado
+// Lança: EstoqueException se a reserva não existe
+void Estoque::liberarReserva(int idReserva) {
+    ESTOQUE_MEDIR(metricas, OP_LIBERAR_RESERVA);
+    ReservaEstoque reserva = retirarReserva(idReserva);
+    reserva.item->liberarReservaQtd(reserva.quantidade);
+}
+
+// Libera em lote as reservas mais antigas que idadeMaxima
+// Retorna: quantas reservas foram liberadas
+// Lança: EstoqueException se idadeMaxima < 0 (liberaria reservas ainda por vir)
+std::size_t Estoque::expirarReservas(std::chrono::steady_clock::duration idadeMaxima) {
+    ESTOQUE_MEDIR(metricas, OP_EXPIRAR_RESERVAS);
+    if (idadeMaxima < std::chrono::steady_clock::duration::zero()) {
+        throw EstoqueException("Idade maxima das reservas nao pode ser negativa.");
+    }
+    std::chrono::steady_clock::time_point limite = std::chrono::steady_clock::now() - idadeMaxima;
+
+    // 1. Retira as expiradas de cada partição (uma trava de partição por vez)
+    vector<ReservaEstoque> expiradas;
+    for (std::size_t p = 0; p < NUM_PARTICOES_RESERVAS; ++p) {
+        ParticaoReservas& particao = particoesReservas[p];
+        lock_guard<mutex> trava(particao.trava);
+        unordered_map<int, ReservaEstoque>::iterator it = particao.reservas.begin();
+        while (it != particao.reservas.end()) {
+            if (it->second.criadaEm <= limite) {
+                expiradas.push_back(it->second);
+                it = particao.reservas.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (expiradas.empty()) {
+        return 0;
     }
 
-    // Itera por todos os movimentos
-    for (std::size_t i = 0; i < historico.tamanho(); ++i) {
-        MovimentoEstoque* mov = historico.get(i);  // Obtém ponteiro do movimento
-        
-        // Escreve em formato: ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
-        arqMov << mov->getId() << ";"
-               << mov->getData() << ";"
-               << (mov->getTipo() == ENTRADA ? "ENTRADA" : "SAIDA") << ";"  // Converte enum para string
-               << mov->getQuantidade() << ";"
-               << mov->getIdItem() << ";"
-               << mov->getNomeItem() << "\n";
+    // 2. Devolve os saldos nos Itens fixados pelas reservas (CAS, sem mutexEstado)
+    for (std::size_t i = 0; i < expiradas.size(); ++i) {
+        expiradas[i].item->liberarReservaQtd(expiradas[i].quantidade);
     }
-    arqMov.close();  // Fecha arquivo
-    
-    cout << "Dados salvos com sucesso." << endl;
+    return expiradas.size();
 }
 
-// Carrega todos os dados (items e movimentos) dos arquivos de texto
-// Chamado no construtor ao iniciar a aplicação
-// 
-// Processo Items:
-// 1. Abre itens.txt
-// 2. Para cada linha: parse TYPE;ID;NAME;DESC;QTY;LINK;DETAIL
-// 3. Se TYPE=="PRODUTO": cria new ItemProduto(...) com detail como categoria
-// 4. Se TYPE=="MATERIA": cria new ItemMateria(...) com detail como fornecedor
-// 5. Adiciona à lista items
-// 6. Atualiza Item::proximoId para continuar IDs únicos
-// 
-// Processo Movimentos:
-// 1. Abre movimentos.txt
-// 2. Para cada linha: parse ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
-// 3. Converte TIPO ("ENTRADA"/"SAIDA") para enum TipoMovimento
-// 4. Cria new MovimentoEstoque(...) com construtor de carregamento
-// 5. Adiciona à lista historico
-// 6. Atualiza MovimentoEstoque::proximoId para continuar IDs únicos
-// 
-// Tratamento de erro:
-// - Se arquivo não existe: aviso e continua (primeira execução)
-// - Se linha corrompida: aviso e pula linha
-void Estoque::carregarDados() {
-    // === Carregar Items ===
-    ifstream arqItens(ARQUIVO_ITENS);  // Abre arquivo para leitura
-    if (!arqItens.is_open()) {  // Se não consegue abrir
-        cout << "Aviso: Arquivo " << ARQUIVO_ITENS << " nao encontrado. Comecando com estoque vazio." << endl;
-    } else {
-        string linha, tipo, idStr, nome, desc, qtdStr, link, detalhe;
-        int id, qtd;
-        int maxId = 0;  // Rastreia maior ID encontrado
+// Número de reservas ativas (soma das partições)
+std::size_t Estoque::reservasAtivas() const {
+    std::size_t total = 0;
+    for (std::size_t p = 0; p < NUM_PARTICOES_RESERVAS; ++p) {
+        lock_guard<mutex> trava(particoesReservas[p].trava);
+        total += particoesReservas[p].reservas.size();
+    }
+    return total;
+}
 
-        // Lê arquivo linha por linha
-        while (getline(arqItens, linha)) {
-            stringstream ss(linha);  // String stream para parsing
-            
-            // Parse: separa campos por semicolon (;)
-            getline(ss, tipo, ';');      // PRODUTO ou MATERIA
-            getline(ss, idStr, ';');     // ID em string
-            getline(ss, nome, ';');      // Nome
-            getline(ss, desc, ';');      // Descrição
-            getline(ss, qtdStr, ';');    // Quantidade em string
-            getline(ss, link, ';');      // Link
-            getline(ss, detalhe, ';');   // Categoria ou Fornecedor
+// === ALERTAS DE ESTOQUE BAIXO ===
 
-            try {
-                id = stoi(idStr);        // Converte string para int
-                qtd = stoi(qtdStr);      // Converte string para int
-                if (id > maxId) maxId = id;  // Rastreia maior ID
-
-                // Cria item apropriado baseado em tipo
-                Item* novoItem = nullptr;
-                if (tipo == "PRODUTO") {
-                    // Cria ItemProduto com categoria como detalhe
-                    novoItem = new ItemProduto(nome, desc, qtd, link, detalhe);
-                } else if (tipo == "MATERIA") {
-                    // Cria ItemMateria com fornecedor como detalhe
-                    novoItem = new ItemMateria(nome, desc, qtd, link, detalhe);
-                }
+// Define o mínimo do item; Item::setMinimo notifica os alertas se a situação mudar
+// Lança: EstoqueException se ID inválido ou minimo < 0
+void Estoque::definirMinimo(int idItem, int minimo) {
+    lock_guard<mutex> trava(mutexEstado);
+    Item* item = localizarItemPorId(idItem);
+    if (item == nullptr) {
+        throw EstoqueException("Item com ID " + to_string(idItem) + " nao encontrado.");
+    }
+    int anterior = item->getMinimo();
+    item->setMinimo(minimo);
 
-                // Se conseguiu criar item, adiciona ao estoque
-                if (novoItem) {
-                    // Nota: O construtor incrementa proximoId automaticamente
-                    // Isso é simplificação de projeto estudantil.
-                    // Design melhor usaria construtor privado ou friend class.
-                    this->adicionarItem(novoItem);
-                }
-            } catch (const exception& e) {
-                cerr << "Erro ao ler linha do arquivo de itens: " << e.what() << endl;
-                // Continua com próxima linha (ignora erro)
+    OperacaoDesfazivel operacao;
+    operacao.tipo = DESFAZ_DEFINIR_MINIMO;
+    operacao.idItem = idItem;
+    operacao.quantidade = anterior;
+    operacao.item = nullptr;
+    logDesfazer.registrar(std::move(operacao));
+    ++versao;
+}
+
+// Itens baixos a partir do índice de alertas (O(k))
+vector<Item*> Estoque::listarEstoqueBaixo() {
+    lock_guard<mutex> trava(mutexEstado);
+    vector<int> ids = alertas.idsAbaixoDoMinimo();
+    vector<Item*> baixos;
+    baixos.reserve(ids.size());
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        baixos.push_back(localizarItemPorId(ids[i]));
+    }
+    return baixos;
+}
+
+// Callbacks são chamados dentro das operações, com a trava segurada
+void Estoque::adicionarAlertaEstoqueBaixo(const CallbackEstoqueBaixo& callback) {
+    lock_guard<mutex> trava(mutexEstado);
+    alertas.adicionarCallback(callback);
+}
+
+// === CATEGORIAS E FORNECEDORES ===
+
+// Consulta o índice do tipo e resolve os IDs (já em ordem crescente)
+vector<Item*> Estoque::listarPorDetalhe(TipoItem tipo, const string& valor) {
+    lock_guard<mutex> trava(mutexEstado);
+    vector<int> ids = indicesDetalhe[tipo].consultar(valor);
+    vector<Item*> encontrados;
+    encontrados.reserve(ids.size());
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        encontrados.push_back(localizarItemPorId(ids[i]));
+    }
+    return encontrados;
+}
+
+vector<GrupoItens> Estoque::agruparPorDetalhe(TipoItem tipo) {
+    lock_guard<mutex> trava(mutexEstado);
+    vector<std::pair<string, vector<int> > > grupos = indicesDetalhe[tipo].grupos();
+    vector<GrupoItens> resultado(grupos.size());
+    for (std::size_t g = 0; g < grupos.size(); ++g) {
+        resultado[g].nome = grupos[g].first;
+        resultado[g].itens.reserve(grupos[g].second.size());
+        for (std::size_t i = 0; i < grupos[g].second.size(); ++i) {
+            resultado[g].itens.push_back(localizarItemPorId(grupos[g].second[i]));
+        }
+    }
+    return resultado;
+}
+
+vector<Item*> Estoque::listarPorCategoria(const string& categoria) {
+    return listarPorDetalhe(TIPO_PRODUTO, categoria);
+}
+
+vector<Item*> Estoque::listarPorFornecedor(const string& fornecedor) {
+    return listarPorDetalhe(TIPO_MATERIA, fornecedor);
+}
+
+vector<GrupoItens> Estoque::agruparPorCategoria() {
+    return agruparPorDetalhe(TIPO_PRODUTO);
+}
+
+vector<GrupoItens> Estoque::agruparPorFornecedor() {
+    return agruparPorDetalhe(TIPO_MATERIA);
+}
+
+// === TRANSAÇÕES ===
+
+// Ver processo em Estoque.h: valida tudo, depois aplica (tudo ou nada)
+void Estoque::executarTransacao(const TransacaoEstoque& transacao) {
+    ESTOQUE_MEDIR(metricas, OP_EXECUTAR_TRANSACAO);
+    const vector<LinhaTransacao>& linhas = transacao.getLinhas();
+    if (linhas.empty()) {
+        return;
+    }
+    lock_guard<mutex> trava(mutexEstado);
+    aplicarTransacao(linhas, false);
+
+    // Um registro para a transação inteira: desfazer inverte o kit todo
+    OperacaoDesfazivel operacao;
+    operacao.tipo = DESFAZ_TRANSACAO;
+    operacao.idItem = linhas[0].idItem;
+    operacao.quantidade = static_cast<int>(linhas.size());
+    operacao.item = nullptr;
+    operacao.linhas = linhas;
+    logDesfazer.registrar(std::move(operacao));
+    ++versao;
+}
+
+// inverter: cada ENTRADA vira SAIDA e vice-versa (desfazer a transação)
+void Estoque::aplicarTransacao(const vector<LinhaTransacao>& linhas, bool inverter) {
+    // 1. Totais por item, na ordem da primeira aparição
+    struct TotaisItem {
+        Item* item;
+        long long entradas;
+        long long saidas;
+    };
+    vector<TotaisItem> totais;
+    unordered_map<int, std::size_t> posicaoPorId;
+    vector<std::size_t> posicaoDaLinha(linhas.size());
+    for (std::size_t i = 0; i < linhas.size(); ++i) {
+        const LinhaTransacao& linha = linhas[i];
+        unordered_map<int, std::size_t>::iterator it = posicaoPorId.find(linha.idItem);
+        if (it == posicaoPorId.end()) {
+            Item* item = localizarItemPorId(linha.idItem);
+            if (item == nullptr) {
+                throw EstoqueException("Item com ID " + to_string(linha.idItem) + " nao encontrado.");
             }
+            TotaisItem novo = { item, 0, 0 };
+            it = posicaoPorId.insert(std::make_pair(linha.idItem, totais.size())).first;
+            totais.push_back(novo);
         }
-        // Atualiza ID estático para evitar duplicação quando criar novo item
-        Item::setProximoId(maxId + 1);
-        arqItens.close();
+        TotaisItem& t = totais[it->second];
+        ((linha.tipo == ENTRADA) != inverter ? t.entradas : t.saidas) += linha.quantidade;
+        posicaoDaLinha[i] = it->second;
     }
 
-    // === Carregar Movimentos ===
-    ifstream arqMov(ARQUIVO_MOVIMENTOS);  // Abre arquivo para leitura
-    if (!arqMov.is_open()) {  // Se não consegue abrir
-        cout << "Aviso: Arquivo " << ARQUIVO_MOVIMENTOS << " nao encontrado. Comecando com historico vazio." << endl;
-    } else {
-        string linha, idStr, data, tipoStr, qtdStr, idItemStr, nomeItem;
-        int id, qtd, idItem;
-        int maxIdMov = 0;  // Rastreia maior ID encontrado
+    // 2. Validação conjunta (nada foi alterado até aqui)
+    // Partições de IDs dos itens travadas (ordem crescente) até o fim da
+    // aplicação: reservar() não consome o disponível já validado
+    std::unique_lock<mutex> travasIds[NUM_PARTICOES_IDS];
+    bool envolvida[NUM_PARTICOES_IDS] = {};
+    for (std::size_t i = 0; i < totais.size(); ++i) {
+        envolvida[static_cast<unsigned>(totais[i].item->getId()) % NUM_PARTICOES_IDS] = true;
+    }
+    for (std::size_t p = 0; p < NUM_PARTICOES_IDS; ++p) {
+        if (envolvida[p]) {
+            travasIds[p] = std::unique_lock<mutex>(particoesIds[p].trava);
+        }
+    }
+    for (std::size_t i = 0; i < totais.size(); ++i) {
+        const TotaisItem& t = totais[i];
+        long long disponivel = t.item->getDisponivel();
+        if (disponivel + t.entradas < t.saidas) {
+            throw EstoqueException("Estoque insuficiente para o item " + to_string(t.item->getId()) +
+                                   " na transacao: disponivel " + to_string(disponivel) +
+                                   ", necessario " + to_string(t.saidas - t.entradas) + ".");
+        }
+        if (t.item->getQuantidade() + t.entradas > std::numeric_limits<int>::max() ||
+            t.saidas > std::numeric_limits<int>::max()) {
+            throw EstoqueException("Quantidade do item " + to_string(t.item->getId()) +
+                                   " excede o limite na transacao.");
+        }
+    }
 
-        // Lê arquivo linha por linha
-        while (getline(arqMov, linha)) {
-            stringstream ss(linha);  // String stream para parsing
-            
-            // Parse: separa campos por semicolon (;)
-            getline(ss, idStr, ';');       // ID em string
-            getline(ss, data, ';');        // Data/hora "YYYY-MM-DD HH:MM:SS"
-            getline(ss, tipoStr, ';');     // ENTRADA ou SAIDA
-            getline(ss, qtdStr, ';');      // Quantidade em string
-            getline(ss, idItemStr, ';');   // ID do item em string
-            getline(ss, nomeItem, ';');    // Nome do item
+    // 3. Aplicação: entradas antes das saídas (as saídas podem depender delas)
+    for (std::size_t i = 0; i < totais.size(); ++i) {
+        if (totais[i].entradas > 0) {
+            totais[i].item->adicionarQtd(static_cast<int>(totais[i].entradas));
+        }
+        if (totais[i].saidas > 0) {
+            totais[i].item->removerQtd(static_cast<int>(totais[i].saidas));
+        }
+    }
+    for (std::size_t p = 0; p < NUM_PARTICOES_IDS; ++p) {
+        if (travasIds[p].owns_lock()) {
+            travasIds[p].unlock();
+        }
+    }
 
-            try {
-                id = stoi(idStr);          // Converte string para int
-                qtd = stoi(qtdStr);        // Converte string para int
-                idItem = stoi(idItemStr);  // Converte string para int
-                if (id > maxIdMov) maxIdMov = id;  // Rastreia maior ID
-
-                // Converte string "ENTRADA" ou "SAIDA" para enum TipoMovimento
-                TipoMovimento tipo = (tipoStr == "ENTRADA" ? ENTRADA : SAIDA);
-                
-                // Cria novo movimento usando construtor de carregamento
-                // (não incrementa proximoId - já tem ID do arquivo)
-                MovimentoEstoque* mov = new MovimentoEstoque(id, data, tipo, qtd, idItem, nomeItem);
-                historico.adicionar(mov);
-
-            } catch (const exception& e) {
-                cerr << "Erro ao ler linha do arquivo de movimentos: " << e.what() << endl;
-                // Continua com próxima linha (ignora erro)
+    // 4. Histórico: um movimento por linha
+    for (std::size_t i = 0; i < linhas.size(); ++i) {
+        const Item* item = totais[posicaoDaLinha[i]].item;
+        TipoMovimento tipo = (linhas[i].tipo == ENTRADA) != inverter ? ENTRADA : SAIDA;
+        anexarMovimento(new MovimentoEstoque(tipo, linhas[i].quantidade, item->getId(), item->getNome()));
+    }
+}
+
+// === DESFAZER / REFAZER ===
+
+// Cada tipo é a sua própria inversa com os papéis trocados:
+// desfazer ADICIONAR = refazer REMOVER, desfazer ENTRADA = refazer SAIDA, etc.
+// EDITAR e DEFINIR_MINIMO trocam o valor atual pelo guardado no registro
+void Estoque::aplicarDesfazivel(OperacaoDesfazivel& operacao, bool desfazendo) {
+    switch (operacao.tipo) {
+        case DESFAZ_ADICIONAR_ITEM:
+        case DESFAZ_REMOVER_ITEM: {
+            bool reinserir = (operacao.tipo == DESFAZ_REMOVER_ITEM) == desfazendo;
+            if (reinserir) {
+                inserirItem(operacao.item);
+            } else {
+                retirarItem(operacao.idItem);  // Mesmo objeto de operacao.item
+            }
+            break;
+        }
+        case DESFAZ_ENTRADA:
+        case DESFAZ_SAIDA: {
+            Item* item = localizarItemPorId(operacao.idItem);
+            if (item == nullptr) {
+                throw EstoqueException("Item com ID " + to_string(operacao.idItem) + " nao encontrado.");
             }
+            bool entrada = (operacao.tipo == DESFAZ_ENTRADA) != desfazendo;
+            if (entrada) {
+                item->adicionarQtd(operacao.quantidade);
+            } else {
+                item->removerQtd(operacao.quantidade);  // Lança se o saldo já foi consumido
+            }
+            anexarMovimento(new MovimentoEstoque(entrada ? ENTRADA : SAIDA, operacao.quantidade,
+                                                 item->getId(), item->getNome()));
+            break;
+        }
+        case DESFAZ_EDITAR_ITEM: {
+            Item* item = localizarItemPorId(operacao.idItem);
+            if (item == nullptr) {
+                throw EstoqueException("Item com ID " + to_string(operacao.idItem) + " nao encontrado.");
+            }
+            string nome = item->getNome();
+            string descricao = item->getDescricao();
+            string link = item->getLink();
+            item->atualizarDados(operacao.nome, operacao.descricao, operacao.link);
+            operacao.nome.swap(nome);
+            operacao.descricao.swap(descricao);
+            operacao.link.swap(link);
+            break;
+        }
+        case DESFAZ_DEFINIR_MINIMO: {
+            Item* item = localizarItemPorId(operacao.idItem);
+            if (item == nullptr) {
+                throw EstoqueException("Item com ID " + to_string(operacao.idItem) + " nao encontrado.");
+            }
+            int atual = item->getMinimo();
+            item->setMinimo(operacao.quantidade);
+            operacao.quantidade = atual;
+            break;
         }
-        // Atualiza ID estático para evitar duplicação quando criar novo movimento
-        MovimentoEstoque::setProximoId(maxIdMov + 1);
-        arqMov.close();
+        case DESFAZ_TRANSACAO:
+            aplicarTransacao(operacao.linhas, desfazendo);  // Valida todas as linhas antes de aplicar
+            break;
+    }
+}
+
+bool Estoque::desfazer() {
+    lock_guard<mutex> trava(mutexEstado);
+    if (logDesfazer.numeroDesfaziveis() == 0) {
+        return false;
     }
+    aplicarDesfazivel(logDesfazer.proximaDesfazer(), true);
+    logDesfazer.confirmarDesfazer();  // Só depois de aplicar: exceção mantém o log como estava
+    ++versao;
+    return true;
+}
+
+bool Estoque::refazer() {
+    lock_guard<mutex> trava(mutexEstado);
+    if (logDesfazer.numeroRefaziveis() == 0) {
+        return false;
+    }
+    aplicarDesfazivel(logDesfazer.proximaRefazer(), false);
+    logDesfazer.confirmarRefazer();
+    ++versao;
+    return true;
+}
+
+// Texto curto de uma operação do log (menu)
+static string descreverOperacao(const OperacaoDesfazivel& operacao) {
+    string item = "item " + to_string(operacao.idItem);
+    switch (operacao.tipo) {
+        case DESFAZ_ADICIONAR_ITEM: return "cadastro do " + item;
+        case DESFAZ_REMOVER_ITEM:   return "remocao do " + item;
+        case DESFAZ_EDITAR_ITEM:    return "edicao do " + item;
+        case DESFAZ_ENTRADA:        return "ENTRADA de " + to_string(operacao.quantidade) + " do " + item;
+        case DESFAZ_SAIDA:          return "SAIDA de " + to_string(operacao.quantidade) + " do " + item;
+        case DESFAZ_DEFINIR_MINIMO: return "estoque minimo do " + item;
+        case DESFAZ_TRANSACAO:      return "transacao com " + to_string(operacao.quantidade) + " linha(s)";
+    }
+    return "";
+}
+
+string Estoque::descreverProximoDesfazer() {
+    lock_guard<mutex> trava(mutexEstado);
+    return logDesfazer.numeroDesfaziveis() ? descreverOperacao(logDesfazer.proximaDesfazer()) : string();
+}
+
+string Estoque::descreverProximoRefazer() {
+    lock_guard<mutex> trava(mutexEstado);
+    return logDesfazer.numeroRefaziveis() ? descreverOperacao(logDesfazer.proximaRefazer()) : string();
+}
+
+// === RANKINGS (TOP-K) ===
+
+// Anexa ao histórico e acumula o total de SAIDA do item
+void Estoque::anexarMovimento(MovimentoEstoque* mov) {
+    historico.adicionar(std::unique_ptr<MovimentoEstoque>(mov));  // O histórico passa a ser dono
+    colunaQtdMovimentos.push_back(mov->getQuantidade());
+    colunaTipoMovimentos.push_back(static_cast<std::uint8_t>(mov->getTipo()));
+    if (mov->getTipo() == SAIDA) {
+        totalSaidasPorItem[mov->getIdItem()] += mov->getQuantidade();
+    }
+}
+
+// Par (valor, ID) usado na seleção: contíguo e barato de mover
+typedef std::pair<long long, int> ValorId;
+
+// Seleciona os k primeiros de 'candidatos' com partial_sort e resolve os IDs
+// maiores = true: valor decrescente; false: crescente. Empate: menor ID primeiro
+// localizar: ID -> Item* (Estoque::localizarItemPorId); chamadora deve segurar mutexEstado
+template <typename Localizar>
+static vector<PosicaoRanking> selecionarTopK(vector<ValorId>& candidatos, std::size_t k, bool maiores,
+                                            Localizar localizar) {
+    std::size_t n = candidatos.size() < k ? candidatos.size() : k;
+    if (maiores) {
+        std::partial_sort(candidatos.begin(), candidatos.begin() + n, candidatos.end(),
+                          [](const ValorId& a, const ValorId& b) {
+                              return a.first != b.first ? a.first > b.first : a.second < b.second;
+                          });
+    } else {
+        std::partial_sort(candidatos.begin(), candidatos.begin() + n, candidatos.end());
+    }
+    vector<PosicaoRanking> ranking(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ranking[i].item = localizar(candidatos[i].second);
+        ranking[i].valor = candidatos[i].first;
+    }
+    return ranking;
+}
+
+vector<PosicaoRanking> Estoque::maioresQuantidades(std::size_t k) {
+    lock_guard<mutex> trava(mutexEstado);
+    vector<ValorId> candidatos(itens.tamanho());
+    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
+        candidatos[i] = ValorId(itens[i]->getQuantidade(), itens[i]->getId());
+    }
+    return selecionarTopK(candidatos, k, true, [this](int id) { return localizarItemPorId(id); });
+}
+
+vector<PosicaoRanking> Estoque::menoresQuantidades(std::size_t k) {
+    lock_guard<mutex> trava(mutexEstado);
+    vector<ValorId> candidatos(itens.tamanho());
+    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
+        candidatos[i] = ValorId(itens[i]->getQuantidade(), itens[i]->getId());
+    }
+    return selecionarTopK(candidatos, k, false, [this](int id) { return localizarItemPorId(id); });
+}
+
+// Data de 'dias' dias atrás no formato dos movimentos ("YYYY-MM-DD HH:MM:SS")
+// Datas nesse formato comparam em ordem cronológica como texto
+static string dataDiasAtras(int dias) {
+    std::time_t limite = std::time(nullptr) - static_cast<std::time_t>(dias) * 24 * 60 * 60;
+    char buffer[20];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&limite));
+    return string(buffer);
+}
+
+// Soma às 'somas' as SAIDAs do arquivo morto com data >= inicioJanela e
+// ID <= ultimoId (linhas de uma compactação ainda não publicada ficam de fora:
+// continuam no histórico em memória). Arquivo em ordem de ID e de data
+// Lança: EstoqueException se o arquivo não puder ser aberto
+static void somarSaidasArquivadas(const string& caminho, const string& inicioJanela, int ultimoId,
+                                  unordered_map<int, long long>& somas) {
+    ifstream arquivo(caminho);
+    if (!arquivo.is_open()) {
+        throw EstoqueException("Nao foi possivel abrir " + caminho + ": a janela comeca antes da ultima compactacao.");
+    }
+    LeitorRegistros leitor(arquivo);
+    while (leitor.proximo() && leitor.terminaEmQuebra()) {  // Linha incompleta: acréscimo interrompido
+        try {
+            if (leitor.campoInteiro(0) > ultimoId) {
+                break;
+            }
+            if (inicioJanela.compare(0, string::npos, leitor.inicioCampo(1), leitor.tamanhoCampo(1)) > 0) {
+                continue;  // Anterior à janela
+            }
+            if (leitor.campoIgual(2, "SAIDA")) {
+                somas[leitor.campoInteiro(4)] += leitor.campoInteiro(3);
+            }
+        } catch (const exception& e) {
+            cerr << "Erro ao ler linha de " << caminho << ": " << e.what() << endl;
+        }
+    }
+}
+
+vector<PosicaoRanking> Estoque::maioresSaidas(std::size_t k, int dias) {
+    if (dias < 0) {
+        throw EstoqueException("Numero de dias nao pode ser negativo.");
+    }
+    unordered_map<int, long long> somas;
+    string inicioJanela;
+    int ultimoArquivado = 0;
+    {
+        lock_guard<mutex> trava(mutexEstado);
+        carregarHistorico();  // Totais e janela dependem do histórico gravado
+        if (dias == 0) {
+            return rankingSaidas(totalSaidasPorItem, k);  // Todo o período: totais incrementais
+        }
+        inicioJanela = dataDiasAtras(dias);
+        for (std::size_t i = historico.tamanho(); i > 0; --i) {
+            const MovimentoEstoque* mov = historico[i - 1].get();
+            if (mov->getData() < inicioJanela) {
+                break;  // Daqui para trás tudo é mais antigo
+            }
+            if (mov->getTipo() == SAIDA) {
+                somas[mov->getIdItem()] += mov->getQuantidade();
+            }
+        }
+        // Arquivados têm data <= corte (compactação com 0 dias: o próprio corte)
+        if (dataCorteArquivada.empty() || inicioJanela > dataCorteArquivada) {
+            return rankingSaidas(somas, k);
+        }
+        ultimoArquivado = ultimoMovimentoArquivado;
+    }
+
+    // Janela começa antes da última compactação: o trecho arquivado vem de
+    // movimentos_arquivo.txt, lido fora de mutexEstado
+    somarSaidasArquivadas(ARQUIVO_MOVIMENTOS_ARQUIVADOS, inicioJanela, ultimoArquivado, somas);
+    lock_guard<mutex> trava(mutexEstado);
+    return rankingSaidas(somas, k);
+}
+
+// Ranking por unidades de SAIDA, só com itens ainda no catálogo
+// Chamadora deve segurar mutexEstado
+vector<PosicaoRanking> Estoque::rankingSaidas(const unordered_map<int, long long>& somas, std::size_t k) const {
+    vector<ValorId> candidatos;
+    candidatos.reserve(somas.size());
+    unordered_map<int, long long>::const_iterator it;
+    for (it = somas.begin(); it != somas.end(); ++it) {
+        if (localizarItemPorId(it->first) != nullptr) {
+            candidatos.push_back(ValorId(it->second, it->first));
+        }
+    }
+    return selecionarTopK(candidatos, k, true, [this](int id) { return localizarItemPorId(id); });
+}
+
+// === AGREGADOS (SIMD) ===
+
+// Cópia O(n) das quantidades; consultas seguidas sem alteração reaproveitam a coluna
+void Estoque::atualizarColunaQuantidades() {
+    if (colunaQuantidadesValida && versaoColunaQuantidades == versao &&
+        colunaQuantidades.size() == itens.tamanho()) {
+        return;
+    }
+    colunaQuantidades.resize(itens.tamanho());
+    for (std::size_t i = 0; i < itens.tamanho(); ++i) {
+        colunaQuantidades[i] = itens[i]->getQuantidade();
+    }
+    versaoColunaQuantidades = versao;
+    colunaQuantidadesValida = true;
+}
+
+AgregadosQuantidade Estoque::agregarQuantidades(int limite) {
+    lock_guard<mutex> trava(mutexEstado);
+    atualizarColunaQuantidades();
+    return agregarColuna(colunaQuantidades.data(), colunaQuantidades.size(), limite);
+}
+
+vector<std::size_t> Estoque::contarPorFaixaDeQuantidade(const vector<int>& limites) {
+    if (limites.empty() || limites.size() > MAX_LIMITES_FAIXAS) {
+        throw EstoqueException("Informe de 1 a " + to_string(MAX_LIMITES_FAIXAS) + " limites de faixa.");
+    }
+    for (std::size_t i = 1; i < limites.size(); ++i) {
+        if (limites[i] <= limites[i - 1]) {
+            throw EstoqueException("Limites de faixa devem estar em ordem crescente.");
+        }
+    }
+    lock_guard<mutex> trava(mutexEstado);
+    atualizarColunaQuantidades();
+    vector<std::size_t> contagens(limites.size() + 1);
+    contarPorFaixa(colunaQuantidades.data(), colunaQuantidades.size(),
+                   limites.data(), limites.size(), contagens.data());
+    return contagens;
+}
+
+TotaisMovimentos Estoque::totalizarMovimentos() {
+    lock_guard<mutex> trava(mutexEstado);
+    carregarHistorico();
+    return totalizarPorTipo(colunaQtdMovimentos.data(), colunaTipoMovimentos.data(),
+                            colunaQtdMovimentos.size());
+}
+
+// === EVENTOS DOS ITENS (IObservadorItem) ===
+
+// Quantidade cruzou o mínimo: atualiza o índice de itens baixos e dispara callbacks
+void Estoque::minimoCruzado(const Item& item, bool abaixo) {
+    alertas.minimoCruzado(item, abaixo);
+}
+
+// Nome/descrição/link mudaram: reindexa apenas os textos que mudaram
+void Estoque::dadosAlterados(const Item& item, const string& nomeAnterior, const string& descricaoAnterior) {
+    if (item.getNome() != nomeAnterior) {
+        indiceNomes.atualizar(item.getId(), item.getNome());
+    }
+    if (item.getDescricao() != descricaoAnterior) {
+        indiceDescricoes.remover(item.getId(), descricaoAnterior);
+        indiceDescricoes.adicionar(item.getId(), item.getDescricao());
+    }
+}
+
+// === PERSISTÊNCIA ===
+
+// Escreve um movimento no formato: ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
+// (movimentos.txt e movimentos_arquivo.txt)
+// Saida: std::ostream ou SaidaDescritor (filho do salvamento em segundo plano)
+template <typename Saida>
+static void gravarMovimento(Saida& saida, const MovimentoEstoque* mov) {
+    saida << mov->getId() << ";"
+          << mov->getData() << ";"
+          << (mov->getTipo() == ENTRADA ? "ENTRADA" : "SAIDA") << ";"  // Converte enum para string
+          << mov->getQuantidade() << ";"
+          << mov->getIdItem() << ";"
+          << mov->getNomeItem() << "\n";
+}
+
+// Escreve um item no formato: TYPE;ID;NAME;DESC;QTY;LINK;DETAIL[;MIN]
+// (itens.txt e entradas ITEM do diário)
+// 
+// Despacho por etiqueta (sem chamadas virtuais por item):
+// - nomeTipoItem() retorna a tag do tipo registrada (ex: "PRODUTO"; constante)
+// - detalhe: categoria ou fornecedor, capturado no snapshot
+// Saida: std::ostream ou SaidaDescritor (filho do salvamento em segundo plano)
+template <typename Saida>
+static void gravarItem(Saida& saida, const EstadoItem& item) {
+    saida << nomeTipoItem(item.tipo) << ";"  // PRODUTO ou MATERIA (constante, sem alocação)
+          << item.id << ";"
+          << item.nome << ";"
+          << item.descricao << ";"
+          << item.quantidade << ";"
+          << item.link << ";"
+          << item.detalhe;           // categoria ou fornecedor
+    if (item.minimo > 0) {
+        saida << ";" << item.minimo;  // Campo opcional: arquivos antigos continuam válidos
+    }
+    saida << "\n";
+}
+
+// Salva todos os dados (items e movimentos) em arquivos de texto
+// 
+// Processo:
+// 1. Acrescenta ao diário (diario_itens.txt) os itens alterados e removidos
+//    desde a última gravação; diário grande gera checkpoint (itens.txt + estoque.ckp)
+// 2. Acrescenta a movimentos.txt os movimentos ainda não gravados, em formato:
+//    ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
+//    (regrava o arquivo inteiro só depois de compactarHistorico)
+// 
+// Histórico em ordem crescente de ID: os não gravados são o sufixo com
+// ID > ultimoMovimentoGravado. Funciona com o histórico ainda não carregado
+// (o sufixo são os movimentos desta execução)
+// 
+// Itens capturados no snapshot: a gravação não segura a trava durante o I/O
+// 
+// const: método apenas lê dados, não modifica
+void Estoque::salvarDados() const {
+    ESTOQUE_MEDIR(metricas, OP_SALVAR_DADOS);
+    lock_guard<mutex> gravacao(mutexGravacao);  // Uma gravação por vez (acréscimo)
+    coletarSalvamentoTravado(true);  // Salvamento em segundo plano grava os mesmos arquivos
+
+    // Versão consistente de itens e histórico para gravar
+    shared_ptr<const SnapshotEstoque> snapshot;
+    bool regravar;
+    {
+        lock_guard<mutex> trava(mutexEstado);
+        snapshot = montarSnapshot();
+        regravar = regravarMovimentos;
+    }
+    const vector<shared_ptr<const EstadoItem> >& estados = snapshot->getItens();
+
+    // === Salvar Items (diário) ===
+    // Versão diferente da gravada = item alterado; gravado e ausente = removido
+    unordered_map<int, unsigned long> versoes;
+    versoes.reserve(estados.size());
+    std::ostringstream entradas;
+    unsigned long long seq = seqDiario;
+    for (std::size_t i = 0; i < estados.size(); ++i) {
+        const EstadoItem& item = *estados[i];
+        versoes[item.id] = item.versao;
+        unordered_map<int, unsigned long>::const_iterator gravada = versoesGravadas.find(item.id);
+        if (gravada == versoesGravadas.end() || gravada->second != item.versao) {
+            entradas << ++seq << ";ITEM;";
+            gravarItem(entradas, item);
+        }
+    }
+    unordered_map<int, unsigned long>::const_iterator it;
+    for (it = versoesGravadas.begin(); it != versoesGravadas.end(); ++it) {
+        if (!versoes.count(it->first)) {
+            entradas << ++seq << ";REMOVER;" << it->first << "\n";
+        }
+    }
+
+    if (seq > seqDiario) {
+        ofstream arqDiario(ARQUIVO_DIARIO, std::ios::app);  // Somente acréscimo
+        if (!arqDiario.is_open()) {  // Verifica se abriu corretamente
+            cerr << "Erro: Nao foi possivel abrir o arquivo " << ARQUIVO_DIARIO << " para salvar." << endl;
+            return;  // Falha silenciosa (não interrompe programa)
+        }
+        if (faltaQuebraDiario) {
+            arqDiario << "\n";  // Última entrada de uma execução interrompida
+        }
+        arqDiario << entradas.str();
+        arqDiario.close();
+        if (arqDiario.fail()) {
+            cerr << "Erro: Falha ao gravar o arquivo " << ARQUIVO_DIARIO << "." << endl;
+            return;
+        }
+        faltaQuebraDiario = false;
+        entradasDiario += static_cast<std::size_t>(seq - seqDiario);
+        seqDiario = seq;
+        checkpointEmDia = false;
+    }
+    versoesGravadas.swap(versoes);
+
+    // Diário do tamanho do catálogo: reaplicá-lo já custaria tanto quanto o checkpoint
+    // Gravado em fundo (prioridade baixa); descartado se o diário andar antes
+    if (diarioNoLimiteCheckpoint(estados.size()) && !checkpointAgendado) {
+        checkpointAgendado = true;
+        unsigned long long seqAgendada = seqDiario;
+        tarefasFundo.submeter([this, snapshot, seqAgendada]() {
+            lock_guard<mutex> gravacao(mutexGravacao);
+            coletarSalvamentoTravado(true);
+            checkpointAgendado = false;
+            if (seqDiario != seqAgendada) {
+                return;  // Novas entradas: o próximo salvarDados agenda outro
+            }
+            try {
+                gravarCheckpointTravado(*snapshot);
+            } catch (const EstoqueException& e) {
+                cerr << "Erro: " << e.what() << endl;  // Diário continua válido
+            }
+        }, PRIORIDADE_BAIXA);
+    }
+
+    // === Salvar Movimentos ===
+    if (!gravarMovimentosTravado(*snapshot, regravar)) {
+        return;  // Falha silenciosa
+    }
+    if (regravar) {
+        lock_guard<mutex> trava(mutexEstado);
+        regravarMovimentos = false;
+    }
+    
+    cout << "Dados salvos com sucesso." << endl;
+}
+
+// Histórico em ordem crescente de ID: os não gravados são o sufixo
+// com ID > ultimoMovimentoGravado
+std::size_t Estoque::inicioNaoGravados(const SnapshotEstoque& snapshot, bool regravar) const {
+    if (regravar) {
+        return 0;
+    }
+    std::size_t inicio = snapshot.tamanhoHistorico();
+    while (inicio > 0 && snapshot.movimento(inicio - 1)->getId() > ultimoMovimentoGravado) {
+        --inicio;
+    }
+    return inicio;
+}
+
+// Acréscimo: o histórico já gravado não é reescrito (exceto regravar)
+bool Estoque::gravarMovimentosTravado(const SnapshotEstoque& snapshot, bool regravar) const {
+    std::size_t total = snapshot.tamanhoHistorico();
+    std::size_t inicio = inicioNaoGravados(snapshot, regravar);
+    if (!regravar && inicio == total) {
+        return true;  // Nada novo
+    }
+    ofstream arqMov(ARQUIVO_MOVIMENTOS, regravar ? std::ios::trunc : std::ios::app);
+    if (!arqMov.is_open()) {  // Verifica se abriu corretamente
+        cerr << "Erro: Nao foi possivel abrir o arquivo " << ARQUIVO_MOVIMENTOS << " para salvar." << endl;
+        return false;
+    }
+    if (faltaQuebraLinha && !regravar) {
+        arqMov << "\n";  // Última linha gravada por uma execução interrompida
+    }
+    for (std::size_t i = inicio; i < total; ++i) {
+        gravarMovimento(arqMov, snapshot.movimento(i));
+    }
+    arqMov.close();  // Fecha arquivo
+    if (arqMov.fail()) {
+        cerr << "Erro: Falha ao gravar o arquivo " << ARQUIVO_MOVIMENTOS << "." << endl;
+        return false;
+    }
+    faltaQuebraLinha = false;
+    if (total > 0) {
+        ultimoMovimentoGravado = snapshot.movimento(total - 1)->getId();
+    }
+    return true;
+}
+
+// === CHECKPOINT DOS ITENS ===
+
+// Ordem pensando em interrupções: itens.txt, estoque.ckp (temporário + rename),
+// diário vazio. Um checkpoint novo com o diário antigo é seguro: a carga
+// ignora entradas com sequência <= a do checkpoint
+void Estoque::gravarCheckpointTravado(const SnapshotEstoque& snapshot) const {
+    const vector<shared_ptr<const EstadoItem> >& estados = snapshot.getItens();
+
+    // 1. itens.txt: mesmo estado em texto (leitura humana, verificar_integridade)
+    ofstream arqItens(ARQUIVO_ITENS);
+    if (!arqItens.is_open()) {
+        throw EstoqueException("Nao foi possivel abrir " + ARQUIVO_ITENS + ".");
+    }
+    for (std::size_t i = 0; i < estados.size(); ++i) {
+        gravarItem(arqItens, *estados[i]);
+    }
+    arqItens.close();
+    if (arqItens.fail()) {
+        throw EstoqueException("Falha ao gravar " + ARQUIVO_ITENS + ".");
+    }
+
+    // 2. Checkpoint binário com a sequência já incorporada
+    CheckpointEstoque::gravar(ARQUIVO_CHECKPOINT, seqDiario, Item::getProximoId(), estados);
+
+    // 3. Diário vazio
+    ofstream arqDiario(ARQUIVO_DIARIO, std::ios::trunc);
+    arqDiario.close();
+
+    marcarCheckpointGravado(snapshot);
+}
+
+void Estoque::marcarCheckpointGravado(const SnapshotEstoque& snapshot) const {
+    const vector<shared_ptr<const EstadoItem> >& estados = snapshot.getItens();
+    versoesGravadas.clear();
+    versoesGravadas.reserve(estados.size());
+    for (std::size_t i = 0; i < estados.size(); ++i) {
+        versoesGravadas[estados[i]->id] = estados[i]->versao;
+    }
+    entradasDiario = 0;
+    faltaQuebraDiario = false;
+    checkpointEmDia = true;
+}
+
+bool Estoque::diarioNoLimiteCheckpoint(std::size_t numItens) const {
+    return entradasDiario >= std::max(numItens, MIN_ENTRADAS_CHECKPOINT);
+}
+
+void Estoque::gravarCheckpoint() const {
+    lock_guard<mutex> gravacao(mutexGravacao);
+    coletarSalvamentoTravado(true);
+    shared_ptr<const SnapshotEstoque> snapshot;
+    {
+        lock_guard<mutex> trava(mutexEstado);
+        snapshot = montarSnapshot();
+    }
+
+    // Nada mudou desde o último checkpoint: mesmas versões, nenhum removido
+    const vector<shared_ptr<const EstadoItem> >& estados = snapshot->getItens();
+    bool mudou = !checkpointEmDia || estados.size() != versoesGravadas.size();
+    for (std::size_t i = 0; i < estados.size() && !mudou; ++i) {
+        unordered_map<int, unsigned long>::const_iterator gravada = versoesGravadas.find(estados[i]->id);
+        mudou = gravada == versoesGravadas.end() || gravada->second != estados[i]->versao;
+    }
+    if (mudou) {
+        gravarCheckpointTravado(*snapshot);
+    }
+}
+
+// === SALVAMENTO EM SEGUNDO PLANO ===
+
+#ifndef _WIN32
+// Buffer que o pai reserva antes do fork para o filho serializar os arquivos
+static const std::size_t TAMANHO_BUFFER_FILHO = 64 * 1024;
+
+// Abre 'caminho' e grava o que escrever(saida) produzir, em blocos do
+// buffer reservado: só open/write/close (async-signal-safe), para o filho
+// do fork, onde não se pode alocar nem usar iostream
+// modo: O_TRUNC ou O_APPEND
+template <typename Escrita>
+static bool gravarArquivoNoFilho(const char* caminho, int modo, char* buffer, Escrita escrever) {
+    int fd = open(caminho, O_WRONLY | O_CREAT | modo, 0666);
+    if (fd < 0) {
+        return false;
+    }
+    SaidaDescritor saida(fd, buffer, TAMANHO_BUFFER_FILHO);
+    escrever(saida);
+    bool gravou = saida.descarregar();
+    return close(fd) == 0 && gravou;
+}
+
+// itens.txt no filho: mesmas linhas de gravarCheckpointTravado
+static void escreverItensNoFilho(SaidaDescritor& saida, const vector<shared_ptr<const EstadoItem> >& estados) {
+    for (std::size_t i = 0; i < estados.size(); ++i) {
+        gravarItem(saida, *estados[i]);
+    }
+}
+
+// Movimentos não gravados no filho: mesmas linhas de gravarMovimentosTravado
+static void escreverMovimentosNoFilho(SaidaDescritor& saida, const SnapshotEstoque& imagem,
+                                      std::size_t inicio, bool quebraPendente) {
+    if (quebraPendente) {
+        saida << "\n";  // Última linha gravada por uma execução interrompida
+    }
+    for (std::size_t i = inicio; i < imagem.tamanhoHistorico(); ++i) {
+        gravarMovimento(saida, imagem.movimento(i));
+    }
+}
+#endif
+
+int Estoque::salvarEmSegundoPlano() const {
+#ifdef _WIN32
+    throw EstoqueException("Salvamento em segundo plano nao suportado nesta plataforma.");
+#else
+    lock_guard<mutex> gravacao(mutexGravacao);
+    coletarSalvamentoTravado(false);
+    if (pidSalvamento != 0) {
+        throw EstoqueException("Salvamento em segundo plano ja em andamento (PID " + to_string(pidSalvamento) + ").");
+    }
+
+    shared_ptr<const SnapshotEstoque> snapshot;
+    shared_ptr<EpocaHistorico> epoca;
+    {
+        lock_guard<mutex> trava(mutexEstado);
+        snapshot = montarSnapshot();
+        if (regravarMovimentos) {
+            epoca = epocaAtual;
+        }
+    }
+    const bool regravar = static_cast<bool>(epoca);
+    const std::size_t inicio = inicioNaoGravados(*snapshot, regravar);
+    const bool movimentos = regravar || inicio < snapshot->tamanhoHistorico();
+
+    // Antes do fork, só o que é O(1): o filho serializa os arquivos a partir
+    // do snapshot herdado (copy-on-write), pelo buffer reservado aqui
+    const vector<shared_ptr<const EstadoItem> >& estados = snapshot->getItens();
+    const SnapshotEstoque& imagem = *snapshot;
+    const unsigned long long seq = seqDiario;
+    const int proximoIdItem = Item::getProximoId();
+    const bool quebraPendente = faltaQuebraLinha && !regravar;
+    vector<char> bufferFilho(TAMANHO_BUFFER_FILHO);
+    char* buffer = &bufferFilho[0];
+    const string temporarioCheckpoint = ARQUIVO_CHECKPOINT + ".tmp";
+
+    cout.flush();  // Saída pendente não é repetida pelo filho
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw EstoqueException(string("Falha ao criar processo de salvamento: ") + std::strerror(errno));
+    }
+    if (pid == 0) {
+        // Filho: só esta thread existe nele, e travas do pai (inclusive a do
+        // malloc) podem ter ficado seguras por threads que não vieram junto.
+        // Por isso apenas chamadas async-signal-safe (POSIX): open, write,
+        // close, rename e _exit; a serialização só lê o snapshot e formata
+        // no buffer reservado (SaidaDescritor). Sem alocação, iostream,
+        // exceções, pool de tarefas nem destrutores
+        // Mesma ordem de gravarCheckpointTravado: itens.txt, estoque.ckp, diário vazio
+        int codigo = 0;
+        if (!gravarArquivoNoFilho(ARQUIVO_ITENS.c_str(), O_TRUNC, buffer,
+                                  [&](SaidaDescritor& s) { escreverItensNoFilho(s, estados); }) ||
+            !gravarArquivoNoFilho(temporarioCheckpoint.c_str(), O_TRUNC, buffer,
+                                  [&](SaidaDescritor& s) { CheckpointEstoque::serializar(s, seq, proximoIdItem, estados); }) ||
+            rename(temporarioCheckpoint.c_str(), ARQUIVO_CHECKPOINT.c_str()) != 0 ||
+            !gravarArquivoNoFilho(ARQUIVO_DIARIO.c_str(), O_TRUNC, buffer, [](SaidaDescritor&) {})) {
+            codigo = 1;
+        } else if (movimentos &&
+                   !gravarArquivoNoFilho(ARQUIVO_MOVIMENTOS.c_str(), regravar ? O_TRUNC : O_APPEND, buffer,
+                                         [&](SaidaDescritor& s) { escreverMovimentosNoFilho(s, imagem, inicio, quebraPendente); })) {
+            codigo = 2;
+        }
+        _exit(codigo);
+    }
+
+    // Pai: segue atendendo; o filho grava a imagem herdada
+    pidSalvamento = static_cast<int>(pid);
+    snapshotSalvamento = snapshot;
+    movimentosNoSalvamento = movimentos;
+    epocaSalvamento = epoca;
+    inicioSalvamento = std::chrono::steady_clock::now();
+    StatusSalvamento andamento = { SALVAMENTO_EM_ANDAMENTO, pidSalvamento, 0, 0 };
+    ultimoSalvamento = andamento;
+    return pidSalvamento;
+#endif
+}
+
+// Reproduz no pai o efeito das gravações que o filho concluiu
+// (o filho alterou apenas a própria cópia da memória)
+void Estoque::coletarSalvamentoTravado(bool esperar) const {
+#ifndef _WIN32
+    if (pidSalvamento == 0) {
+        return;
+    }
+    int status = 0;
+    pid_t colhido;
+    do {
+        colhido = waitpid(static_cast<pid_t>(pidSalvamento), &status, esperar ? 0 : WNOHANG);
+    } while (colhido < 0 && errno == EINTR);
+    if (colhido == 0) {
+        return;  // Ainda gravando
+    }
+
+    int codigo = -1;  // waitpid falhou (SIGCHLD ignorado): situação do filho desconhecida
+    if (colhido > 0 && WIFEXITED(status)) {
+        codigo = WEXITSTATUS(status);
+    } else if (colhido > 0 && WIFSIGNALED(status)) {
+        codigo = -WTERMSIG(status);
+    }
+    // Código 2: checkpoint gravado (diário já esvaziado), movimentos não
+    if (codigo == 0 || codigo == 2) {
+        marcarCheckpointGravado(*snapshotSalvamento);
+    }
+    if (codigo == 0 && movimentosNoSalvamento) {
+        std::size_t total = snapshotSalvamento->tamanhoHistorico();
+        if (total > 0) {
+            ultimoMovimentoGravado = snapshotSalvamento->movimento(total - 1)->getId();
+        }
+        faltaQuebraLinha = false;
+    }
+    if (codigo == 0 && epocaSalvamento) {
+        // Nova compactação durante o salvamento: movimentos.txt ainda precisa ser regravado
+        lock_guard<mutex> trava(mutexEstado);
+        if (epocaAtual == epocaSalvamento) {
+            regravarMovimentos = false;
+        }
+    }
+
+    StatusSalvamento fim;
+    fim.situacao = (codigo == 0) ? SALVAMENTO_CONCLUIDO : SALVAMENTO_FALHOU;
+    fim.pid = pidSalvamento;
+    fim.codigoSaida = codigo;
+    fim.duracaoMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - inicioSalvamento).count();
+    ultimoSalvamento = fim;
+    pidSalvamento = 0;
+    snapshotSalvamento.reset();
+    epocaSalvamento.reset();
+#else
+    (void)esperar;
+#endif
+}
+
+StatusSalvamento Estoque::consultarSalvamentoEmSegundoPlano() const {
+    lock_guard<mutex> gravacao(mutexGravacao);
+    coletarSalvamentoTravado(false);
+    return ultimoSalvamento;
+}
+
+// === CHECKPOINT DO HISTÓRICO ===
+
+static bool lerUltimoIdMovimento(const string& caminho, int& ultimoId, bool& terminaEmQuebra);
+
+// Corta a última linha do arquivo se ela não termina em '\n' (gravação interrompida)
+static void cortarLinhaIncompleta(const string& caminho) {
+    ifstream arq(caminho, std::ios::binary);
+    arq.seekg(0, std::ios::end);
+    std::streamoff fim = arq.tellg();
+    char c = '\n';
+    while (fim > 0 && arq.seekg(fim - 1) && arq.get(c) && c != '\n') {
+        --fim;
+    }
+    arq.close();
+#ifndef _WIN32
+    if (truncate(caminho.c_str(), static_cast<off_t>(fim)) != 0) {
+        throw EstoqueException("Nao foi possivel corrigir " + caminho + ": " + std::strerror(errno));
+    }
+#else
+    // Sem truncate: a linha incompleta fica, separada da próxima
+    ofstream(caminho, std::ios::app) << "\n";
+#endif
+}
+
+// Acrescenta o lote ao arquivo morto sem duplicar linhas
+// 
+// O arquivo morto recebe IDs em ordem crescente: as linhas do lote com ID até o
+// da última linha completa já gravada são puladas. Uma tentativa anterior
+// interrompida depois de acrescentar (antes do resumo) não gera linhas repetidas,
+// e a última linha incompleta de uma gravação interrompida é cortada antes
+// Lança: EstoqueException se não conseguir gravar
+static void acrescentarArquivoMorto(const string& caminho, const vector<const MovimentoEstoque*>& lote) {
+    int ultimoGravado = 0;
+    bool terminaEmQuebra = true;
+    lerUltimoIdMovimento(caminho, ultimoGravado, terminaEmQuebra);
+    if (!terminaEmQuebra) {
+        cortarLinhaIncompleta(caminho);
+        lerUltimoIdMovimento(caminho, ultimoGravado, terminaEmQuebra);
+    }
+
+    ofstream arquivo(caminho, std::ios::app);
+    if (!arquivo.is_open()) {
+        throw EstoqueException("Nao foi possivel abrir " + caminho + ".");
+    }
+    for (std::size_t i = 0; i < lote.size(); ++i) {
+        if (lote[i]->getId() > ultimoGravado) {
+            gravarMovimento(arquivo, lote[i]);
+        }
+    }
+    arquivo.close();
+    if (arquivo.fail()) {
+        throw EstoqueException("Falha ao gravar " + caminho + ".");
+    }
+}
+
+// Arquiva o prefixo antigo do histórico (ver Estoque.h)
+// 
+// mutexEstado só é travado para coletar o prefixo e, no fim, para retirá-lo;
+// as gravações acontecem fora dele (operações continuam durante a compactação).
+// mutexCompactacao garante uma compactação por vez: o prefixo coletado não
+// muda (o histórico só cresce no fim) e os ponteiros continuam válidos
+// 
+// Ordem das gravações, pensando em interrupções:
+// 1. movimentos_arquivo.txt (acréscimo sem duplicar, acrescentarArquivoMorto)
+// 2. resumo_movimentos.txt (temporário + rename): a partir daqui a carga
+//    ignora os movimentos arquivados mesmo que movimentos.txt ainda os tenha
+// 3. diário dos itens e movimentos.txt regravado (salvarDados)
+// Falha em 1 ou 2 lança exceção sem alterar o histórico nem o resumo em
+// memória; repetir a operação não duplica linhas no arquivo morto
+std::size_t Estoque::compactarHistorico(int diasMantidos) {
+    if (diasMantidos < 0) {
+        throw EstoqueException("Numero de dias nao pode ser negativo.");
+    }
+    lock_guard<mutex> compactacao(mutexCompactacao);
+
+    // 1. Sob a trava: prefixo a arquivar e resumo atual
+    vector<const MovimentoEstoque*> prefixo;
+    unordered_map<int, ResumoMovimentosItem> resumo;
+    int ultimoArquivado = 0;
+    string corte;
+    {
+        lock_guard<mutex> trava(mutexEstado);
+        carregarHistorico();
+        corte = dataDiasAtras(diasMantidos);
+
+        // Histórico em ordem de data: os arquivados formam um prefixo
+        std::size_t arquivados = 0;
+        while (arquivados < historico.tamanho() && historico[arquivados]->getData() < corte) {
+            ++arquivados;
+        }
+        if (diasMantidos == 0) {
+            arquivados = historico.tamanho();  // Arquiva tudo, inclusive movimentos deste segundo
+        }
+        if (arquivados == 0) {
+            return 0;
+        }
+        prefixo.reserve(arquivados);
+        for (std::size_t i = 0; i < arquivados; ++i) {
+            prefixo.push_back(historico[i].get());
+        }
+        resumo = resumoArquivado;
+        ultimoArquivado = ultimoMovimentoArquivado;
+    }
+    const std::size_t arquivados = prefixo.size();
+
+    // 2. Fora da trava: arquivo morto e novo resumo por item
+    acrescentarArquivoMorto(ARQUIVO_MOVIMENTOS_ARQUIVADOS, prefixo);
+    for (std::size_t i = 0; i < arquivados; ++i) {
+        const MovimentoEstoque* mov = prefixo[i];
+        ResumoMovimentosItem& r = resumo[mov->getIdItem()];
+        if (mov->getTipo() == ENTRADA) {
+            r.entradas += mov->getQuantidade();
+        } else {
+            r.saidas += mov->getQuantidade();
+        }
+        ++r.movimentos;
+        if (mov->getId() > ultimoArquivado) {
+            ultimoArquivado = mov->getId();
+        }
+    }
+    gravarResumoArquivado(resumo, ultimoArquivado, corte);
+
+    // 3. Sob a trava: publica o resumo e retira o prefixo do histórico;
+    //    snapshots antigos ainda podem ver os retirados: a época atual fica
+    //    com eles (e com a posse) e uma nova época começa
+    {
+        lock_guard<mutex> trava(mutexEstado);
+        resumoArquivado.swap(resumo);
+        ultimoMovimentoArquivado = ultimoArquivado;
+        dataCorteArquivada = corte;
+
+        vector<MovimentoEstoque*> retirados(arquivados);
+        for (std::size_t i = 0; i < arquivados; ++i) {
+            retirados[i] = historico[i].release();  // Mesmos objetos de 'prefixo'
+        }
+        historico.removerInicio(arquivados);
+        colunaQtdMovimentos.erase(colunaQtdMovimentos.begin(), colunaQtdMovimentos.begin() + arquivados);
+        colunaTipoMovimentos.erase(colunaTipoMovimentos.begin(), colunaTipoMovimentos.begin() + arquivados);
+        epocaAtual->aposentar(retirados);
+        shared_ptr<EpocaHistorico> novaEpoca = std::make_shared<EpocaHistorico>();
+        epocaAtual->encadear(novaEpoca);
+        epocaAtual = novaEpoca;
+
+        // Blocos selados usam posições do histórico antigo
+        blocosSelados.clear();
+        snapshotAtual.reset();
+        regravarMovimentos = true;  // movimentos.txt perde o prefixo arquivado
+        ++versao;
+    }
+
+    // 4. Estado atual dos itens + histórico recente
+    salvarDados();
+    cout << arquivados << " movimento(s) arquivado(s) em " << ARQUIVO_MOVIMENTOS_ARQUIVADOS << "." << endl;
+    return arquivados;
+}
+
+// Grava em arquivo temporário e troca pelo definitivo: um resumo
+// incompleto nunca substitui o anterior
+void Estoque::gravarResumoArquivado(const unordered_map<int, ResumoMovimentosItem>& resumo,
+                                    int ultimoArquivado, const string& corte) const {
+    const string temporario = ARQUIVO_RESUMO_MOVIMENTOS + ".tmp";
+    ofstream arq(temporario);
+    if (!arq.is_open()) {
+        throw EstoqueException("Nao foi possivel abrir " + temporario + ".");
+    }
+
+    // Itens em ordem de ID: arquivo estável entre execuções
+    vector<int> ids;
+    ids.reserve(resumo.size());
+    unordered_map<int, ResumoMovimentosItem>::const_iterator it;
+    for (it = resumo.begin(); it != resumo.end(); ++it) {
+        ids.push_back(it->first);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    arq << "ATE;" << ultimoArquivado << ";" << corte << "\n";
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        const ResumoMovimentosItem& r = resumo.find(ids[i])->second;
+        arq << ids[i] << ";" << r.entradas << ";" << r.saidas << ";" << r.movimentos << "\n";
+    }
+    arq.close();
+    if (arq.fail() || std::rename(temporario.c_str(), ARQUIVO_RESUMO_MOVIMENTOS.c_str()) != 0) {
+        throw EstoqueException("Falha ao gravar " + ARQUIVO_RESUMO_MOVIMENTOS + ".");
+    }
+}
+
+// Formato: ATE;ULTIMO_ID_MOV;DATA_CORTE seguido de IDITEM;ENTRADAS;SAIDAS;MOVIMENTOS
+// Arquivo ausente = histórico nunca compactado
+void Estoque::carregarResumoArquivado() {
+    ifstream arq(ARQUIVO_RESUMO_MOVIMENTOS);
+    if (!arq.is_open()) {
+        return;
+    }
+    string linha, campo;
+    if (getline(arq, linha)) {
+        stringstream ss(linha);
+        getline(ss, campo, ';');
+        if (campo != "ATE") {
+            cerr << "Erro: cabecalho invalido em " << ARQUIVO_RESUMO_MOVIMENTOS << "." << endl;
+            return;
+        }
+        try {
+            getline(ss, campo, ';');
+            ultimoMovimentoArquivado = stoi(campo);
+            getline(ss, dataCorteArquivada);
+        } catch (const exception& e) {
+            cerr << "Erro ao ler cabecalho de " << ARQUIVO_RESUMO_MOVIMENTOS << ": " << e.what() << endl;
+            return;
+        }
+    }
+
+    lock_guard<mutex> trava(mutexEstado);
+    while (getline(arq, linha)) {
+        stringstream ss(linha);
+        string idStr, entradasStr, saidasStr, movimentosStr;
+        getline(ss, idStr, ';');
+        getline(ss, entradasStr, ';');
+        getline(ss, saidasStr, ';');
+        getline(ss, movimentosStr, ';');
+        try {
+            ResumoMovimentosItem resumo;
+            resumo.entradas = std::stoll(entradasStr);
+            resumo.saidas = std::stoll(saidasStr);
+            resumo.movimentos = std::stoll(movimentosStr);
+            int idItem = stoi(idStr);
+            resumoArquivado[idItem] = resumo;
+            if (resumo.saidas > 0) {
+                totalSaidasPorItem[idItem] += resumo.saidas;  // Rankings de todo o período
+            }
+        } catch (const exception& e) {
+            cerr << "Erro ao ler linha de " << ARQUIVO_RESUMO_MOVIMENTOS << ": " << e.what() << endl;
+        }
+    }
+}
+
+// Lê o ID da última linha válida de movimentos.txt sem percorrer o arquivo
+// Janela de 4 KB a partir do fim, dobrada até conter uma linha válida
+// terminaEmQuebra = false se a última linha ficou incompleta (sem '\n')
+// Retorna false se o arquivo não existe (ultimoId = 0)
+static bool lerUltimoIdMovimento(const string& caminho, int& ultimoId, bool& terminaEmQuebra) {
+    ultimoId = 0;
+    terminaEmQuebra = true;
+    ifstream arq(caminho, std::ios::binary);
+    if (!arq.is_open()) {
+        return false;
+    }
+    arq.seekg(0, std::ios::end);
+    const std::streamoff tamanho = arq.tellg();
+    if (tamanho <= 0) {
+        return true;
+    }
+
+    string cauda;
+    for (std::streamoff janela = 4096; ; janela *= 2) {
+        const std::streamoff inicio = tamanho > janela ? tamanho - janela : 0;
+        cauda.resize(static_cast<std::size_t>(tamanho - inicio));
+        arq.seekg(inicio);
+        if (!arq.read(&cauda[0], static_cast<std::streamsize>(cauda.size()))) {
+            return true;  // Erro de leitura: trata como histórico vazio
+        }
+        terminaEmQuebra = cauda[cauda.size() - 1] == '\n';
+
+        // Linhas de trás para frente; a primeira da janela só vale se a janela
+        // começa no início do arquivo (senão pode estar cortada)
+        std::size_t fim = cauda.size();
+        while (fim > 0) {
+            std::size_t quebra = cauda.rfind('\n', fim - 1);
+            std::size_t comeco = (quebra == string::npos) ? 0 : quebra + 1;
+            if (quebra == string::npos && inicio > 0) {
+                break;  // Linha cortada pela janela: amplia
+            }
+            const char* texto = cauda.c_str() + comeco;
+            char* depois = nullptr;
+            long id = std::strtol(texto, &depois, 10);
+            if (depois != texto && *depois == ';' && id > 0) {
+                ultimoId = static_cast<int>(id);
+                return true;
+            }
+            if (quebra == string::npos) {
+                return true;  // Nenhuma linha válida no arquivo
+            }
+            fim = quebra;
+        }
+        if (inicio == 0) {
+            return true;
+        }
+    }
+}
+
+// Carrega todos os dados (items e movimentos) dos arquivos de texto
+// Chamado no construtor ao iniciar a aplicação
+// 
+// Processo Items:
+// 1. Lê estoque.ckp (binário); se ausente ou inválido, abre itens.txt e
+//    faz parse de cada linha TYPE;ID;NAME;DESC;QTY;LINK;DETAIL[;MIN] (MIN opcional)
+//    com LeitorRegistros (delimitadores localizados em blocos, SIMD)
+// 2. Reaplica as entradas do diário posteriores ao checkpoint
+// 3. localizarTipo(TYPE) encontra o tipo no registro (hash da tag, sem cadeia de if)
+// 4. O descritor cria o item preservando o ID do arquivo (construtor de carga)
+// 5. Adiciona à lista items
+// 6. Atualiza Item::proximoId para continuar IDs únicos
+// 
+// Processo Movimentos:
+// 1. Lê só o fim de movimentos.txt: ID da última linha (lerUltimoIdMovimento)
+// 2. Atualiza MovimentoEstoque::proximoId para continuar IDs únicos
+// 3. As linhas em si ficam para carregarHistorico() (primeira consulta)
+// 
+// Tratamento de erro:
+// - Se arquivo não existe: aviso e continua (primeira execução)
+// - Se linha corrompida: aviso e pula linha
+void Estoque::carregarDados() {
+    ESTOQUE_MEDIR(metricas, OP_CARREGAR_DADOS);
+    // === Carregar Items: checkpoint binário + diário (ou itens.txt) ===
+    vector<RegistroItem> registros;
+    unsigned long long seqCheckpoint = 0;
+    int proximoIdItem = 0;
+    bool temCheckpoint = CheckpointEstoque::ler(ARQUIVO_CHECKPOINT, seqCheckpoint, proximoIdItem, registros);
+    if (!temCheckpoint && !CheckpointEstoque::lerItensTexto(ARQUIVO_ITENS, registros)) {
+        cout << "Aviso: Arquivo " << ARQUIVO_ITENS << " nao encontrado. Comecando com estoque vazio." << endl;
+    }
+
+    // Alterações posteriores ao checkpoint
+    int maxId = proximoIdItem - 1;  // Rastreia maior ID encontrado (removidos inclusive)
+    bool diarioTerminaEmQuebra = true;
+    std::size_t reaplicadas = CheckpointEstoque::reaplicarDiario(ARQUIVO_DIARIO, seqCheckpoint, registros,
+                                                                 seqDiario, maxId, diarioTerminaEmQuebra);
+    entradasDiario = reaplicadas;
+    faltaQuebraDiario = false;
+    if (!diarioTerminaEmQuebra) {
+        // Entrada incompleta (não reaplicada): cortada, senão o próximo
+        // acréscimo a completaria com '\n' e a carga seguinte a reaplicaria
+        try {
+            cortarLinhaIncompleta(ARQUIVO_DIARIO);
+        } catch (const EstoqueException& e) {
+            cerr << "Erro: " << e.what() << endl;
+            faltaQuebraDiario = true;
+        }
+    }
+    checkpointEmDia = temCheckpoint && reaplicadas == 0;
+
+    // Criação dos itens em paralelo (pool global); posição i = registro i
+    vector<Item*> criados(registros.size(), nullptr);
+    PoolTarefas& pool = PoolTarefas::global();
+    unsigned trechos = pool.trechosPara(registros.size(), MIN_ITENS_CARGA_POR_TRECHO);
+    pool.paraCadaTrecho(registros.size(), trechos, [&](unsigned, std::size_t inicio, std::size_t fim) {
+        for (std::size_t i = inicio; i < fim; ++i) {
+            const RegistroItem& registro = registros[i];
+            // Tipo pela tag: tipos não registrados são ignorados
+            const DescritorTipoItem* descritor = localizarTipo(registro.tipo.data(), registro.tipo.size());
+            if (descritor && registro.campos.id > 0) {  // id 0: removido pelo diário
+                // Construtor de carga: mantém o ID gravado (movimentos referenciam esse ID)
+                criados[i] = descritor->criar(registro.campos);
+                criados[i]->setMinimo(registro.minimo);  // Sem observador ainda: nenhum alerta na carga
+            }
+        }
+    });
+
+    vector<Item*> carregados;  // Inseridos em lote ao final (índices construídos uma vez)
+    carregados.reserve(registros.size());
+    for (std::size_t i = 0; i < criados.size(); ++i) {
+        if (criados[i] != nullptr) {
+            if (criados[i]->getId() > maxId) maxId = criados[i]->getId();  // Rastreia maior ID
+            carregados.push_back(criados[i]);
+        }
+    }
+    this->adicionarItens(carregados, false);  // Saldos já estão no histórico gravado
+    // Atualiza ID estático para evitar duplicação quando criar novo item
+    Item::setProximoId(maxId + 1);
+
+    // Estado carregado = estado gravado: o próximo salvarDados só registra alterações
+    versoesGravadas.reserve(carregados.size());
+    for (std::size_t i = 0; i < carregados.size(); ++i) {
+        versoesGravadas[carregados[i]->getId()] = carregados[i]->getVersao();
+    }
+
+    // === Carregar Resumo dos Movimentos Arquivados ===
+    carregarResumoArquivado();
+
+    // === Carregar Movimentos (somente o fim do arquivo) ===
+    bool terminaEmQuebra = true;
+    if (!lerUltimoIdMovimento(ARQUIVO_MOVIMENTOS, ultimoMovimentoEmDisco, terminaEmQuebra)) {
+        cout << "Aviso: Arquivo " << ARQUIVO_MOVIMENTOS << " nao encontrado. Comecando com historico vazio." << endl;
+    }
+    ultimoMovimentoGravado = ultimoMovimentoEmDisco;
+    faltaQuebraLinha = !terminaEmQuebra;
+    if (ultimoMovimentoEmDisco <= ultimoMovimentoArquivado) {
+        historicoCarregado = true;  // Nada além do que já foi arquivado e resumido
+    }
+    // Atualiza ID estático para evitar duplicação quando criar novo movimento
+    // (IDs continuam após os arquivados mesmo sem movimentos.txt)
+    int maxIdMov = ultimoMovimentoEmDisco > ultimoMovimentoArquivado ? ultimoMovimentoEmDisco
+                                                                     : ultimoMovimentoArquivado;
+    MovimentoEstoque::setProximoId(maxIdMov + 1);
+}
+
+// Carga sob demanda de movimentos.txt
+// 
+// Processo:
+// 1. Para cada linha: parse ID;DATA;TIPO;QTY;IDITEM;NOMEITEM (LeitorRegistros)
+// 2. Ignora IDs já arquivados (compactação interrompida antes de regravar o arquivo)
+// 3. Para no primeiro ID acima de ultimoMovimentoEmDisco: dali em diante são
+//    movimentos desta execução já gravados por salvarDados (estão em memória)
+// 4. Cria new MovimentoEstoque(...) com construtor de carregamento
+// 5. Insere o lote antes dos movimentos anexados desde a inicialização
+// 
+// Tratamento de erro:
+// - Se arquivo não existe: aviso e histórico fica só com o que está em memória
+// - Se linha corrompida: aviso e pula linha
+void Estoque::carregarHistorico() const {
+    if (historicoCarregado) {
+        return;
+    }
+    historicoCarregado = true;  // Mesmo se falhar: não relê o arquivo a cada consulta
+    ESTOQUE_MEDIR(metricas, OP_CARREGAR_HISTORICO);
+
+    ifstream arqMov(ARQUIVO_MOVIMENTOS);  // Abre arquivo para leitura
+    if (!arqMov.is_open()) {  // Removido depois da inicialização
+        cerr << "Aviso: Arquivo " << ARQUIVO_MOVIMENTOS << " nao encontrado. Historico gravado nao carregado." << endl;
+        return;
+    }
+
+    int id, qtd, idItem;
+    vector<std::unique_ptr<MovimentoEstoque> > gravados;
+    LeitorRegistros leitor(arqMov);
+
+    // Lê arquivo linha por linha
+    while (leitor.proximo()) {
+        try {
+            id = leitor.campoInteiro(0);      // ID
+            qtd = leitor.campoInteiro(3);     // Quantidade
+            idItem = leitor.campoInteiro(4);  // ID do item
+            if (id > ultimoMovimentoEmDisco) {
+                break;  // Gravado nesta execução: já está no histórico em memória
+            }
+            if (id <= ultimoMovimentoArquivado) {
+                continue;  // Já arquivado e resumido (compactação interrompida antes de regravar o arquivo)
+            }
+
+            // Converte string "ENTRADA" ou "SAIDA" para enum TipoMovimento
+            TipoMovimento tipo = (leitor.campoIgual(2, "ENTRADA") ? ENTRADA : SAIDA);
+            
+            // Cria novo movimento usando construtor de carregamento
+            // (não incrementa proximoId - já tem ID do arquivo)
+            // Campos 1 e 5: data/hora "YYYY-MM-DD HH:MM:SS" e nome do item
+            gravados.push_back(std::unique_ptr<MovimentoEstoque>(
+                new MovimentoEstoque(id, leitor.campo(1), tipo, qtd, idItem, leitor.campo(5))));
+            if (tipo == SAIDA) {
+                totalSaidasPorItem[idItem] += qtd;  // Mesmo total mantido por anexarMovimento
+            }
+
+        } catch (const exception& e) {
+            cerr << "Erro ao ler linha do arquivo de movimentos: " << e.what() << endl;
+            // Continua com próxima linha (ignora erro)
+        }
+    }
+    arqMov.close();
+
+    // Gravados vêm antes dos anexados nesta execução (ordem de ID)
+    const std::size_t numGravados = gravados.size();
+    historico.adicionarInicio(std::move(gravados));
+    vector<std::int32_t> quantidades(numGravados);
+    vector<std::uint8_t> tipos(numGravados);
+    for (std::size_t i = 0; i < numGravados; ++i) {
+        quantidades[i] = historico[i]->getQuantidade();
+        tipos[i] = static_cast<std::uint8_t>(historico[i]->getTipo());
+    }
+    colunaQtdMovimentos.insert(colunaQtdMovimentos.begin(), quantidades.begin(), quantidades.end());
+    colunaTipoMovimentos.insert(colunaTipoMovimentos.begin(), tipos.begin(), tipos.end());
+
+    // Blocos selados usam posições do histórico sem o trecho gravado
+    blocosSelados.clear();
+    snapshotAtual.reset();
 }
\ No newline at end of file
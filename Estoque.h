@@ -4,7 +4,44 @@
 #include "ListaGenerica.h"
 #include "Item.h"
 #include "MovimentoEstoque.h"
+#include "SnapshotEstoque.h"
+#include "MetricasEstoque.h"
+#include "ReservaEstoque.h"
+#include "AlertasEstoque.h"
+#include "IndiceTrigramas.h"
+#include "IndiceInvertido.h"
+#include "IndiceDetalhes.h"
+#include "RankingEstoque.h"
+#include "AgregadosSimd.h"
+#include "LogDesfazer.h"
+#include "TransacaoEstoque.h"
+#include "TipoItem.h"
+#include "PoolTarefas.h"
 #include <string>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <chrono>
+
+/**
+ * Situação do último salvamento em segundo plano (Estoque::salvarEmSegundoPlano).
+ */
+enum SituacaoSalvamento {
+    SALVAMENTO_NENHUM,        // Nenhum iniciado nesta execução
+    SALVAMENTO_EM_ANDAMENTO,
+    SALVAMENTO_CONCLUIDO,
+    SALVAMENTO_FALHOU
+};
+
+struct StatusSalvamento {
+    SituacaoSalvamento situacao;
+    int pid;                 // Processo filho que grava (0 = nenhum)
+    int codigoSaida;         // Falha: código de saída do filho (negativo = sinal que o encerrou)
+    long long duracaoMs;     // Do fork até o fim do filho ser percebido
+};
 
 /**
  * Classe principal que gerencia todas as operações do sistema de estoque.
@@ -21,37 +58,375 @@
  * 5. Exibir relatórios de items e movimentações
  * 
  * Padrão Persistência: arquivo-baseado com serialização em texto
- * Formato itens.txt: TYPE;ID;NAME;DESC;QTY;LINK;DETAIL
+ * Formato itens.txt: TYPE;ID;NAME;DESC;QTY;LINK;DETAIL[;MIN]
  * Formato movimentos.txt: ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
+ * Recuperação: estoque.ckp (checkpoint binário) + diario_itens.txt (diário)
  * 
  * Ciclo de vida:
  * - Construtor: carrega dados dos arquivos (se existem)
  * - Operações: add/remove/edit/registrar movimentos via interface
- * - Destrutor: salva dados e libera memória
+ * - Destrutor: salva dados, espera tarefas de fundo e libera memória
+ *   (checkpoint só se o diário passou do limite do automático)
+ *
+ * Concorrência (MVCC):
+ * - Operações de escrita e buscas protegidas por mutexEstado
+ * - reservar, liberarReserva e expirarReservas não usam mutexEstado:
+ *   trava da partição do índice de IDs + compare-and-swap no saldo do Item
+ * - Relatórios (listarItens, exibirHistorico, salvarDados) iteram um
+ *   SnapshotEstoque imutável obtido com obterSnapshot(), sem segurar a trava
+ *
+ * Histórico sob demanda:
+ * - O construtor lê itens.txt e só o fim de movimentos.txt
+ * - O histórico gravado é lido na primeira consulta que precisa dele
+ *   (obterSnapshot, exibirHistorico, maioresSaidas, compactarHistorico)
  */
-class Estoque {
+class Estoque : private IObservadorItem {
 private:
-    // Lista genérica de ponteiros Item* (polimórficos)
+    // Lista genérica de ponteiros para Item (polimórficos), dona dos itens
     // Armazena tanto ItemProduto quanto ItemMateria através de ponteiro base
     // Requisito POO: demonstra polimorfismo (mesmo container, tipos diferentes)
-    ListaGenerica<Item*> itens;
+    // unique_ptr: endereço estável (índices e alertas guardam Item*) e
+    // liberação automática; removerItem entrega a posse ao log de desfazer
+    ListaGenerica<std::unique_ptr<Item> > itens;
     
+    // Índice ID -> Item* para buscas O(1), particionado por ID (id % NUM_PARTICOES_IDS)
+    // Mantido incrementalmente em adicionarItem/removerItem e
+    // reconstruído uma única vez ao final de cargas em lote (adicionarItens)
+    // Escritas seguram mutexEstado e a trava da partição; leituras, uma das
+    // duas. reservar() usa só a trava da partição (não disputa mutexEstado)
+    static const std::size_t NUM_PARTICOES_IDS = 16;
+    struct ParticaoIds {
+        std::mutex trava;
+        std::unordered_map<int, Item*> itens;
+    };
+    mutable ParticaoIds particoesIds[NUM_PARTICOES_IDS];
+
+    ParticaoIds& particaoId(int id) const {
+        return particoesIds[static_cast<unsigned>(id) % NUM_PARTICOES_IDS];
+    }
+
     // Lista genérica de movimentações (ENTRADA/SAIDA)
     // Histórico completo de todas transações para auditoria
-    ListaGenerica<MovimentoEstoque*> historico;
+    // mutable: o trecho gravado em disco é carregado na primeira consulta,
+    // que pode vir de um método const (exibirHistorico, obterSnapshot)
+    // Dona dos movimentos; os arquivados passam para a época do histórico
+    mutable ListaGenerica<std::unique_ptr<MovimentoEstoque> > historico;
 
     // Nomes dos arquivos para persistência de dados
     // Separação deliberada: items vs movimentos (responsabilidades diferentes)
     const std::string ARQUIVO_ITENS = "itens.txt";
     const std::string ARQUIVO_MOVIMENTOS = "movimentos.txt";
 
+    // Checkpoint (compactarHistorico): movimentos antigos e seu resumo por item
+    // Formato movimentos_arquivo.txt: igual a movimentos.txt (somente acréscimo)
+    // Formato resumo_movimentos.txt: ATE;ULTIMO_ID_MOV;DATA_CORTE e linhas IDITEM;ENTRADAS;SAIDAS;MOVIMENTOS
+    const std::string ARQUIVO_MOVIMENTOS_ARQUIVADOS = "movimentos_arquivo.txt";
+    const std::string ARQUIVO_RESUMO_MOVIMENTOS = "resumo_movimentos.txt";
+
+    // Recuperação rápida: checkpoint binário dos itens + diário das alterações posteriores
+    // Formato diario_itens.txt: SEQ;ITEM;<linha de itens.txt> ou SEQ;REMOVER;ID
+    const std::string ARQUIVO_CHECKPOINT = "estoque.ckp";
+    const std::string ARQUIVO_DIARIO = "diario_itens.txt";
+
+    // === CONCORRÊNCIA E SNAPSHOTS (MVCC) ===
+    // Protege itens, historico e o cache de snapshots
+    mutable std::mutex mutexEstado;
+
+    // Versão do Estoque: incrementada a cada mutação feita pelas operações públicas
+    unsigned long versao;
+
+    // Último snapshot publicado (reutilizado enquanto nada mudar)
+    mutable std::shared_ptr<const SnapshotEstoque> snapshotAtual;
+
+    // Estado publicado de cada item por ID (copy-on-write por versão do Item)
+    mutable std::unordered_map<int, std::shared_ptr<const EstadoItem> > estadosPublicados;
+
+    // Blocos cheios do histórico, já selados e compartilhados entre snapshots
+    mutable std::vector<std::shared_ptr<const BlocoHistorico> > blocosSelados;
+
+    // Histogramas de latência por operação (ESTOQUE_MEDIR em cada método público)
+    // mutable: operações const (salvarDados) também registram tempo
+    mutable MetricasEstoque metricas;
+
+    // === RESERVAS ===
+    // Reservas ativas particionadas pelo ID da reserva (id % NUM_PARTICOES_RESERVAS),
+    // cada partição com a própria trava: a tabela não usa mutexEstado
+    // O saldo reservado em si fica no Item (compare-and-swap, ver Item::reservarQtd)
+    static const std::size_t NUM_PARTICOES_RESERVAS = 16;
+    struct ParticaoReservas {
+        std::mutex trava;
+        std::unordered_map<int, ReservaEstoque> reservas;
+    };
+    mutable ParticaoReservas particoesReservas[NUM_PARTICOES_RESERVAS];
+
+    // Próximo ID de reserva (reinicia a cada execução: reservas não são persistidas)
+    std::atomic<int> proximoIdReserva;
+
+    ParticaoReservas& particaoReserva(int idReserva) const {
+        return particoesReservas[static_cast<unsigned>(idReserva) % NUM_PARTICOES_RESERVAS];
+    }
+
+    // Retira a reserva da sua partição (só uma chamadora a obtém)
+    // Lança: EstoqueException se a reserva não existe
+    ReservaEstoque retirarReserva(int idReserva);
+
+    // === ALERTAS DE ESTOQUE BAIXO ===
+    // Observador de todos os itens: índice dos itens abaixo do mínimo + callbacks
+    AlertasEstoque alertas;
+
+    // === BUSCA APROXIMADA POR NOME ===
+    // Trigramas dos nomes normalizados (sem acentos/maiúsculas)
+    IndiceTrigramas indiceNomes;
+
+    // === BUSCA EM DESCRIÇÕES ===
+    // Índice invertido termo -> itens (listas comprimidas)
+    IndiceInvertido indiceDescricoes;
+
+    // === ÍNDICES POR CATEGORIA / FORNECEDOR ===
+    // Um índice por tipo, sobre o campo específico (detalheItem):
+    // [TIPO_PRODUTO] = categorias, [TIPO_MATERIA] = fornecedores
+    IndiceDetalhes indicesDetalhe[NUM_TIPOS_ITEM];
+
+    // === RANKINGS ===
+    // Total de unidades saídas (SAIDA) por ID do item, desde o início do histórico
+    // Mantido a cada movimento anexado: o top-K de todo o período não relê o histórico
+    // mutable: completado pela carga sob demanda do histórico
+    mutable std::unordered_map<int, long long> totalSaidasPorItem;
+
+    // === COLUNAS PARA AGREGADOS (SIMD) ===
+    // Quantidade de cada item em ordem de cadastro, contígua para os kernels
+    // vetoriais; recopiada só quando a versão do Estoque mudou
+    std::vector<std::int32_t> colunaQuantidades;
+    unsigned long versaoColunaQuantidades;
+    bool colunaQuantidadesValida;
+
+    // Quantidade e tipo (0 = ENTRADA, 1 = SAIDA) de cada movimento, paralelas
+    // a historico: acrescentadas por anexarMovimento, ajustadas pela carga sob
+    // demanda e pela compactação (mutable: carregarHistorico é const)
+    mutable std::vector<std::int32_t> colunaQtdMovimentos;
+    mutable std::vector<std::uint8_t> colunaTipoMovimentos;
+
+    // === CHECKPOINT DO HISTÓRICO ===
+    // Totais dos movimentos já arquivados, por ID do item
+    struct ResumoMovimentosItem {
+        long long entradas;
+        long long saidas;
+        long long movimentos;
+    };
+    std::unordered_map<int, ResumoMovimentosItem> resumoArquivado;
+
+    // Maior ID de movimento já arquivado (carga ignora IDs <= este)
+    int ultimoMovimentoArquivado;
+
+    // Data de corte da última compactação ("" = nunca compactado)
+    std::string dataCorteArquivada;
+
+    // === HISTÓRICO SOB DEMANDA ===
+    // A inicialização lê só a última linha de movimentos.txt (próximo ID);
+    // o restante é lido por carregarHistorico() na primeira consulta
+    mutable bool historicoCarregado;
+
+    // Maior ID em movimentos.txt na inicialização: a carga sob demanda lê até
+    // ele (movimentos posteriores já estão em memória)
+    int ultimoMovimentoEmDisco;
+
+    // Gravação de movimentos.txt (somente acréscimo), protegida por mutexGravacao:
+    // maior ID já gravado e se a última linha do arquivo ficou sem quebra
+    mutable std::mutex mutexGravacao;
+    mutable int ultimoMovimentoGravado;
+    mutable bool faltaQuebraLinha;
+
+    // compactarHistorico pede a regravação completa de movimentos.txt
+    // na próxima salvarDados (protegido por mutexEstado)
+    mutable bool regravarMovimentos;
+
+    // Uma compactação por vez (ver compactarHistorico). Ordem das travas:
+    // mutexCompactacao -> mutexGravacao -> mutexEstado -> partições de IDs
+    // (em ordem crescente). Partições de reservas nunca junto com as outras
+    std::mutex mutexCompactacao;
+
+    // === CHECKPOINT + DIÁRIO DOS ITENS ===
+    // Protegidos por mutexGravacao.
+    // Versão de cada item já gravada (checkpoint ou diário): salvarDados
+    // acrescenta ao diário só os itens cuja versão mudou e os removidos
+    mutable std::unordered_map<int, unsigned long> versoesGravadas;
+
+    // Sequência da última entrada do diário e entradas desde o último checkpoint
+    mutable unsigned long long seqDiario;
+    mutable std::size_t entradasDiario;
+
+    // estoque.ckp existe e reflete todas as entradas do diário
+    mutable bool checkpointEmDia;
+
+    // Última linha do diário ficou incompleta (gravação interrompida) e a
+    // carga não conseguiu cortá-la: o próximo acréscimo começa com '\n'
+    mutable bool faltaQuebraDiario;
+
+    // Diário com pelo menos max(itens, este valor) entradas gera checkpoint:
+    // a reaplicação nunca custa mais que a leitura do checkpoint
+    static const std::size_t MIN_ENTRADAS_CHECKPOINT = 1024;
+
+    // Checkpoint automático já enfileirado em tarefasFundo (protegido por mutexGravacao)
+    mutable bool checkpointAgendado;
+
+    // Tarefas de fundo no pool global (checkpoint automático); aguardadas no destrutor
+    mutable GrupoTarefas tarefasFundo;
+
+    // === SALVAMENTO EM SEGUNDO PLANO (fork) ===
+    // Protegidos por mutexGravacao. Enquanto o filho grava, as demais
+    // gravações esperam por ele (mesmos arquivos)
+    mutable int pidSalvamento;                                      // 0 = nenhum em andamento
+    mutable std::shared_ptr<const SnapshotEstoque> snapshotSalvamento; // Imagem gravada pelo filho
+    mutable bool movimentosNoSalvamento;                            // Filho acrescenta a movimentos.txt
+    mutable std::shared_ptr<EpocaHistorico> epocaSalvamento;        // Não nula: filho regrava movimentos.txt
+    mutable std::chrono::steady_clock::time_point inicioSalvamento;
+    mutable StatusSalvamento ultimoSalvamento;
+
+    // Catálogos menores reconstroem os índices e criam os itens sem o pool
+    static const std::size_t MIN_ITENS_INDICES_PARALELOS = 4096;
+    static const std::size_t MIN_ITENS_CARGA_POR_TRECHO = 4096;
+
+    // === DESFAZER / REFAZER ===
+    // Operações recentes com o necessário para invertê-las (buffer circular)
+    LogDesfazer logDesfazer;
+
+    // Época atual do histórico: recebe os movimentos retirados pela próxima
+    // compactação e os libera quando o último snapshot que os vê termina
+    std::shared_ptr<EpocaHistorico> epocaAtual;
+
+    // Observador de todos os itens (IObservadorItem): repassa os eventos
+    // aos alertas e aos índices de texto. Chamados com mutexEstado travado.
+    virtual void minimoCruzado(const Item& item, bool abaixo);
+    virtual void dadosAlterados(const Item& item, const std::string& nomeAnterior,
+                                const std::string& descricaoAnterior);
+
+    /**
+     * Procura item pelo ID sem travar e sem lançar exceção.
+     * Retorna nullptr se não encontrado. Chamadora deve segurar mutexEstado.
+     */
+    Item* localizarItemPorId(int id) const;
+
+    /**
+     * Ranking dos k itens com mais unidades em 'somas' (ID -> unidades de
+     * SAIDA), ignorando itens fora do catálogo. Chamadora deve segurar mutexEstado.
+     */
+    std::vector<PosicaoRanking> rankingSaidas(const std::unordered_map<int, long long>& somas, std::size_t k) const;
+
+    /**
+     * Reconstrói todos os índices a partir da lista de itens.
+     * Chamadora deve segurar mutexEstado.
+     */
+    void reconstruirIndices();
+
+    /**
+     * Coloca um item na lista e em todos os índices (sem alterar a versão).
+     * Chamadora deve segurar mutexEstado.
+     */
+    void inserirItem(Item* item);
+
+    /**
+     * Retira o item da lista e de todos os índices, sem apagar o objeto.
+     * Retorna: o item retirado (a chamadora passa a ser dona)
+     * Lança: EstoqueException se o ID não existe ou se há reservas ativas
+     * Chamadora deve segurar mutexEstado.
+     */
+    Item* retirarItem(int id);
+
+    /**
+     * Aplica a inversa (desfazendo = true) ou reaplica uma operação do log.
+     * Lança: EstoqueException se a operação não puder ser aplicada no estado
+     * atual (o estado não é alterado). Chamadora deve segurar mutexEstado.
+     */
+    void aplicarDesfazivel(OperacaoDesfazivel& operacao, bool desfazendo);
+
+    /**
+     * Corpo de executarTransacao: valida todas as linhas e só então aplica.
+     * inverter = true troca ENTRADA e SAIDA em cada linha (desfazer a transação).
+     * Lança: EstoqueException sem alterar nada (ver executarTransacao).
+     * Chamadora deve segurar mutexEstado.
+     */
+    void aplicarTransacao(const std::vector<LinhaTransacao>& linhas, bool inverter);
+
+    /**
+     * Recopia colunaQuantidades se algum item mudou desde a última cópia.
+     * Chamadora deve segurar mutexEstado.
+     */
+    void atualizarColunaQuantidades();
+
+    /**
+     * Anexa um movimento ao histórico e atualiza os totais de SAIDA.
+     * Único ponto de inserção no histórico. Chamadora deve segurar mutexEstado.
+     */
+    void anexarMovimento(MovimentoEstoque* mov);
+
+    // ENTRADA com a quantidade de cadastro do item (se > 0). Chamadora segura mutexEstado
+    void registrarSaldoInicial(const Item& item);
+
+    /**
+     * Lê de movimentos.txt os movimentos ainda não carregados e os coloca
+     * antes dos anexados desde a inicialização. Só age na primeira chamada.
+     * Chamadora deve segurar mutexEstado.
+     */
+    void carregarHistorico() const;
+
+    /**
+     * Monta (ou reaproveita) o snapshot com o histórico que estiver em memória.
+     * Chamadora deve segurar mutexEstado.
+     */
+    std::shared_ptr<const SnapshotEstoque> montarSnapshot() const;
+
+    /**
+     * Grava itens.txt, estoque.ckp e esvazia o diário.
+     * Chamadora deve segurar mutexGravacao.
+     */
+    void gravarCheckpointTravado(const SnapshotEstoque& snapshot) const;
+
+    // Estado gravado = snapshot; diário vazio (fim de gravarCheckpointTravado)
+    void marcarCheckpointGravado(const SnapshotEstoque& snapshot) const;
+
+    // Diário com max(numItens, MIN_ENTRADAS_CHECKPOINT) entradas ou mais
+    // (requer mutexGravacao ou nenhuma outra thread, como no destrutor)
+    bool diarioNoLimiteCheckpoint(std::size_t numItens) const;
+
+    // Posição do primeiro movimento do snapshot ainda não gravado (0 se regravar)
+    std::size_t inicioNaoGravados(const SnapshotEstoque& snapshot, bool regravar) const;
+
+    /**
+     * Acrescenta a movimentos.txt os movimentos ainda não gravados
+     * (ou regrava o arquivo inteiro). Chamadora deve segurar mutexGravacao.
+     * Retorna: false se o arquivo não pôde ser gravado (erro em cerr)
+     */
+    bool gravarMovimentosTravado(const SnapshotEstoque& snapshot, bool regravar) const;
+
+    /**
+     * Colhe o processo de salvamento em segundo plano, se houver, e incorpora
+     * o que ele gravou. esperar = false: retorna se o filho ainda não terminou.
+     * Chamadora deve segurar mutexGravacao.
+     */
+    void coletarSalvamentoTravado(bool esperar) const;
+
+    // Grava resumo_movimentos.txt (arquivo temporário + rename) com o resumo dado
+    // Não usa estado do Estoque: chamada fora de mutexEstado
+    // Lança: EstoqueException se não conseguir gravar
+    void gravarResumoArquivado(const std::unordered_map<int, ResumoMovimentosItem>& resumo,
+                               int ultimoArquivado, const std::string& corte) const;
+
+    // Lê resumo_movimentos.txt (se existir) e soma as saídas arquivadas em totalSaidasPorItem
+    void carregarResumoArquivado();
+
+    // Itens de um tipo cujo campo específico é 'valor' (ordem de ID)
+    std::vector<Item*> listarPorDetalhe(TipoItem tipo, const std::string& valor);
+
+    // Itens de um tipo agrupados pelo campo específico
+    std::vector<GrupoItens> agruparPorDetalhe(TipoItem tipo);
+
 public:
     /**
      * Construtor do Estoque.
      * Chamado ao iniciar a aplicação.
      * 
      * Comportamento:
-     * - Cria listas vazias (ListaGenerica<Item*>, ListaGenerica<MovimentoEstoque*>)
+     * - Cria listas vazias (ListaGenerica de unique_ptr para itens e movimentos)
      * - Chama carregarDados() para tentar carregar estado anterior
      * - Se arquivos não existem, começa com estoque vazio
      * 
@@ -64,11 +439,13 @@ public:
      * Chamado ao encerrar aplicação.
      * 
      * Comportamento:
-     * - Salva dados atuais em itens.txt e movimentos.txt
-     * - Libera memória alocada dinamicamente:
-     *   * delete cada Item* em itens
-     *   * delete cada MovimentoEstoque* em historico
-     * - Evita memory leaks
+     * - Salva dados atuais (diário e movimentos.txt)
+     * - Espera as tarefas de fundo (inclui o checkpoint automático agendado)
+     * - Grava checkpoint (itens.txt e estoque.ckp) só se o diário ainda
+     *   estiver no limite do automático; diário menor é reaplicado na
+     *   próxima carga mais rápido do que o checkpoint seria gravado
+     * - Itens e movimentos são liberados pelas listas (unique_ptr):
+     *   nenhum delete manual, nenhum memory leak
      * 
      * Requisito POO: destrutor com limpeza de recursos
      */
@@ -82,6 +459,7 @@ public:
      * 
      * Comportamento:
      * - Adiciona item à lista genérica itens
+     * - Quantidade > 0: registra ENTRADA com o saldo inicial no histórico
      * - Não aloca memória (já alocada pela chamadora)
      * - Não valida duplicatas de ID (Item::proximoId garante unicidade)
      * 
@@ -93,6 +471,23 @@ public:
      */
     void adicionarItem(Item* item);
 
+    /**
+     * Adiciona vários itens de uma vez (importação em lote).
+     * 
+     * Parâmetro:
+     *   - novos: ponteiros alocados com new; o Estoque assume a posse
+     *   - registrarSaldos: registra a quantidade de cada item como ENTRADA
+     *     (false só na carga dos arquivos: saldos já estão no histórico)
+     * 
+     * Comportamento:
+     * - Reserva capacidade na lista uma única vez
+     * - Anexa todos os itens (ponteiros nulos são ignorados)
+     * - Reconstrói os índices uma única vez ao final (não por inserção)
+     * 
+     * Exemplo: e.adicionarItens(itensImportados);
+     */
+    void adicionarItens(const std::vector<Item*>& novos, bool registrarSaldos = true);
+
     /**
      * Remove um item do estoque pelo ID.
      * 
@@ -100,13 +495,15 @@ public:
      *   - id: ID único do item a ser removido
      * 
      * Comportamento:
-     * - Procura item com este ID na lista
-     * - Se encontrado: deleta da lista e libera memória (delete)
+     * - Procura item com este ID na lista e o retira da lista e dos índices
+     * - O objeto não é apagado: a posse passa ao log de desfazer
+     *   (desfazer() o devolve ao estoque) e ele é liberado quando sai do log
      * - Se não encontrado: lança EstoqueException
      * 
      * Efeito colateral: movimentos históricos do item permanecem (auditoria)
      * 
-     * Lança: EstoqueException("Item não encontrado") se ID inválido
+     * Lança: EstoqueException("Item não encontrado") se ID inválido ou se o
+     *        item tem reservas ativas
      * 
      * Exemplo: e.removerItem(1);
      */
@@ -151,22 +548,59 @@ public:
     Item* buscarItemPorId(int id);
 
     /**
-     * Busca um item no estoque pelo nome (procura substring/aproximada).
+     * Busca um item no estoque pelo nome exato.
      * 
      * Parâmetro:
-     *   - nome: nome (ou parte do nome) do item a buscar
+     *   - nome: nome completo do item (maiúsculas, acentos e espaços contam)
      * 
      * Retorna: ponteiro para o primeiro Item encontrado com este nome
      * 
-     * Lança: EstoqueException("Item não encontrado") se nome não existe
+     * Lança: EstoqueException("Item não encontrado") se nenhum nome é igual
      * 
-     * Comportamento: busca linear pela lista, compara nomes
+     * Comportamento: busca linear pela lista, compara nomes com ==
+     * Para parte do nome ou erros de digitação, usar
+     * buscarItensPorNomeAproximado (índice de trigramas).
      * 
      * Exemplo:
-     *   Item* item = e.buscarItemPorNome("Aço");
+     *   Item* item = e.buscarItemPorNome("MadeiraAuto");
      */
     Item* buscarItemPorNome(const std::string& nome);
 
+    /**
+     * Busca tolerante a erros de digitação, maiúsculas e acentos.
+     * 
+     * Parâmetros:
+     *   - consulta: nome ou parte do nome (ex: "parafuso m4", "valvula")
+     *   - limite: número máximo de candidatos
+     * 
+     * Retorna: itens do mais parecido para o menos (vazio se nenhum);
+     * aceita até 1 edição a cada 4 caracteres da consulta
+     * 
+     * Usa o índice de trigramas (IndiceTrigramas): custo proporcional às
+     * listas dos trigramas da consulta, não ao tamanho do catálogo.
+     * 
+     * Exemplo:
+     *   std::vector<Item*> c = e.buscarItensPorNomeAproximado("parafsuo m4", 10);
+     */
+    std::vector<Item*> buscarItensPorNomeAproximado(const std::string& consulta, std::size_t limite);
+
+    /**
+     * Busca itens pelas palavras da descrição (índice invertido).
+     * 
+     * Parâmetro:
+     *   - consulta: palavras ligadas por E; grupos separados por OU (ou OR, |)
+     *     Ex: "m8 inox" (as duas), "m8 OU inox" (qualquer uma)
+     * 
+     * Retorna: itens em ordem de ID (vazio se nenhum)
+     * 
+     * Maiúsculas e acentos são ignorados ("aço" encontra "ACO").
+     * Custo proporcional às listas dos termos consultados, não ao catálogo.
+     * 
+     * Exemplo:
+     *   std::vector<Item*> r = e.buscarPorDescricao("m8 OU inox");
+     */
+    std::vector<Item*> buscarPorDescricao(const std::string& consulta);
+
     /**
      * Lista todos os items no estoque com seus detalhes.
      * 
@@ -197,6 +631,66 @@ public:
      */
     void exibirHistorico() const;
 
+    /**
+     * Obtém uma visão consistente e imutável do estoque (snapshot MVCC).
+     *
+     * Comportamento:
+     * - Trava mutexEstado apenas para montar o snapshot
+     * - Na primeira chamada, lê o histórico gravado em movimentos.txt
+     * - Reaproveita o snapshot anterior se nada mudou
+     * - Copia somente os itens cuja versão mudou (copy-on-write)
+     * - Reaproveita blocos selados do histórico (apenas o bloco final é copiado)
+     *
+     * Retorna: shared_ptr que mantém a versão fixada enquanto existir.
+     * O leitor itera sem bloquear registrarEntrada/registrarSaida.
+     *
+     * Exemplo:
+     *   std::shared_ptr<const SnapshotEstoque> s = e.obterSnapshot();
+     *   for (std::size_t i = 0; i < s->getItens().size(); ++i) { ... }
+     */
+    std::shared_ptr<const SnapshotEstoque> obterSnapshot() const;
+
+    /**
+     * Gera o relatório de uso de memória por subsistema.
+     * 
+     * Conteúdo:
+     * - Itens: quantidade, bytes de objetos e strings, tamanhos médios
+     * - Histórico: movimentos, bytes de objetos e strings
+     * - Listas: tamanho x capacidade e folga
+     * - Índices e estados publicados para snapshots
+     * - RSS do processo (Linux)
+     * 
+     * Percorre os objetos vivos sob mutexEstado: O(itens + movimentos).
+     * 
+     * Exemplo: e.gerarRelatorioMemoria().imprimir(std::cout);
+     */
+    RelatorioMemoria gerarRelatorioMemoria() const;
+
+    /**
+     * Acessa os histogramas de latência das operações públicas.
+     * 
+     * Operações medidas: adicionarItem, removerItem, buscarItemPorId,
+     * buscarItemPorNome, buscarItensPorNomeAproximado, buscarPorDescricao,
+     * registrarEntrada, registrarSaida,
+     * salvarDados, carregarDados, carregarHistorico (primeira consulta ao
+     * histórico), reservar, confirmarReserva, liberarReserva, expirarReservas,
+     * executarTransacao.
+     * A medição inclui a espera pela trava (latência vista pela chamadora).
+     * 
+     * Compilar com -DESTOQUE_SEM_METRICAS remove a instrumentação
+     * (os histogramas ficam vazios).
+     * 
+     * Exemplo:
+     *   e.obterMetricas().histograma(OP_REGISTRAR_SAIDA).percentil(99.9);
+     *   e.obterMetricas().imprimir(std::cout);
+     */
+    const MetricasEstoque& obterMetricas() const;
+
+    /**
+     * Zera os histogramas de latência (início de nova janela de medição).
+     */
+    void zerarMetricas();
+
     /**
      * Registra uma ENTRADA de items no estoque (recebimento/compra).
      * Aumenta quantidade e gera movimento no histórico.
@@ -238,18 +732,298 @@ public:
      */
     void registrarSaida(int idItem, int qtd);
 
+    /**
+     * Reserva quantidade de um item para um pedido, sem retirá-la do estoque.
+     * 
+     * Parâmetros:
+     *   - idItem: ID do item
+     *   - qtd: quantidade a reservar
+     * 
+     * Comportamento:
+     * - Move qtd da parte disponível para a reservada com compare-and-swap
+     *   sobre o saldo do Item: verificar e reservar é uma única operação
+     *   atômica (sem a corrida entre getQuantidade() e registrarSaida())
+     * - Busca e CAS sob a trava da partição do índice de IDs, sem
+     *   mutexEstado: reservas não esperam entradas, saídas, edições nem
+     *   snapshots (removerItem e transações seguram a mesma partição)
+     * - Registra a reserva na tabela de reservas ativas (partição do ID
+     *   da reserva), com o Item* fixado até a confirmação ou liberação
+     * - Não gera movimento: a SAIDA só é registrada na confirmação
+     * 
+     * Retorna: ID da reserva (usado em confirmarReserva/liberarReserva)
+     * 
+     * Lança: EstoqueException se ID inválido, qtd <= 0 ou disponível insuficiente
+     * 
+     * Exemplo:
+     *   int r = e.reservar(1, 5);
+     *   e.confirmarReserva(r);   // SAIDA de 5 unidades do item 1
+     */
+    int reservar(int idItem, int qtd);
+
+    /**
+     * Confirma uma reserva: a quantidade reservada sai do estoque
+     * e é registrada como movimento SAIDA.
+     * 
+     * Como toda movimentação, entra no histórico (e nos alertas) sob
+     * mutexEstado, serializada com registrarEntrada/registrarSaida.
+     * Entra no log de desfazer como uma SAIDA: desfazer() devolve as
+     * unidades ao disponível, sem recriar a reserva.
+     * 
+     * Lança: EstoqueException se a reserva não existe (já confirmada, liberada ou expirada)
+     */
+    void confirmarReserva(int idReserva);
+
+    /**
+     * Cancela uma reserva: a quantidade volta a ficar disponível.
+     * Não gera movimento nem usa mutexEstado (CAS no Item fixado pela reserva).
+     * 
+     * Lança: EstoqueException se a reserva não existe
+     */
+    void liberarReserva(int idReserva);
+
+    /**
+     * Libera em lote as reservas criadas há mais de idadeMaxima.
+     * Uma passagem por partição sob a trava dela; os saldos são devolvidos
+     * depois, por CAS nos Itens fixados (sem mutexEstado).
+     * 
+     * Retorna: número de reservas liberadas
+     * Lança: EstoqueException se idadeMaxima for negativa
+     * 
+     * Exemplo: e.expirarReservas(std::chrono::minutes(15));
+     */
+    std::size_t expirarReservas(std::chrono::steady_clock::duration idadeMaxima);
+
+    /**
+     * Aplica todos os movimentos de uma transação, ou nenhum.
+     * 
+     * Processo (uma única seção crítica, proporcional ao tamanho da transação):
+     * 1. Localiza todos os itens e soma entradas/saídas por item
+     * 2. Valida tudo antes de alterar qualquer item: cada item precisa ter
+     *    disponível (fora das reservas) + entradas >= saídas. As partições
+     *    de IDs dos itens ficam travadas da validação até a aplicação:
+     *    reservar() não consome o disponível já validado
+     * 3. Aplica um compare-and-swap de entrada e um de saída por item
+     *    (já validados: não falham)
+     * 4. Registra um movimento por linha, na ordem da transação
+     * 
+     * Validação pelo saldo líquido: SAIDA e ENTRADA do mesmo item na mesma
+     * transação se compensam, independentemente da ordem das linhas.
+     * A transação entra no log de desfazer como um único registro:
+     * desfazer() inverte todas as linhas juntas, com a mesma validação.
+     * 
+     * Lança: EstoqueException se algum item não existe, se o disponível não
+     *        cobre as saídas ou se a quantidade ultrapassaria o limite de int
+     *        (nenhum movimento é aplicado)
+     * 
+     * Exemplo:
+     *   TransacaoEstoque kit;
+     *   kit.saida(2, 1).saida(5, 4);
+     *   e.executarTransacao(kit);
+     */
+    void executarTransacao(const TransacaoEstoque& transacao);
+
+    /**
+     * Número de reservas ativas.
+     */
+    std::size_t reservasAtivas() const;
+
+    /**
+     * Define o estoque mínimo (ponto de reposição) de um item.
+     * 
+     * Parâmetros:
+     *   - idItem: ID do item
+     *   - minimo: quantidade mínima; 0 desativa o alerta
+     * 
+     * Comportamento:
+     * - Gravado como campo opcional MIN ao fim da linha do item em itens.txt
+     * - Se a situação do item mudar (abaixo/normal), os callbacks são chamados
+     * 
+     * Lança: EstoqueException se ID inválido ou minimo < 0
+     */
+    void definirMinimo(int idItem, int minimo);
+
+    /**
+     * Itens com quantidade abaixo do estoque mínimo, em ordem de ID.
+     * 
+     * Lê o índice mantido pelos próprios itens (AlertasEstoque):
+     * O(k) para k itens baixos, sem varrer o catálogo.
+     * 
+     * Exemplo:
+     *   std::vector<Item*> baixos = e.listarEstoqueBaixo();
+     */
+    std::vector<Item*> listarEstoqueBaixo();
+
+    /**
+     * Registra um callback chamado sempre que um item cruza o mínimo
+     * (fica abaixo ou volta ao normal), em qualquer operação que altere quantidade.
+     * 
+     * O callback roda com a trava do Estoque segurada: deve ser rápido
+     * e não pode chamar métodos do Estoque.
+     * 
+     * Exemplo:
+     *   e.adicionarAlertaEstoqueBaixo([](const AlertaEstoqueBaixo& a) {
+     *       if (a.abaixo) std::cout << "Repor " << a.nome << std::endl;
+     *   });
+     */
+    void adicionarAlertaEstoqueBaixo(const CallbackEstoqueBaixo& callback);
+
+    /**
+     * Produtos de uma categoria, em ordem de ID.
+     * 
+     * Parâmetro:
+     *   - categoria: comparada sem diferenciar maiúsculas, acentos e pontuação
+     * 
+     * Comportamento:
+     *   - Consulta o índice secundário categoria -> itens: O(k) para k
+     *     produtos da categoria, sem varrer o catálogo
+     *   - Categoria inexistente retorna vetor vazio
+     * 
+     * Exemplo:
+     *   std::vector<Item*> ferragens = e.listarPorCategoria("Ferragens");
+     */
+    std::vector<Item*> listarPorCategoria(const std::string& categoria);
+
+    /**
+     * Matérias-primas de um fornecedor, em ordem de ID.
+     * Mesmo comportamento de listarPorCategoria, sobre o índice de fornecedores.
+     * 
+     * Exemplo:
+     *   std::vector<Item*> doFornecedor = e.listarPorFornecedor("Madeireira Sul");
+     */
+    std::vector<Item*> listarPorFornecedor(const std::string& fornecedor);
+
+    /**
+     * Todos os produtos agrupados por categoria (grupos em ordem alfabética,
+     * itens de cada grupo em ordem de ID).
+     * 
+     * Exemplo:
+     *   std::vector<GrupoItens> grupos = e.agruparPorCategoria();
+     *   for (const GrupoItens& g : grupos)
+     *       std::cout << g.nome << ": " << g.itens.size() << std::endl;
+     */
+    std::vector<GrupoItens> agruparPorCategoria();
+
+    /**
+     * Todas as matérias-primas agrupadas por fornecedor.
+     * Mesma ordenação de agruparPorCategoria.
+     */
+    std::vector<GrupoItens> agruparPorFornecedor();
+
+    /**
+     * Os k itens com maior quantidade em estoque, da maior para a menor.
+     * 
+     * Comportamento:
+     *   - Copia (quantidade, ID) de todos os itens para um vetor contíguo e
+     *     seleciona com std::partial_sort: O(n log k), sem ordenar o catálogo
+     *   - Empate: menor ID primeiro
+     *   - k maior que o número de itens retorna todos
+     * 
+     * Exemplo:
+     *   std::vector<PosicaoRanking> top = e.maioresQuantidades(50);
+     *   // top[0].item->getNome(), top[0].valor
+     */
+    std::vector<PosicaoRanking> maioresQuantidades(std::size_t k);
+
+    /**
+     * Os k itens com menor quantidade em estoque, da menor para a maior.
+     * Mesmo método de seleção de maioresQuantidades.
+     */
+    std::vector<PosicaoRanking> menoresQuantidades(std::size_t k);
+
+    /**
+     * Os k itens com maior volume de SAIDA (unidades), do maior para o menor.
+     * 
+     * Parâmetros:
+     *   - k: tamanho do ranking
+     *   - dias: janela em dias até agora; 0 = todo o histórico
+     * 
+     * Comportamento:
+     *   - dias == 0: usa os totais por item mantidos a cada SAIDA (O(m log k),
+     *     m = itens que já tiveram saída), sem percorrer o histórico
+     *   - dias > 0: percorre o histórico do fim para o início e para no primeiro
+     *     movimento anterior à janela (o histórico está em ordem de data)
+     *   - Janela que começa antes do corte da última compactação: soma também
+     *     as SAIDAs de movimentos_arquivo.txt dentro da janela (leitura do
+     *     arquivo, fora de mutexEstado, proporcional ao arquivo morto)
+     *   - Itens já removidos do catálogo não aparecem
+     * 
+     * Lança: EstoqueException se dias < 0 ou se a janela precisa do arquivo
+     *        morto e ele não pode ser aberto
+     * 
+     * Exemplo:
+     *   std::vector<PosicaoRanking> giro = e.maioresSaidas(50, 30);  // últimos 30 dias
+     */
+    std::vector<PosicaoRanking> maioresSaidas(std::size_t k, int dias = 0);
+
+    /**
+     * Agregados das quantidades em estoque (painéis de valorização).
+     * 
+     * Parâmetro:
+     *   - limite: conta os itens com quantidade < limite
+     * 
+     * Comportamento:
+     *   - Soma, mínimo, máximo e contagem em uma passada sobre a coluna
+     *     contígua de quantidades (AVX2 / SSE4.1 / escalar, ver DeteccaoCPU.h)
+     *   - A coluna só é recopiada dos itens se o estoque mudou desde a última consulta
+     * 
+     * Exemplo:
+     *   AgregadosQuantidade a = e.agregarQuantidades(10);
+     *   // a.soma, a.minimo, a.maximo, a.abaixoDoLimite
+     */
+    AgregadosQuantidade agregarQuantidades(int limite = 0);
+
+    /**
+     * Histograma das quantidades em faixas.
+     * 
+     * Parâmetro:
+     *   - limites: em ordem estritamente crescente, até MAX_LIMITES_FAIXAS
+     * 
+     * Retorna: limites.size() + 1 contagens: [0] = quantidade < limites[0],
+     *          [i] = limites[i-1] <= quantidade < limites[i], [último] = >= último limite
+     * 
+     * Lança: EstoqueException se limites vazio, fora de ordem ou acima do máximo
+     * 
+     * Exemplo:
+     *   std::vector<std::size_t> f = e.contarPorFaixaDeQuantidade({10, 100, 1000});
+     */
+    std::vector<std::size_t> contarPorFaixaDeQuantidade(const std::vector<int>& limites);
+
+    /**
+     * Número de movimentos e unidades por TipoMovimento em todo o histórico em memória
+     * (movimentos arquivados por compactarHistorico não entram).
+     * 
+     * Percorre as colunas de quantidade e tipo paralelas ao histórico com os
+     * kernels vetoriais; carrega o histórico gravado na primeira chamada.
+     * 
+     * Exemplo:
+     *   TotaisMovimentos t = e.totalizarMovimentos();
+     *   long long saldo = t.quantidadeEntradas - t.quantidadeSaidas;
+     */
+    TotaisMovimentos totalizarMovimentos();
+
     /**
      * Salva todos os dados (items e movimentos) em arquivos de texto.
-     * Chamado no destrutor ou manualmente para checkpoint.
+     * Chamado no destrutor ou manualmente (SAVE do servidor).
      * 
      * Processo:
-     * 1. Abre ARQUIVO_ITENS em modo escrita
-     * 2. Para cada item: escreve TYPE;ID;NAME;DESC;QTY;LINK;DETAIL
-     * 3. Abre ARQUIVO_MOVIMENTOS em modo escrita
-     * 4. Para cada movimento: escreve ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
+     * 1. Compara a versão de cada item do snapshot com a última gravada
+     * 2. Abre ARQUIVO_DIARIO em modo acréscimo e escreve, com sequência crescente:
+     *    SEQ;ITEM;TYPE;ID;NAME;DESC;QTY;LINK;DETAIL[;MIN] por item alterado
+     *    SEQ;REMOVER;ID por item removido desde a última gravação
+     * 3. Abre ARQUIVO_MOVIMENTOS em modo acréscimo
+     * 4. Para cada movimento ainda não gravado: escreve ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
+     *    (após compactarHistorico o arquivo é regravado por inteiro)
+     * 
+     * Itens: não regrava itens.txt nem estoque.ckp (ver gravarCheckpoint).
+     * Quando o diário alcança max(itens, MIN_ENTRADAS_CHECKPOINT) entradas,
+     * agenda um checkpoint em fundo no pool global;
+     * ele é descartado se o diário receber novas entradas antes de rodar.
+     * 
+     * Não carrega o histórico: o custo é proporcional aos movimentos novos
      * 
      * Serialização:
-     * - getTipo() retorna "PRODUTO" ou "MATERIA"
+     * - etiqueta TipoItem convertida por nomeTipoItem() (tag do RegistroTiposItem)
+     *   (despacho por etiqueta, sem chamada virtual nem alocação por item)
      * - Todos campos convertidos para string
      * - Semicolon (;) como separador
      * 
@@ -261,25 +1035,171 @@ public:
      */
     void salvarDados() const;
 
+    /**
+     * Grava o estado completo dos itens e esvazia o diário.
+     * Chamado pelo destrutor, por salvarDados quando o diário cresce e
+     * manualmente (comando CHECKPOINT do servidor).
+     * 
+     * Processo:
+     * 1. itens.txt (texto, para leitura humana e verificar_integridade)
+     * 2. estoque.ckp (binário, arquivo temporário + rename) com a sequência
+     *    da última entrada do diário
+     * 3. Esvazia diario_itens.txt
+     * Interrupção entre 2 e 3: a carga ignora as entradas com sequência
+     * já contida no checkpoint.
+     * 
+     * Sem alterações desde o último checkpoint: não grava nada.
+     * 
+     * Lança: EstoqueException se o checkpoint não puder ser gravado
+     *        (o diário é mantido e a recuperação continua possível)
+     * 
+     * Exemplo: e.gravarCheckpoint();
+     */
+    void gravarCheckpoint() const;
+
+    /**
+     * Salvamento em segundo plano (BGSAVE): cria um processo filho (fork)
+     * que grava a imagem copy-on-write do estoque enquanto este processo
+     * continua atendendo.
+     * 
+     * Processo:
+     * 1. Monta o snapshot (trava só o tempo de publicá-lo)
+     * 2. Reserva um buffer de 64 KiB para o filho: o custo no pai não
+     *    depende do tamanho do catálogo nem do histórico
+     * 3. fork(): o filho herda o snapshot sem cópia (copy-on-write)
+     * 4. Filho: serializa itens.txt + estoque.ckp (CheckpointEstoque::serializar)
+     *    + diário vazio (checkpoint completo) e os movimentos não gravados,
+     *    bloco a bloco pelo buffer (SaidaDescritor); sai com 0 (sucesso),
+     *    1 (checkpoint) ou 2 (movimentos)
+     * 5. Pai: retorna o PID; o fim do filho é percebido por
+     *    consultarSalvamentoEmSegundoPlano ou pela próxima gravação
+     * 
+     * O filho de um processo com várias threads só pode usar funções
+     * async-signal-safe: ele só lê o snapshot, formata no buffer reservado e
+     * chama open/write/close/rename/_exit (sem malloc, iostream, travas,
+     * pool nem destrutores).
+     * Gravações do pai (salvarDados, gravarCheckpoint, checkpoint automático)
+     * esperam o filho terminar.
+     * 
+     * Retorna: PID do processo filho
+     * Lança: EstoqueException se já houver um em andamento ou fork falhar
+     * 
+     * Exemplo:
+     *   e.salvarEmSegundoPlano();
+     *   ...
+     *   if (e.consultarSalvamentoEmSegundoPlano().situacao == SALVAMENTO_CONCLUIDO) { ... }
+     */
+    int salvarEmSegundoPlano() const;
+
+    /**
+     * Situação do último salvamento em segundo plano, sem bloquear pelo
+     * filho (waitpid com WNOHANG). Terminado com sucesso: o estado gravado
+     * passa a valer para os próximos salvarDados.
+     */
+    StatusSalvamento consultarSalvamentoEmSegundoPlano() const;
+
+    /**
+     * Checkpoint: arquiva os movimentos antigos e mantém em memória apenas os recentes.
+     * 
+     * Parâmetro:
+     *   - diasMantidos: movimentos dos últimos diasMantidos dias continuam no
+     *     histórico; 0 arquiva todos
+     * 
+     * Processo:
+     * 1. Sob mutexEstado, só coleta o prefixo anterior ao corte
+     * 2. Fora da trava, acrescenta-o em movimentos_arquivo.txt (sem repetir
+     *    linhas já gravadas por uma tentativa interrompida), soma-o no resumo
+     *    por item (entradas, saídas, quantidade de movimentos) e regrava
+     *    resumo_movimentos.txt
+     * 3. Sob mutexEstado de novo, retira-o do histórico; a memória é liberada
+     *    quando nenhum snapshot gerado antes da compactação existir mais (EpocaHistorico)
+     * 4. Salva os dados (salvarDados) e regrava movimentos.txt só com os recentes
+     * 
+     * A carga seguinte lê apenas os movimentos recentes e o resumo: tempo de
+     * inicialização e memória não crescem com os anos de histórico.
+     * Rankings (maioresSaidas) continuam contando as saídas arquivadas: todo o
+     * período pelos totais, janelas anteriores ao corte pelo arquivo morto.
+     * 
+     * Retorna: quantidade de movimentos arquivados
+     * Lança: EstoqueException se diasMantidos < 0 ou se o arquivo não puder ser gravado
+     *        (nesse caso o histórico em memória não é alterado)
+     * 
+     * Exemplo:
+     *   std::size_t n = e.compactarHistorico(90);  // mantém os últimos 90 dias
+     */
+    std::size_t compactarHistorico(int diasMantidos);
+
+    /**
+     * Desfaz a operação mais recente ainda não desfeita.
+     * 
+     * Operações registradas: adicionarItem, removerItem, editarItem,
+     * registrarEntrada, registrarSaida, confirmarReserva (como SAIDA), definirMinimo
+     * e executarTransacao (as últimas LogDesfazer::CAPACIDADE). Cargas em lote
+     * (adicionarItens, importação), reservar e liberarReserva não entram no log.
+     * 
+     * Comportamento (O(1) por passo, sem cópia de estado):
+     *   - removerItem: o item removido não é apagado; volta ao estoque com o mesmo ID
+     *   - adicionarItem: o item sai do estoque (guardado para refazer)
+     *   - editarItem / definirMinimo: restaura os valores anteriores
+     *   - registrarEntrada / registrarSaida: registra o movimento inverso
+     *     (o histórico é auditoria: nada é apagado dele)
+     *   - executarTransacao: o inverso de cada linha, tudo ou nada
+     * 
+     * Retorna: false se não há o que desfazer
+     * Lança: EstoqueException se a inversa não for possível agora
+     *        (ex: desfazer uma ENTRADA cujo saldo já foi consumido)
+     * 
+     * Exemplo:
+     *   e.registrarSaida(2, 50);  // engano
+     *   e.desfazer();             // quantidade volta; histórico: SAIDA 50, ENTRADA 50
+     */
+    bool desfazer();
+
+    /**
+     * Refaz a operação desfeita mais recente.
+     * Qualquer nova operação registrada descarta o que podia ser refeito.
+     * 
+     * Retorna: false se não há o que refazer
+     * Lança: EstoqueException se a operação não puder ser reaplicada agora
+     */
+    bool refazer();
+
+    /**
+     * Descrição da próxima operação a desfazer / refazer ("" se não houver).
+     * Exemplo: "SAIDA de 5 do item 2"
+     */
+    std::string descreverProximoDesfazer();
+    std::string descreverProximoRefazer();
+
     /**
      * Carrega todos os dados (items e movimentos) dos arquivos de texto.
      * Chamado no construtor ao iniciar aplicação.
      * 
-     * Processo itens.txt:
+     * Processo estoque.ckp + diario_itens.txt (recuperação rápida):
+     * 1. Lê o checkpoint binário (um read, FNV conferido); se ausente ou
+     *    inválido, lê itens.txt como abaixo
+     * 2. Reaplica as entradas do diário com sequência maior que a do checkpoint
+     * 3. Cria os itens restantes: o tempo depende das alterações desde o
+     *    último checkpoint, não do volume de texto acumulado
+     * 
+     * Processo itens.txt (sem checkpoint):
      * 1. Abre ARQUIVO_ITENS
-     * 2. Para cada linha: lê TYPE;ID;NAME;DESC;QTY;LINK;DETAIL
-     * 3. Se TYPE=="PRODUTO": cria new ItemProduto(...) com detail como categoria
-     * 4. Se TYPE=="MATERIA": cria new ItemMateria(...) com detail como fornecedor
+     * 2. Para cada linha: lê TYPE;ID;NAME;DESC;QTY;LINK;DETAIL[;MIN] (MIN opcional)
+     * 3. Localiza TYPE no registro de tipos (RegistroTiposItem.h); tags desconhecidas são ignoradas
+     * 4. Cria o item pelo descritor do tipo, preservando o ID gravado
      * 5. Chama Item::setProximoId() para continuar IDs
      * 6. Adiciona à lista itens
      * 
+     * Processo resumo_movimentos.txt (se existir, ver compactarHistorico):
+     * 1. Lê o último ID arquivado e os totais por item
+     * 2. Soma as saídas arquivadas nos totais dos rankings
+     * 
      * Processo movimentos.txt:
-     * 1. Abre ARQUIVO_MOVIMENTOS
-     * 2. Para cada linha: lê ID;DATA;TIPO;QTY;IDITEM;NOMEITEM
-     * 3. Converte TIPO ("ENTRADA"/"SAIDA") para enum TipoMovimento
-     * 4. Cria new MovimentoEstoque(...) com construtor de carregamento
-     * 5. Chama MovimentoEstoque::setProximoId() para continuar IDs
-     * 6. Adiciona à lista historico
+     * 1. Lê apenas o fim do arquivo: ID da última linha válida
+     * 2. Chama MovimentoEstoque::setProximoId() para continuar IDs
+     * 3. O restante fica para carregarHistorico(), na primeira consulta ao
+     *    histórico: a inicialização não depende do tamanho do histórico
+     *    (IDs crescem ao longo do arquivo: a última linha tem o maior)
      * 
      * Tratamento de erro:
      * - Se arquivo não existe: cria estoque vazio (primeira execução)
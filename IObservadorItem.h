@@ -0,0 +1,42 @@
+#ifndef IOBSERVADORITEM_H
+#define IOBSERVADORITEM_H
+
+#include <string>
+
+class Item;
+
+/**
+ * Interface para quem acompanha mudanças de um Item sem varrer o estoque.
+ * O Item chama o observador apenas nos eventos relevantes; no caminho
+ * comum (nenhum limite cruzado) o custo é uma comparação.
+ *
+ * Chamado de dentro das operações do Estoque, com mutexEstado travado:
+ * implementações não devem chamar métodos públicos do Estoque.
+ */
+class IObservadorItem {
+public:
+    virtual ~IObservadorItem() {}
+
+    /**
+     * A quantidade do item cruzou o estoque mínimo.
+     * Parâmetros:
+     *   - item: item alterado (quantidade já atualizada)
+     *   - abaixo: true se passou a ficar abaixo do mínimo, false se voltou ao normal
+     */
+    virtual void minimoCruzado(const Item& item, bool abaixo) = 0;
+
+    /**
+     * Nome, descrição ou link do item mudaram (Item::atualizarDados).
+     * Parâmetros:
+     *   - item: item já com os novos dados
+     *   - nomeAnterior, descricaoAnterior: textos antes da alteração
+     *     (índices de texto retiram os termos antigos sem guardar cópia)
+     * Padrão: ignora.
+     */
+    virtual void dadosAlterados(const Item& item, const std::string& nomeAnterior,
+                                const std::string& descricaoAnterior) {
+        (void)item; (void)nomeAnterior; (void)descricaoAnterior;
+    }
+};
+
+#endif // IOBSERVADORITEM_H
@@ -0,0 +1,198 @@
+// ImportadorCSV.cpp - Importação em lote de catálogos CSV para o Estoque
+#include "ImportadorCSV.h"
+#include "EstoqueException.h"
+#include "RegistroTiposItem.h"
+#include "PoolTarefas.h"
+
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <cctype>
+#include <strings.h> // strncasecmp (POSIX)
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+
+using std::string;
+using std::vector;
+using std::size_t;
+
+// Linha do CSV já validada e convertida (ou rejeitada)
+struct LinhaCSV {
+    size_t numero;          // Número da linha no arquivo (1-based)
+    bool valida;
+    string motivo;          // Preenchido se inválida
+    const DescritorTipoItem* tipo;  // Tipo registrado (fábrica do item)
+    CamposItem campos;              // ID atribuído na etapa de criação
+};
+
+// Separa uma linha CSV em campos (RFC 4180 simplificado: aspas e "" como escape)
+// Retorna false se houver aspas não fechadas
+static bool separarCSV(const char* inicio, const char* fim, vector<string>& campos) {
+    campos.clear();
+    string atual;
+    bool entreAspas = false;
+    for (const char* p = inicio; p < fim; ++p) {
+        char c = *p;
+        if (entreAspas) {
+            if (c == '"') {
+                if (p + 1 < fim && p[1] == '"') { atual += '"'; ++p; }  // "" -> "
+                else entreAspas = false;
+            } else {
+                atual += c;
+            }
+        } else if (c == '"') {
+            entreAspas = true;
+        } else if (c == ',') {
+            campos.push_back(atual);
+            atual.clear();
+        } else {
+            atual += c;
+        }
+    }
+    campos.push_back(atual);
+    return !entreAspas;
+}
+
+// Valida e converte uma linha; em caso de erro preenche 'motivo'
+static void converterLinha(const char* inicio, const char* fim, LinhaCSV& saida) {
+    vector<string> campos;
+    saida.valida = false;
+    if (!separarCSV(inicio, fim, campos)) {
+        saida.motivo = "aspas nao fechadas";
+        return;
+    }
+    if (campos.size() != 6) {
+        saida.motivo = "esperados 6 campos, encontrados " + std::to_string(campos.size());
+        return;
+    }
+    // ';' é o separador de itens.txt: aceitar corromperia o arquivo salvo
+    for (size_t i = 0; i < campos.size(); ++i) {
+        if (campos[i].find(';') != string::npos) {
+            saida.motivo = "campo " + std::to_string(i + 1) + " contem ';'";
+            return;
+        }
+    }
+
+    string tipo = campos[0];
+    for (size_t i = 0; i < tipo.size(); ++i) tipo[i] = static_cast<char>(toupper(static_cast<unsigned char>(tipo[i])));
+    saida.tipo = localizarTipo(tipo.data(), tipo.size());
+    if (!saida.tipo) {
+        saida.motivo = "tipo desconhecido '" + campos[0] + "'";
+        return;
+    }
+    if (campos[1].empty()) { saida.motivo = "nome vazio"; return; }
+    if (campos[5].empty()) { saida.motivo = string("campo ") + saida.tipo->rotuloDetalhe + " vazio"; return; }
+
+    // strtol em vez de stoi: sem exceções no caminho quente
+    errno = 0;
+    char* resto = nullptr;
+    long qtd = std::strtol(campos[3].c_str(), &resto, 10);
+    if (campos[3].empty() || *resto != '\0' || errno == ERANGE || qtd < 0 || qtd > INT_MAX) {
+        saida.motivo = "quantidade invalida '" + campos[3] + "'";
+        return;
+    }
+
+    saida.campos.nome = campos[1];
+    saida.campos.descricao = campos[2];
+    saida.campos.quantidade = static_cast<int>(qtd);
+    saida.campos.link = campos[4].empty() ? "http://google.com/search?q=\"" + campos[1] + "\"" : campos[4];
+    saida.campos.detalhe = campos[5];
+    saida.valida = true;
+}
+
+// Construtor: guarda o Estoque de destino e o número de threads
+ImportadorCSV::ImportadorCSV(Estoque& estoque, unsigned numThreads)
+    : estoque(estoque), numThreads(numThreads) {
+}
+
+// Importa o CSV (ver descrição do processo em ImportadorCSV.h)
+ResultadoImportacao ImportadorCSV::importar(const string& caminho) {
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    // 1. Lê o arquivo inteiro de uma vez
+    std::ifstream arq(caminho.c_str(), std::ios::binary);
+    if (!arq.is_open()) {
+        throw EstoqueException("Nao foi possivel abrir o arquivo " + caminho + " para importar.");
+    }
+    std::ostringstream conteudoStream;
+    conteudoStream << arq.rdbuf();
+    const string conteudo = conteudoStream.str();
+
+    // Localiza as linhas [inicio, fim) ignorando vazias, '\r' final e cabeçalho
+    vector<std::pair<const char*, const char*> > intervalos;
+    vector<size_t> numeros;
+    const char* p = conteudo.data();
+    const char* fimArquivo = p + conteudo.size();
+    size_t numero = 0;
+    while (p < fimArquivo) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', fimArquivo - p));
+        const char* fimLinha = nl ? nl : fimArquivo;
+        ++numero;
+        const char* fimUtil = (fimLinha > p && fimLinha[-1] == '\r') ? fimLinha - 1 : fimLinha;
+        bool cabecalho = (numero == 1 && fimUtil - p >= 4 && strncasecmp(p, "tipo", 4) == 0);
+        if (fimUtil > p && !cabecalho) {
+            intervalos.push_back(std::make_pair(p, fimUtil));
+            numeros.push_back(numero);
+        }
+        p = fimLinha + 1;
+    }
+
+    // 2. Parse em paralelo: cada trecho contíguo de linhas é uma tarefa do pool
+    const size_t total = intervalos.size();
+    vector<LinhaCSV> linhas(total);
+    PoolTarefas& pool = PoolTarefas::global();
+    unsigned threads = pool.trechosPara(total, 1024, numThreads);  // Lotes pequenos: menos trechos
+
+    vector<size_t> limites(threads + 1);
+    for (unsigned t = 0; t <= threads; ++t) limites[t] = total * t / threads;
+
+    pool.paraCadaTrecho(total, threads, [&](unsigned, size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; ++i) {
+            linhas[i].numero = numeros[i];
+            converterLinha(intervalos[i].first, intervalos[i].second, linhas[i]);
+        }
+    });
+
+    // Contagem de válidas por trecho (define o deslocamento de ID de cada thread)
+    vector<size_t> validasAntes(threads + 1, 0);
+    ResultadoImportacao resultado;
+    resultado.linhasLidas = total;
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t validas = 0;
+        for (size_t i = limites[t]; i < limites[t + 1]; ++i) {
+            if (linhas[i].valida) {
+                ++validas;
+            } else {
+                ErroImportacao erro = { linhas[i].numero, linhas[i].motivo };
+                resultado.rejeitadas.push_back(erro);
+            }
+        }
+        validasAntes[t + 1] = validasAntes[t] + validas;
+    }
+    const size_t totalValidas = validasAntes[threads];
+
+    // 3. Reserva o bloco de IDs [base, base + totalValidas)
+    const int base = Item::getProximoId();
+    Item::setProximoId(base + static_cast<int>(totalValidas));
+
+    // 4. Cria os itens em paralelo, cada trecho com sua parte do bloco de IDs
+    vector<Item*> novos(totalValidas, nullptr);
+    pool.paraCadaTrecho(total, threads, [&](unsigned t, size_t inicio, size_t fim) {
+        size_t destino = validasAntes[t];
+        for (size_t i = inicio; i < fim; ++i) {
+            LinhaCSV& l = linhas[i];
+            if (!l.valida) continue;
+            l.campos.id = base + static_cast<int>(destino);
+            novos[destino++] = l.tipo->criar(l.campos);
+        }
+    });
+
+    // 5. Inserção em lote: uma reserva e uma reconstrução de índices
+    estoque.adicionarItens(novos);
+    resultado.itensImportados = totalValidas;
+
+    resultado.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return resultado;
+}
@@ -0,0 +1,76 @@
+#ifndef IMPORTADORCSV_H
+#define IMPORTADORCSV_H
+
+#include "Estoque.h"
+#include <string>
+#include <vector>
+
+/**
+ * Linha rejeitada durante a importação (a importação continua).
+ */
+struct ErroImportacao {
+    std::size_t linha;      // Número da linha no arquivo (1-based)
+    std::string motivo;     // Descrição do problema
+};
+
+/**
+ * Resultado de uma importação: contadores, rejeições e desempenho.
+ */
+struct ResultadoImportacao {
+    std::size_t linhasLidas;                  // Linhas de dados (sem cabeçalho e linhas vazias)
+    std::size_t itensImportados;              // Itens efetivamente adicionados ao Estoque
+    std::vector<ErroImportacao> rejeitadas;   // Linhas inválidas com o motivo
+    double segundos;                          // Tempo total (leitura + parse + inserção)
+
+    // Linhas processadas por segundo (0 se tempo desprezível)
+    double linhasPorSegundo() const {
+        return segundos > 0.0 ? linhasLidas / segundos : 0.0;
+    }
+};
+
+/**
+ * Importador de catálogos CSV em lote.
+ *
+ * Formato (vírgula como separador, aspas duplas opcionais, "" escapa aspas):
+ *   tipo,nome,descricao,quantidade,link,detalhe
+ *   PRODUTO,Parafuso M8,"Parafuso sextavado, inox",100,http://...,Ferragens
+ *   MATERIA,Aco 1020,Barra redonda,50,,Metalurgica XYZ
+ * - Cabeçalho opcional (primeira linha começando com "tipo")
+ * - tipo: tag registrada em RegistroTiposItem.h, ex: PRODUTO ou MATERIA (maiúsculas ou minúsculas)
+ * - detalhe: categoria (produto) ou fornecedor (materia)
+ * - link vazio: gera busca no Google, como no menu
+ *
+ * Processo:
+ * 1. Lê o arquivo inteiro e localiza o início de cada linha
+ * 2. Divide as linhas em trechos (tarefas do pool global, PoolTarefas.h);
+ *    cada trecho é validado e convertido em paralelo
+ * 3. Reserva um bloco de IDs contíguo via Item::getProximoId/setProximoId
+ * 4. Cria os itens (em paralelo) com os IDs do bloco, na ordem do arquivo
+ * 5. Insere tudo com Estoque::adicionarItens (índices construídos uma vez;
+ *    a quantidade de cada item vira uma ENTRADA no histórico)
+ *
+ * Linhas inválidas são rejeitadas com número da linha e motivo,
+ * sem abortar a importação.
+ */
+class ImportadorCSV {
+private:
+    // Estoque de destino (não pertence ao importador)
+    Estoque& estoque;
+
+    // Número de trechos de parse (0 = trabalhadores do pool + a thread que chama)
+    unsigned numThreads;
+
+public:
+    ImportadorCSV(Estoque& estoque, unsigned numThreads = 0);
+
+    /**
+     * Importa o arquivo CSV indicado.
+     *
+     * Retorna: ResultadoImportacao com contadores, rejeições e linhas/segundo
+     *
+     * Lança: EstoqueException se o arquivo não puder ser aberto
+     */
+    ResultadoImportacao importar(const std::string& caminho);
+};
+
+#endif // IMPORTADORCSV_H
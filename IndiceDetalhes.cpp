@@ -0,0 +1,78 @@
+// IndiceDetalhes.cpp - Índice secundário por categoria/fornecedor
+#include "IndiceDetalhes.h"
+#include "NormalizacaoTexto.h"
+#include <algorithm>
+
+using std::string;
+using std::vector;
+using std::pair;
+
+void IndiceDetalhes::adicionar(int idItem, const string& valor) {
+    Grupo& grupo = porValor[normalizarTexto(valor)];
+    if (grupo.ids.empty()) {
+        grupo.nome = valor;
+    }
+    grupo.ids.insert(idItem);
+}
+
+void IndiceDetalhes::remover(int idItem, const string& valor) {
+    std::unordered_map<string, Grupo>::iterator it = porValor.find(normalizarTexto(valor));
+    if (it == porValor.end()) {
+        return;
+    }
+    it->second.ids.erase(idItem);
+    if (it->second.ids.empty()) {
+        porValor.erase(it);
+    }
+}
+
+void IndiceDetalhes::limpar() {
+    porValor.clear();
+}
+
+vector<int> IndiceDetalhes::consultar(const string& valor) const {
+    vector<int> ids;
+    std::unordered_map<string, Grupo>::const_iterator it = porValor.find(normalizarTexto(valor));
+    if (it != porValor.end()) {
+        ids.assign(it->second.ids.begin(), it->second.ids.end());
+        std::sort(ids.begin(), ids.end());
+    }
+    return ids;
+}
+
+// Ordena as chaves normalizadas (sem acentos/maiúsculas) para a listagem
+vector<pair<string, vector<int> > > IndiceDetalhes::grupos() const {
+    vector<const pair<const string, Grupo>*> ordem;
+    ordem.reserve(porValor.size());
+    std::unordered_map<string, Grupo>::const_iterator it;
+    for (it = porValor.begin(); it != porValor.end(); ++it) {
+        ordem.push_back(&*it);
+    }
+    std::sort(ordem.begin(), ordem.end(),
+              [](const pair<const string, Grupo>* a, const pair<const string, Grupo>* b) {
+                  return a->first < b->first;
+              });
+
+    vector<pair<string, vector<int> > > resultado(ordem.size());
+    for (std::size_t i = 0; i < ordem.size(); ++i) {
+        const Grupo& grupo = ordem[i]->second;
+        resultado[i].first = grupo.nome;
+        resultado[i].second.assign(grupo.ids.begin(), grupo.ids.end());
+        std::sort(resultado[i].second.begin(), resultado[i].second.end());
+    }
+    return resultado;
+}
+
+// Estimativa no mesmo critério de bytesTabelaHash do Estoque:
+// baldes + um nó por entrada (chave/valor + ponteiro de encadeamento)
+std::size_t IndiceDetalhes::bytesOcupados() const {
+    std::size_t total = porValor.bucket_count() * sizeof(void*);
+    std::unordered_map<string, Grupo>::const_iterator it;
+    for (it = porValor.begin(); it != porValor.end(); ++it) {
+        total += sizeof(pair<const string, Grupo>) + sizeof(void*);
+        total += it->first.capacity() + it->second.nome.capacity();
+        total += it->second.ids.bucket_count() * sizeof(void*) +
+                 it->second.ids.size() * (sizeof(int) + sizeof(void*));
+    }
+    return total;
+}
@@ -0,0 +1,68 @@
+#ifndef INDICEDETALHES_H
+#define INDICEDETALHES_H
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Item;
+
+/**
+ * Itens que compartilham o mesmo valor do campo específico
+ * (uma categoria de produto, um fornecedor de matéria-prima).
+ */
+struct GrupoItens {
+    std::string nome;            // Valor como foi cadastrado (ex: "Ferragens")
+    std::vector<Item*> itens;    // Em ordem de ID
+};
+
+/**
+ * Índice secundário valor do campo específico -> conjunto de IDs.
+ *
+ * Uma instância por tipo de item no Estoque: categorias dos produtos,
+ * fornecedores das matérias-primas. A chave é o valor normalizado
+ * (normalizarTexto): "Ferragens", "FERRAGENS" e "ferragens " caem no mesmo grupo.
+ *
+ * Inserção e remoção O(1) médio; consultar um valor custa O(k log k)
+ * para k itens do grupo (ordenação dos IDs), sem varrer o catálogo.
+ *
+ * Sem trava própria: todas as chamadas acontecem com mutexEstado do Estoque travado.
+ */
+class IndiceDetalhes {
+public:
+    // Inclui o item no grupo do valor
+    void adicionar(int idItem, const std::string& valor);
+
+    // Retira o item do grupo (grupo vazio é descartado)
+    void remover(int idItem, const std::string& valor);
+
+    // Esvazia o índice (antes de reconstruir com adicionar)
+    void limpar();
+
+    // IDs do grupo, em ordem crescente (vazio se o valor não existe)
+    std::vector<int> consultar(const std::string& valor) const;
+
+    /**
+     * Todos os grupos, em ordem de nome normalizado.
+     * Retorna pares (nome cadastrado, IDs em ordem crescente).
+     */
+    std::vector<std::pair<std::string, std::vector<int> > > grupos() const;
+
+    // Número de valores distintos
+    std::size_t numeroGrupos() const { return porValor.size(); }
+
+    // Bytes ocupados (tabela, nomes e conjuntos de IDs)
+    std::size_t bytesOcupados() const;
+
+private:
+    struct Grupo {
+        std::string nome;                 // Primeira grafia cadastrada
+        std::unordered_set<int> ids;
+    };
+
+    // Chave: valor normalizado
+    std::unordered_map<std::string, Grupo> porValor;
+};
+
+#endif // INDICEDETALHES_H
@@ -0,0 +1,208 @@
+// IndiceInvertido.cpp - Índice invertido de descrições com listas delta + varint
+#include "IndiceInvertido.h"
+#include "NormalizacaoTexto.h"
+#include "RelatorioMemoria.h"
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+using std::string;
+using std::vector;
+using std::uint8_t;
+using std::uint32_t;
+using std::unordered_map;
+
+// === LISTA DE POSTAGENS ===
+
+ListaPostagens::ListaPostagens() : ultimo(0), quantidade(0) {
+}
+
+// 7 bits por byte; bit alto indica que há mais bytes
+void ListaPostagens::gravarVarint(vector<uint8_t>& destino, uint32_t valor) {
+    while (valor >= 0x80) {
+        destino.push_back(static_cast<uint8_t>(valor | 0x80));
+        valor >>= 7;
+    }
+    destino.push_back(static_cast<uint8_t>(valor));
+}
+
+// Lê um varint a partir de 'pos' e avança
+static uint32_t lerVarint(const vector<uint8_t>& origem, std::size_t& pos) {
+    uint32_t valor = 0;
+    int deslocamento = 0;
+    uint8_t byte;
+    do {
+        byte = origem[pos++];
+        valor |= static_cast<uint32_t>(byte & 0x7F) << deslocamento;
+        deslocamento += 7;
+    } while (byte & 0x80);
+    return valor;
+}
+
+void ListaPostagens::adicionar(int id) {
+    if (quantidade == 0 || id > ultimo) {
+        // Caso comum: append da diferença para o último ID
+        gravarVarint(bytes, static_cast<uint32_t>(quantidade == 0 ? id : id - ultimo));
+        ultimo = id;
+        ++quantidade;
+        return;
+    }
+    // ID fora de ordem: regrava a lista inserindo na posição certa
+    vector<int> ids;
+    ids.reserve(quantidade + 1);
+    decodificar(ids);
+    vector<int>::iterator pos = std::lower_bound(ids.begin(), ids.end(), id);
+    if (pos != ids.end() && *pos == id) {
+        return;  // Já presente
+    }
+    ids.insert(pos, id);
+    bytes.clear();
+    int anterior = 0;
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        gravarVarint(bytes, static_cast<uint32_t>(ids[i] - anterior));
+        anterior = ids[i];
+    }
+    ++quantidade;
+}
+
+// Uma passagem: copia os varints e funde a diferença do ID removido com a do seguinte
+void ListaPostagens::remover(int id) {
+    vector<uint8_t> novos;
+    novos.reserve(bytes.size());
+    std::size_t pos = 0;
+    int atual = 0;
+    int anteriorGravado = 0;
+    bool removido = false;
+    while (pos < bytes.size()) {
+        atual += static_cast<int>(lerVarint(bytes, pos));
+        if (atual == id) {
+            removido = true;
+            continue;
+        }
+        gravarVarint(novos, static_cast<uint32_t>(atual - anteriorGravado));
+        anteriorGravado = atual;
+    }
+    if (!removido) {
+        return;
+    }
+    bytes.swap(novos);
+    --quantidade;
+    ultimo = anteriorGravado;
+}
+
+void ListaPostagens::decodificar(vector<int>& saida) const {
+    std::size_t pos = 0;
+    int atual = 0;
+    while (pos < bytes.size()) {
+        atual += static_cast<int>(lerVarint(bytes, pos));
+        saida.push_back(atual);
+    }
+}
+
+// === ÍNDICE ===
+
+// Palavras distintas do texto normalizado
+vector<string> IndiceInvertido::tokenizar(const string& texto) {
+    vector<string> palavras;
+    std::istringstream entrada(normalizarTexto(texto));
+    string palavra;
+    while (entrada >> palavra) {
+        palavras.push_back(palavra);
+    }
+    std::sort(palavras.begin(), palavras.end());
+    palavras.erase(std::unique(palavras.begin(), palavras.end()), palavras.end());
+    return palavras;
+}
+
+void IndiceInvertido::adicionar(int idItem, const string& texto) {
+    vector<string> palavras = tokenizar(texto);
+    for (std::size_t i = 0; i < palavras.size(); ++i) {
+        termos[palavras[i]].adicionar(idItem);
+    }
+}
+
+void IndiceInvertido::remover(int idItem, const string& texto) {
+    vector<string> palavras = tokenizar(texto);
+    for (std::size_t i = 0; i < palavras.size(); ++i) {
+        unordered_map<string, ListaPostagens>::iterator it = termos.find(palavras[i]);
+        if (it == termos.end()) continue;
+        it->second.remover(idItem);
+        if (it->second.tamanho() == 0) {
+            termos.erase(it);  // Termo sem itens: libera a entrada
+        }
+    }
+}
+
+void IndiceInvertido::limpar() {
+    termos.clear();
+}
+
+// Decodifica a menor lista e filtra pelas demais com busca binária
+vector<int> IndiceInvertido::interseccao(const vector<string>& grupo) const {
+    vector<const ListaPostagens*> listas;
+    for (std::size_t i = 0; i < grupo.size(); ++i) {
+        unordered_map<string, ListaPostagens>::const_iterator it = termos.find(grupo[i]);
+        if (it == termos.end()) {
+            return vector<int>();  // Termo inexistente: interseção vazia
+        }
+        listas.push_back(&it->second);
+    }
+    if (listas.empty()) {
+        return vector<int>();
+    }
+    std::sort(listas.begin(), listas.end(),
+              [](const ListaPostagens* a, const ListaPostagens* b) { return a->tamanho() < b->tamanho(); });
+
+    vector<int> resultado;
+    resultado.reserve(listas[0]->tamanho());
+    listas[0]->decodificar(resultado);
+    vector<int> outra;
+    for (std::size_t i = 1; i < listas.size() && !resultado.empty(); ++i) {
+        outra.clear();
+        outra.reserve(listas[i]->tamanho());
+        listas[i]->decodificar(outra);
+        vector<int> filtrado;
+        filtrado.reserve(resultado.size());
+        std::set_intersection(resultado.begin(), resultado.end(), outra.begin(), outra.end(),
+                              std::back_inserter(filtrado));
+        resultado.swap(filtrado);
+    }
+    return resultado;
+}
+
+// Consulta em forma "grupo OU grupo OU ...", cada grupo com termos ligados por E
+vector<int> IndiceInvertido::consultar(const string& consulta) const {
+    // Separa os grupos pelos operadores OU/OR/| (antes da normalização)
+    vector<vector<string> > grupos(1);
+    std::istringstream entrada(consulta);
+    string palavra;
+    while (entrada >> palavra) {
+        if (palavra == "OU" || palavra == "OR" || palavra == "|") {
+            if (!grupos.back().empty()) grupos.push_back(vector<string>());
+            continue;
+        }
+        vector<string> termosPalavra = tokenizar(palavra);  // "aço-inox" -> aco, inox
+        grupos.back().insert(grupos.back().end(), termosPalavra.begin(), termosPalavra.end());
+    }
+
+    vector<int> resultado;
+    for (std::size_t g = 0; g < grupos.size(); ++g) {
+        if (grupos[g].empty()) continue;
+        vector<int> parcial = interseccao(grupos[g]);
+        vector<int> uniao;
+        uniao.reserve(resultado.size() + parcial.size());
+        std::set_union(resultado.begin(), resultado.end(), parcial.begin(), parcial.end(),
+                       std::back_inserter(uniao));
+        resultado.swap(uniao);
+    }
+    return resultado;
+}
+
+// Listas comprimidas + chaves + nós da tabela
+std::size_t IndiceInvertido::bytesOcupados() const {
+    std::size_t bytes = termos.bucket_count() * sizeof(void*);
+    for (unordered_map<string, ListaPostagens>::const_iterator it = termos.begin(); it != termos.end(); ++it) {
+        bytes += sizeof(*it) + 2 * sizeof(void*) + bytesHeapString(it->first) + it->second.bytesOcupados();
+    }
+    return bytes;
+}
@@ -0,0 +1,91 @@
+#ifndef INDICEINVERTIDO_H
+#define INDICEINVERTIDO_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Lista de IDs (postings) de um termo, comprimida: IDs em ordem crescente,
+ * gravados como diferença para o anterior em varint (7 bits por byte).
+ * IDs próximos ocupam 1 byte em vez de 4.
+ *
+ * Inserção de ID maior que o último (caso comum: IDs crescem) é um append;
+ * demais inserções e remoções regravam a lista em uma passagem.
+ */
+class ListaPostagens {
+public:
+    ListaPostagens();
+
+    // Insere o ID (ignora se já presente)
+    void adicionar(int id);
+
+    // Remove o ID (ignora se ausente)
+    void remover(int id);
+
+    // Decodifica todos os IDs, em ordem crescente, ao fim de 'saida'
+    void decodificar(std::vector<int>& saida) const;
+
+    // Número de IDs na lista
+    std::size_t tamanho() const { return quantidade; }
+
+    // Bytes ocupados pela lista comprimida
+    std::size_t bytesOcupados() const { return bytes.capacity(); }
+
+private:
+    std::vector<std::uint8_t> bytes;
+    int ultimo;               // Maior ID da lista (base do próximo append)
+    std::size_t quantidade;
+
+    // Grava 'valor' em varint ao fim de 'destino'
+    static void gravarVarint(std::vector<std::uint8_t>& destino, std::uint32_t valor);
+};
+
+/**
+ * Índice invertido de texto livre: termo normalizado -> itens que o contêm.
+ *
+ * Termos: palavras do texto normalizado (NormalizacaoTexto.h), ou seja,
+ * sem acentos e em minúsculas ("Aço Inox M8" -> aco, inox, m8).
+ *
+ * Consultas (consultar):
+ *   "m8 inox"        -> itens com m8 E inox
+ *   "m8 OU inox"     -> itens com m8 OU inox (também "OR" ou "|")
+ *   "m8 inox OU m10" -> (m8 E inox) OU m10
+ * Interseção começa pela lista mais curta; o resultado sai em ordem de ID.
+ *
+ * Atualização incremental: adicionar/remover recebem o texto do item;
+ * o índice não guarda o texto (remover precisa do texto indexado).
+ * Sem trava própria: o Estoque chama com mutexEstado travado.
+ */
+class IndiceInvertido {
+public:
+    // Indexa os termos de 'texto' para o item
+    void adicionar(int idItem, const std::string& texto);
+
+    // Retira o item das listas dos termos de 'texto' (o mesmo texto indexado)
+    void remover(int idItem, const std::string& texto);
+
+    // Esvazia o índice
+    void limpar();
+
+    // IDs dos itens que satisfazem a consulta, em ordem crescente
+    std::vector<int> consultar(const std::string& consulta) const;
+
+    // Número de termos distintos
+    std::size_t numeroTermos() const { return termos.size(); }
+
+    // Bytes ocupados (listas comprimidas + tabela de termos, aproximação)
+    std::size_t bytesOcupados() const;
+
+private:
+    std::unordered_map<std::string, ListaPostagens> termos;
+
+    // Termos distintos de um texto
+    static std::vector<std::string> tokenizar(const std::string& texto);
+
+    // Itens com todos os termos (interseção, da menor lista para a maior)
+    std::vector<int> interseccao(const std::vector<std::string>& grupo) const;
+};
+
+#endif // INDICEINVERTIDO_H
@@ -0,0 +1,222 @@
+// IndiceTrigramas.cpp - Busca de nomes tolerante a erros (trigramas + Levenshtein)
+#include "IndiceTrigramas.h"
+#include "NormalizacaoTexto.h"
+#include "RelatorioMemoria.h"
+#include <algorithm>
+
+using std::string;
+using std::vector;
+using std::uint32_t;
+using std::unordered_map;
+
+// Definição do membro estático (necessária em C++11 quando usado por referência)
+const std::size_t IndiceTrigramas::MAX_VERIFICACOES;
+
+// Três bytes empacotados em um inteiro (chave da tabela)
+static uint32_t chaveTrigrama(const char* p) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8) |
+            static_cast<uint32_t>(static_cast<unsigned char>(p[2]));
+}
+
+// Bordas ("  nome ") fazem o início do nome pesar mais; a consulta usa só
+// os trigramas internos, pois pode ser um trecho do meio do nome
+vector<uint32_t> IndiceTrigramas::trigramas(const string& normalizado, bool comBordas) {
+    string texto = comBordas ? "  " + normalizado + " " : normalizado;
+    vector<uint32_t> chaves;
+    if (texto.size() < 3) {
+        return chaves;
+    }
+    chaves.reserve(texto.size() - 2);
+    for (std::size_t i = 0; i + 3 <= texto.size(); ++i) {
+        chaves.push_back(chaveTrigrama(texto.data() + i));
+    }
+    std::sort(chaves.begin(), chaves.end());
+    chaves.erase(std::unique(chaves.begin(), chaves.end()), chaves.end());
+    return chaves;
+}
+
+void IndiceTrigramas::adicionar(int idItem, const string& nome) {
+    if (slotPorId.count(idItem)) {
+        remover(idItem);  // Reindexação do mesmo ID
+    }
+    uint32_t slot;
+    if (!slotsLivres.empty()) {
+        slot = slotsLivres.back();
+        slotsLivres.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(idPorSlot.size());
+        idPorSlot.push_back(0);
+        nomePorSlot.push_back(string());
+    }
+    idPorSlot[slot] = idItem;
+    nomePorSlot[slot] = normalizarTexto(nome);
+    slotPorId[idItem] = slot;
+
+    vector<uint32_t> chaves = trigramas(nomePorSlot[slot], true);
+    for (std::size_t i = 0; i < chaves.size(); ++i) {
+        listas[chaves[i]].push_back(slot);
+    }
+}
+
+// Remove o slot das listas dos trigramas do nome indexado e libera o slot
+void IndiceTrigramas::remover(int idItem) {
+    unordered_map<int, uint32_t>::iterator it = slotPorId.find(idItem);
+    if (it == slotPorId.end()) {
+        return;
+    }
+    const uint32_t slot = it->second;
+    vector<uint32_t> chaves = trigramas(nomePorSlot[slot], true);
+    for (std::size_t i = 0; i < chaves.size(); ++i) {
+        unordered_map<uint32_t, vector<uint32_t> >::iterator lista = listas.find(chaves[i]);
+        if (lista == listas.end()) continue;
+        vector<uint32_t>& slots = lista->second;
+        vector<uint32_t>::iterator pos = std::find(slots.begin(), slots.end(), slot);
+        if (pos != slots.end()) {
+            *pos = slots.back();  // Ordem das listas não importa: troca com o último
+            slots.pop_back();
+        }
+        if (slots.empty()) {
+            listas.erase(lista);
+        }
+    }
+    string().swap(nomePorSlot[slot]);
+    slotsLivres.push_back(slot);
+    slotPorId.erase(it);
+}
+
+void IndiceTrigramas::atualizar(int idItem, const string& nomeNovo) {
+    remover(idItem);
+    adicionar(idItem, nomeNovo);
+}
+
+void IndiceTrigramas::limpar() {
+    idPorSlot.clear();
+    nomePorSlot.clear();
+    slotsLivres.clear();
+    slotPorId.clear();
+    listas.clear();
+}
+
+void IndiceTrigramas::reservar(std::size_t numItens) {
+    idPorSlot.reserve(numItens);
+    nomePorSlot.reserve(numItens);
+    slotPorId.reserve(numItens);
+}
+
+// Ver descrição do algoritmo em IndiceTrigramas.h
+vector<CandidatoNome> IndiceTrigramas::buscar(const string& consulta, std::size_t limite) const {
+    vector<CandidatoNome> resultado;
+    string padrao = normalizarTexto(consulta);
+    if (padrao.empty() || limite == 0) {
+        return resultado;
+    }
+    const int maxDistancia = std::max(1, static_cast<int>(padrao.size()) / 4);
+
+    // 1. Contagem de trigramas comuns por slot
+    vector<uint32_t> chaves = trigramas(padrao, false);
+    if (chaves.empty()) {
+        chaves = trigramas(padrao, true);  // Consulta curta (1-2 letras): usa as bordas
+    }
+    if (contagem.size() < idPorSlot.size()) {
+        contagem.resize(idPorSlot.size(), 0);
+    }
+    tocados.clear();
+    for (std::size_t i = 0; i < chaves.size(); ++i) {
+        unordered_map<uint32_t, vector<uint32_t> >::const_iterator lista = listas.find(chaves[i]);
+        if (lista == listas.end()) continue;
+        const vector<uint32_t>& slots = lista->second;
+        for (std::size_t j = 0; j < slots.size(); ++j) {
+            unsigned char& n = contagem[slots[j]];
+            if (n == 0) tocados.push_back(slots[j]);
+            if (n < 255) ++n;
+        }
+    }
+
+    // 2. Filtro pelo lema dos q-gramas (pelo menos um trigrama em comum)
+    //    e limpeza dos contadores para a próxima busca
+    const int minimoComuns = std::max(1, static_cast<int>(chaves.size()) - 3 * maxDistancia);
+    vector<CandidatoNome> candidatos;
+    for (std::size_t i = 0; i < tocados.size(); ++i) {
+        int comuns = contagem[tocados[i]];
+        contagem[tocados[i]] = 0;
+        if (comuns >= minimoComuns) {
+            CandidatoNome c = { static_cast<int>(tocados[i]), 0, comuns };  // idItem = slot por enquanto
+            candidatos.push_back(c);
+        }
+    }
+    // Muitos candidatos: verifica só os com mais trigramas em comum
+    if (candidatos.size() > MAX_VERIFICACOES) {
+        std::nth_element(candidatos.begin(), candidatos.begin() + MAX_VERIFICACOES, candidatos.end(),
+                         [](const CandidatoNome& a, const CandidatoNome& b) {
+                             return a.trigramasComuns > b.trigramasComuns;
+                         });
+        candidatos.resize(MAX_VERIFICACOES);
+    }
+
+    // 3. Verificação por distância de edição
+    for (std::size_t i = 0; i < candidatos.size(); ++i) {
+        const string& nome = nomePorSlot[candidatos[i].idItem];
+        candidatos[i].distancia = distanciaEdicaoTrecho(padrao, nome, maxDistancia);
+        if (candidatos[i].distancia <= maxDistancia) {
+            resultado.push_back(candidatos[i]);
+        }
+    }
+
+    // 4. Ordenação: menos edições, nome de tamanho mais próximo, mais trigramas, menor ID
+    const vector<string>& nomes = nomePorSlot;
+    const vector<int>& ids = idPorSlot;
+    std::sort(resultado.begin(), resultado.end(),
+              [&nomes, &ids](const CandidatoNome& a, const CandidatoNome& b) {
+                  if (a.distancia != b.distancia) return a.distancia < b.distancia;
+                  std::size_t ta = nomes[a.idItem].size();
+                  std::size_t tb = nomes[b.idItem].size();
+                  if (ta != tb) return ta < tb;  // Todos contêm o padrão: o menor é o mais próximo
+                  if (a.trigramasComuns != b.trigramasComuns) return a.trigramasComuns > b.trigramasComuns;
+                  return ids[a.idItem] < ids[b.idItem];
+              });
+    if (resultado.size() > limite) {
+        resultado.resize(limite);
+    }
+    for (std::size_t i = 0; i < resultado.size(); ++i) {
+        resultado[i].idItem = idPorSlot[resultado[i].idItem];  // Slot -> ID do item
+    }
+    return resultado;
+}
+
+// Estimativa: capacidade dos vetores e strings + nós das tabelas hash
+std::size_t IndiceTrigramas::bytesOcupados() const {
+    std::size_t bytes = 0;
+    for (unordered_map<uint32_t, vector<uint32_t> >::const_iterator it = listas.begin(); it != listas.end(); ++it) {
+        bytes += sizeof(*it) + 2 * sizeof(void*) + it->second.capacity() * sizeof(uint32_t);
+    }
+    for (std::size_t i = 0; i < nomePorSlot.size(); ++i) {
+        bytes += bytesHeapString(nomePorSlot[i]);
+    }
+    bytes += nomePorSlot.capacity() * sizeof(string) + idPorSlot.capacity() * sizeof(int) +
+             slotsLivres.capacity() * sizeof(uint32_t) + contagem.capacity() + tocados.capacity() * sizeof(uint32_t);
+    bytes += slotPorId.size() * (sizeof(std::pair<const int, uint32_t>) + 2 * sizeof(void*));
+    bytes += (listas.bucket_count() + slotPorId.bucket_count()) * sizeof(void*);
+    return bytes;
+}
+
+// Levenshtein semi-global em duas linhas: a linha 0 é zero (o trecho pode começar
+// em qualquer posição do texto) e o resultado é o mínimo da última linha
+int distanciaEdicaoTrecho(const string& padrao, const string& texto, int limite) {
+    const std::size_t m = padrao.size();
+    const std::size_t n = texto.size();
+    // coluna[i] = distância de padrao[0..i) ao melhor trecho terminando na posição atual
+    vector<int> anterior(m + 1), atual(m + 1);
+    for (std::size_t i = 0; i <= m; ++i) anterior[i] = static_cast<int>(i);
+    int melhor = anterior[m];
+    for (std::size_t j = 1; j <= n; ++j) {
+        atual[0] = 0;  // Início livre no texto
+        for (std::size_t i = 1; i <= m; ++i) {
+            int custo = (padrao[i - 1] == texto[j - 1]) ? 0 : 1;
+            atual[i] = std::min(std::min(anterior[i] + 1, atual[i - 1] + 1), anterior[i - 1] + custo);
+        }
+        if (atual[m] < melhor) melhor = atual[m];  // Fim livre no texto
+        anterior.swap(atual);
+    }
+    return melhor <= limite ? melhor : limite + 1;
+}
@@ -0,0 +1,94 @@
+#ifndef INDICETRIGRAMAS_H
+#define INDICETRIGRAMAS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Candidato de uma busca aproximada por nome.
+ */
+struct CandidatoNome {
+    int idItem;
+    int distancia;          // Edições até o trecho mais parecido do nome (0 = contém a consulta)
+    int trigramasComuns;    // Trigramas da consulta presentes no nome
+};
+
+/**
+ * Índice de trigramas sobre nomes normalizados (NormalizacaoTexto.h),
+ * para busca tolerante a erros de digitação.
+ *
+ * Indexação: cada nome normalizado é dividido em trigramas (3 bytes,
+ * com dois espaços no início e um no fim); cada trigrama aponta para a
+ * lista de IDs que o contêm.
+ *
+ * Busca ("parafsuo m4"):
+ * 1. Conta, por item, quantos trigramas da consulta o nome contém
+ *    (vetor de contadores indexado por slot: O(tamanho das listas))
+ * 2. Filtro (lema dos q-gramas): com k edições, no máximo 3k trigramas da
+ *    consulta se perdem; itens abaixo desse limite são descartados
+ * 3. Verificação: distância de edição (Levenshtein) da consulta ao trecho
+ *    mais parecido do nome ("parafuso m4" em "parafuso m4 inox" = 0)
+ * 4. Ordena por distância, diferença de tamanho, trigramas comuns e ID
+ *
+ * Custo da busca proporcional às listas dos trigramas da consulta,
+ * não ao catálogo; a verificação é limitada a MAX_VERIFICACOES candidatos.
+ *
+ * Sem trava própria: o Estoque chama com mutexEstado travado.
+ */
+class IndiceTrigramas {
+public:
+    // Máximo de candidatos verificados por Levenshtein em uma busca
+    static const std::size_t MAX_VERIFICACOES = 2000;
+
+    // Indexa o nome de um item
+    void adicionar(int idItem, const std::string& nome);
+
+    // Retira o item do índice
+    void remover(int idItem);
+
+    // Reindexa após mudança de nome
+    void atualizar(int idItem, const std::string& nomeNovo);
+
+    // Esvazia o índice; reservar antecipa o número de itens
+    void limpar();
+    void reservar(std::size_t numItens);
+
+    /**
+     * Busca aproximada. Distância máxima aceita: 1 edição a cada 4 caracteres
+     * da consulta normalizada (mínimo 1).
+     * Retorna até 'limite' candidatos, do mais parecido para o menos.
+     */
+    std::vector<CandidatoNome> buscar(const std::string& consulta, std::size_t limite) const;
+
+    // Bytes ocupados pelas listas e nomes normalizados (aproximação)
+    std::size_t bytesOcupados() const;
+
+private:
+    // Cada item indexado ocupa uma posição densa ("slot"): as listas guardam
+    // slots de 32 bits e a contagem da busca usa um vetor simples, sem hash
+    std::vector<int> idPorSlot;
+    std::vector<std::string> nomePorSlot;        // Nome normalizado (verificação)
+    std::vector<std::uint32_t> slotsLivres;      // Slots de itens removidos, reutilizados
+    std::unordered_map<int, std::uint32_t> slotPorId;
+
+    // Trigrama -> slots dos itens cujo nome o contém
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t> > listas;
+
+    // Rascunho da busca (reutilizado entre buscas; protegido pela trava do Estoque)
+    mutable std::vector<unsigned char> contagem;  // Trigramas comuns por slot (satura em 255)
+    mutable std::vector<std::uint32_t> tocados;   // Slots com contagem > 0
+
+    // Trigramas distintos de um texto normalizado (com ou sem as bordas)
+    static std::vector<std::uint32_t> trigramas(const std::string& normalizado, bool comBordas);
+};
+
+/**
+ * Menor distância de edição entre 'padrao' e qualquer trecho de 'texto'
+ * (Levenshtein semi-global: início e fim livres no texto).
+ * Resultados acima de 'limite' são devolvidos como limite + 1. O(|padrao| * |texto|).
+ */
+int distanciaEdicaoTrecho(const std::string& padrao, const std::string& texto, int limite);
+
+#endif // INDICETRIGRAMAS_H
@@ -10,9 +10,16 @@ using std::string;
 int Item::proximoId = 1;
 
 // Construtor: inicializa atributos do item e atribui ID único
-Item::Item(const string& nome, const string& desc, int qtd, const string& link)
+Item::Item(TipoItem tipo, const string& nome, const string& desc, int qtd, const string& link)
     // Lista de inicialização: atribui ID (pós-incrementa proximoId), depois inicializa outros atributos
-    : idItem(proximoId++), nome(nome), descricao(desc), quantidade(qtd), linkInfo(link) {
+    : tipoItem(tipo), idItem(proximoId++), nome(nome), descricao(desc), saldo(empacotarSaldo(qtd, 0)), linkInfo(link),
+      minimo(0), observador(nullptr), versao(0) {
+}
+
+// Construtor de carregamento: usa ID fornecido (não altera proximoId)
+Item::Item(TipoItem tipo, int id, const string& nome, const string& desc, int qtd, const string& link)
+    : tipoItem(tipo), idItem(id), nome(nome), descricao(desc), saldo(empacotarSaldo(qtd, 0)), linkInfo(link),
+      minimo(0), observador(nullptr), versao(0) {
 }
 
 // Getter para ID: retorna o ID único do item
@@ -20,19 +27,33 @@ int Item::getId() const { return idItem; }
 // Getter para nome: retorna o nome armazenado
 string Item::getNome() const { return nome; }
 // Getter para quantidade: retorna quantidade em estoque
-int Item::getQuantidade() const { return quantidade; }
+int Item::getQuantidade() const { return quantidadeDoSaldo(saldo.load()); }
+// Getter para reservado: parte do estoque presa por reservas
+int Item::getReservado() const { return reservadoDoSaldo(saldo.load()); }
+// Getter para disponível: lido de uma única carga (quantidade e reserva consistentes)
+int Item::getDisponivel() const {
+    std::uint64_t s = saldo.load();
+    return quantidadeDoSaldo(s) - reservadoDoSaldo(s);
+}
 // Getter para link: retorna URL para busca de informações
 string Item::getLink() const { return linkInfo; }
 // Getter para descrição: retorna descrição do item
 string Item::getDescricao() const { return descricao; }
+// Getter para versão: usado para detectar alterações desde o último snapshot
+unsigned long Item::getVersao() const { return versao; }
 
 
 // Método para adicionar quantidade: aumenta estoque
 void Item::adicionarQtd(int qtd) {
     // Valida se quantidade é positiva
     if (qtd > 0) {
-        // Incrementa a quantidade
-        quantidade += qtd;
+        // Incrementa a quantidade (CAS: convive com reservas feitas sem trava)
+        std::uint64_t atual = saldo.load();
+        while (!saldo.compare_exchange_weak(atual,
+                   empacotarSaldo(quantidadeDoSaldo(atual) + qtd, reservadoDoSaldo(atual)))) {
+        }
+        ++versao;
+        verificarMinimo(quantidadeDoSaldo(atual), quantidadeDoSaldo(atual) + qtd);
     } else {
         // Lança exceção se quantidade é inválida
         throw EstoqueException("Quantidade a ser adicionada deve ser positiva.");
@@ -45,22 +66,109 @@ void Item::removerQtd(int qtd) {
     if (qtd <= 0) {
         throw EstoqueException("Quantidade a ser removida deve ser positiva.");
     }
-    // Verifica se há quantidade suficiente em estoque
-    if (quantidade - qtd < 0) {
-        throw EstoqueException("Nao ha quantidade suficiente em estoque para remover.");
+    std::uint64_t atual = saldo.load();
+    do {
+        // Verifica se há quantidade suficiente em estoque (fora das reservas)
+        int quantidade = quantidadeDoSaldo(atual);
+        int reservado = reservadoDoSaldo(atual);
+        if (quantidade - reservado - qtd < 0) {
+            if (reservado > 0 && quantidade - qtd >= 0) {
+                throw EstoqueException("Nao ha quantidade disponivel: " + std::to_string(reservado) +
+                                       " unidade(s) reservada(s).");
+            }
+            throw EstoqueException("Nao ha quantidade suficiente em estoque para remover.");
+        }
+        // Decrementa a quantidade (tenta de novo se o saldo mudou no meio)
+    } while (!saldo.compare_exchange_weak(atual,
+                 empacotarSaldo(quantidadeDoSaldo(atual) - qtd, reservadoDoSaldo(atual))));
+    ++versao;
+    verificarMinimo(quantidadeDoSaldo(atual), quantidadeDoSaldo(atual) - qtd);
+}
+
+// Reserva: move qtd da parte disponível para a reservada
+void Item::reservarQtd(int qtd) {
+    if (qtd <= 0) {
+        throw EstoqueException("Quantidade a ser reservada deve ser positiva.");
+    }
+    std::uint64_t atual = saldo.load();
+    do {
+        if (quantidadeDoSaldo(atual) - reservadoDoSaldo(atual) < qtd) {
+            throw EstoqueException("Nao ha quantidade disponivel para reservar.");
+        }
+    } while (!saldo.compare_exchange_weak(atual,
+                 empacotarSaldo(quantidadeDoSaldo(atual), reservadoDoSaldo(atual) + qtd)));
+}
+
+// Confirmação: a quantidade reservada sai do estoque (quantidade e reserva caem juntas)
+void Item::confirmarReservaQtd(int qtd) {
+    if (qtd <= 0) {
+        throw EstoqueException("Quantidade a ser confirmada deve ser positiva.");
     }
-    // Decrementa a quantidade
-    quantidade -= qtd;
+    std::uint64_t atual = saldo.load();
+    do {
+        if (reservadoDoSaldo(atual) < qtd) {
+            throw EstoqueException("Quantidade confirmada maior que a reservada.");
+        }
+    } while (!saldo.compare_exchange_weak(atual,
+                 empacotarSaldo(quantidadeDoSaldo(atual) - qtd, reservadoDoSaldo(atual) - qtd)));
+    ++versao;  // Quantidade mudou: snapshots futuros copiam o novo estado
+    verificarMinimo(quantidadeDoSaldo(atual), quantidadeDoSaldo(atual) - qtd);
+}
+
+// Liberação: a quantidade reservada volta a ficar disponível
+void Item::liberarReservaQtd(int qtd) {
+    if (qtd <= 0) {
+        throw EstoqueException("Quantidade a ser liberada deve ser positiva.");
+    }
+    std::uint64_t atual = saldo.load();
+    do {
+        if (reservadoDoSaldo(atual) < qtd) {
+            throw EstoqueException("Quantidade liberada maior que a reservada.");
+        }
+    } while (!saldo.compare_exchange_weak(atual,
+                 empacotarSaldo(quantidadeDoSaldo(atual), reservadoDoSaldo(atual) - qtd)));
 }
 
 // Método para atualizar dados básicos do item
 void Item::atualizarDados(const string& novoNome, const string& novaDesc, const string& novoLink) {
+    // Guarda os textos anteriores (movidos, sem cópia): os índices de busca
+    // precisam deles para retirar os termos antigos
+    string nomeAnterior, descricaoAnterior;
+    nomeAnterior.swap(this->nome);
+    descricaoAnterior.swap(this->descricao);
     // Atualiza nome
     this->nome = novoNome;
     // Atualiza descrição
     this->descricao = novaDesc;
     // Atualiza link de informação
     this->linkInfo = novoLink;
+    // Nova versão: snapshots futuros copiam o estado atualizado
+    ++versao;
+    // Índices de busca (nome, descrição) se atualizam pelo observador
+    if (observador != nullptr) {
+        observador->dadosAlterados(*this, nomeAnterior, descricaoAnterior);
+    }
+}
+
+// Define o estoque mínimo e avisa o observador se a situação mudou
+void Item::setMinimo(int novoMinimo) {
+    if (novoMinimo < 0) {
+        throw EstoqueException("Estoque minimo nao pode ser negativo.");
+    }
+    bool estavaAbaixo = estaAbaixoDoMinimo();
+    minimo = novoMinimo;
+    ++versao;  // Mínimo faz parte do estado gravado
+    if (observador != nullptr && estavaAbaixo != estaAbaixoDoMinimo()) {
+        observador->minimoCruzado(*this, !estavaAbaixo);
+    }
+}
+
+// Contabiliza os campos comuns (strings); o sizeof do objeto é somado pela subclasse
+void Item::contabilizarMemoria(RelatorioMemoria& relatorio) const {
+    relatorio.bytesStringsItens += bytesHeapString(nome) + bytesHeapString(descricao) + bytesHeapString(linkInfo);
+    relatorio.somaTamNome += nome.size();
+    relatorio.somaTamDescricao += descricao.size();
+    relatorio.somaTamLink += linkInfo.size();
 }
 
 // Método estático para definir o próximo ID a usar (importante ao carregar dados)
@@ -69,4 +177,9 @@ void Item::setProximoId(int id) {
     if (id > proximoId) {
         proximoId = id;
     }
+}
+
+// Método estático para consultar o próximo ID (reserva de blocos de IDs)
+int Item::getProximoId() {
+    return proximoId;
 }
\ No newline at end of file
@@ -4,10 +4,19 @@
 
 // Inclui biblioteca padrão para strings
 #include <string>
+// Saldo empacotado (quantidade + reservado) atualizado por compare-and-swap
+#include <atomic>
+#include <cstdint>
 // Inclui interface para exibição de objetos
 #include "IExibivel.h"
+// Etiqueta de tipo (despacho não virtual nos caminhos em massa)
+#include "TipoItem.h"
 // Inclui classe de exceção personalizada
 #include "EstoqueException.h"
+// Relatório de memória (contabilizarMemoria)
+#include "RelatorioMemoria.h"
+// Observador de limites (alertas de estoque baixo)
+#include "IObservadorItem.h"
 
 /**
  * Classe base abstrata que representa um item genérico no estoque.
@@ -16,26 +25,61 @@
  */
 class Item : public IExibivel {
 protected:
+    // Tipo concreto (PRODUTO ou MATERIA), definido pela subclasse no construtor
+    const TipoItem tipoItem;
     // Identificador único do item (autoincremento)
     int idItem;
     // Nome descritivo do item
     std::string nome;
     // Descrição detalhada do item
     std::string descricao;
-    // Quantidade atual em estoque
-    int quantidade;
+    // Saldo do item em uma única palavra atômica de 64 bits:
+    //   32 bits baixos = quantidade em estoque (inclui a parte reservada)
+    //   32 bits altos  = quantidade reservada (ainda não saiu do estoque)
+    // Atualizado por compare-and-swap: reservar/liberar não precisam de trava,
+    // e as duas partes nunca ficam inconsistentes entre si
+    std::atomic<std::uint64_t> saldo;
     // Link para buscar informações do item na internet
     std::string linkInfo;
+    // Estoque mínimo (ponto de reposição); 0 = sem alerta
+    int minimo;
+    // Notificado quando a quantidade cruza o mínimo (nullptr = ninguém observa)
+    IObservadorItem* observador;
+    // Versão do estado do item: incrementada a cada alteração
+    // Usada pelo Estoque para copy-on-write dos snapshots (SnapshotEstoque)
+    unsigned long versao;
 
     // Contador estático compartilhado por todos os itens para gerar IDs únicos
     static int proximoId;
 
+    // Empacotamento do saldo (quantidade nos bits baixos, reservado nos altos)
+    static std::uint64_t empacotarSaldo(int quantidade, int reservado) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(reservado)) << 32) |
+               static_cast<std::uint32_t>(quantidade);
+    }
+    static int quantidadeDoSaldo(std::uint64_t s) { return static_cast<int>(static_cast<std::uint32_t>(s)); }
+    static int reservadoDoSaldo(std::uint64_t s) { return static_cast<int>(static_cast<std::uint32_t>(s >> 32)); }
+
+    // Avisa o observador se a quantidade passou de um lado para o outro do mínimo
+    // Caminho comum (sem cruzamento): apenas as comparações, nenhuma chamada
+    void verificarMinimo(int antes, int depois) {
+        if (observador != nullptr && (antes < minimo) != (depois < minimo)) {
+            observador->minimoCruzado(*this, depois < minimo);
+        }
+    }
+
 public:
     /**
      * Construtor: inicializa um novo item com nome, descrição, quantidade e link.
      * Atribui automaticamente um ID único incrementando proximoId.
      */
-    Item(const std::string& nome, const std::string& desc, int qtd, const std::string& link);
+    Item(TipoItem tipo, const std::string& nome, const std::string& desc, int qtd, const std::string& link);
+
+    /**
+     * Construtor de carregamento: usa um ID já conhecido (arquivo ou bloco reservado).
+     * NÃO incrementa proximoId (mesmo padrão de MovimentoEstoque).
+     */
+    Item(TipoItem tipo, int id, const std::string& nome, const std::string& desc, int qtd, const std::string& link);
 
     /**
      * Destrutor virtual: essencial pois é classe base com métodos virtuais.
@@ -44,23 +88,67 @@ public:
     virtual ~Item() {}
 
     // === MÉTODOS DE ACESSO (GETTERS) ===
+    // Retorna a etiqueta de tipo (sem chamada virtual, sem alocação)
+    TipoItem getTipoItem() const { return tipoItem; }
     // Retorna o ID único do item
     int getId() const;
     // Retorna o nome do item
     std::string getNome() const;
-    // Retorna a quantidade atual em estoque
+    // Retorna a quantidade atual em estoque (inclui a parte reservada)
     int getQuantidade() const;
+    // Retorna a quantidade reservada (aguardando confirmação ou liberação)
+    int getReservado() const;
+    // Retorna a quantidade livre para nova saída ou reserva (quantidade - reservado)
+    int getDisponivel() const;
     // Retorna o link de informação do item
     std::string getLink() const;
     // Retorna a descrição do item
     std::string getDescricao() const;
+    // Retorna a versão atual do estado (muda a cada alteração de dados ou quantidade)
+    unsigned long getVersao() const;
+    // Retorna o estoque mínimo (0 = sem alerta)
+    int getMinimo() const { return minimo; }
+    // Indica se a quantidade está abaixo do estoque mínimo
+    bool estaAbaixoDoMinimo() const { return getQuantidade() < minimo; }
+
+    /**
+     * Define o estoque mínimo (ponto de reposição). 0 desativa o alerta.
+     * Notifica o observador se a situação (abaixo/normal) mudar.
+     * Lança: EstoqueException se minimo < 0.
+     */
+    void setMinimo(int minimo);
+
+    // Define quem é notificado nos cruzamentos do mínimo (usado pelo Estoque)
+    void setObservador(IObservadorItem* observador) { this->observador = observador; }
 
     // === MÉTODOS PARA MANIPULAÇÃO DE QUANTIDADE ===
     // Adiciona uma quantidade positiva ao estoque (entrada)
     void adicionarQtd(int qtd);
     // Remove uma quantidade do estoque (saída), com validação
+    // Só pode retirar a parte disponível: a parte reservada fica protegida
     void removerQtd(int qtd);
 
+    // === RESERVAS (sem trava: compare-and-swap sobre o saldo) ===
+
+    /**
+     * Reserva qtd unidades da parte disponível.
+     * Lança: EstoqueException se qtd <= 0 ou disponível insuficiente.
+     * Não altera a quantidade nem a versão (snapshots não mudam).
+     */
+    void reservarQtd(int qtd);
+
+    /**
+     * Confirma qtd unidades reservadas: saem do estoque e da reserva juntas.
+     * Lança: EstoqueException se qtd <= 0 ou maior que o reservado.
+     */
+    void confirmarReservaQtd(int qtd);
+
+    /**
+     * Devolve qtd unidades reservadas para a parte disponível.
+     * Lança: EstoqueException se qtd <= 0 ou maior que o reservado.
+     */
+    void liberarReservaQtd(int qtd);
+
     /**
      * Atualiza os campos básicos do item (nome, descrição, link).
      * Útil para edição de informações via menu.
@@ -74,20 +162,36 @@ public:
     /**
      * Retorna uma string indicando o tipo: "PRODUTO" ou "MATERIA".
      * Método puro: cada subclasse implementa sua versão.
+     * Em laços sobre muitos itens prefira getTipoItem() + nomeTipoItem().
      */
     virtual std::string getTipo() const = 0;
 
     /**
      * Retorna o detalhe específico: categoria (produto) ou fornecedor (materia).
      * Método puro: cada subclasse implementa sua versão.
+     * Em laços sobre muitos itens prefira detalheItem() (RegistroTiposItem.h).
      */
     virtual std::string getDetalheEspecifico() const = 0;
 
+    /**
+     * Soma no relatório os bytes ocupados por este item (objeto e strings)
+     * e os tamanhos das strings para médias.
+     * Virtual: cada subclasse acrescenta seu objeto e seu campo específico.
+     */
+    virtual void contabilizarMemoria(RelatorioMemoria& relatorio) const;
+
     /**
      * Define o próximo ID a ser usado (usado ao carregar dados do arquivo).
      * Método estático: pertence à classe, não aos objetos.
      */
     static void setProximoId(int id);
+
+    /**
+     * Retorna o próximo ID que será atribuído por um novo item.
+     * Usado junto com setProximoId() para reservar um bloco de IDs:
+     *   int base = Item::getProximoId(); Item::setProximoId(base + n);
+     */
+    static int getProximoId();
 };
 
 // Fecha guarda de header
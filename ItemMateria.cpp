@@ -1,5 +1,6 @@
 // ItemMateria.cpp - Implementação da classe especializada para Matéria-Prima
 #include "ItemMateria.h"
+#include "RegistroTiposItem.h"
 #include <iostream>
 
 using std::cout;
@@ -11,12 +12,19 @@ using std::string;
 // depois o campo específico fornecedor
 // Requisito POO: construtor com cadeia de inicialização de classe base
 ItemMateria::ItemMateria(const string& nome, const string& desc, int qtd, const string& link, const string& fornecedor)
-    : Item(nome, desc, qtd, link),  // Inicializa classe base
+    : Item(TIPO_MATERIA, nome, desc, qtd, link),  // Inicializa classe base
       fornecedor(fornecedor)          // Inicializa membro de ItemMateria
 {
     // Corpo vazio - toda inicialização feita em lista de inicializadores
 }
 
+// Construtor de carregamento: repassa o ID para a classe base (não gera novo ID)
+ItemMateria::ItemMateria(int id, const string& nome, const string& desc, int qtd, const string& link, const string& fornecedor)
+    : Item(TIPO_MATERIA, id, nome, desc, qtd, link),
+      fornecedor(fornecedor)
+{
+}
+
 // Exibe todos os detalhes deste item de matéria-prima no console
 // Requer acesso a campos privados da classe base (Item)
 // Funciona porque ItemMateria herda de Item (acesso protected)
@@ -32,7 +40,15 @@ void ItemMateria::exibirDetalhes() const {
     // Exibe nome da empresa fornecedora - CAMPO ESPECIALIZADO
     cout << "Fornecedor: " << fornecedor << endl;
     // Exibe quantidade atual em estoque
-    cout << "Quantidade: " << quantidade << endl;
+    cout << "Quantidade: " << getQuantidade() << endl;
+    // Exibe a parte reservada, se houver (aguardando confirmação)
+    if (getReservado() > 0) {
+        cout << "Reservado: " << getReservado() << " (disponivel: " << getDisponivel() << ")" << endl;
+    }
+    // Exibe o estoque mínimo, se definido
+    if (minimo > 0) {
+        cout << "Estoque minimo: " << minimo << (estaAbaixoDoMinimo() ? " (ABAIXO DO MINIMO)" : "") << endl;
+    }
     // Exibe link para ficha técnica ou documentação
     cout << "Link: " << linkInfo << endl;
     // Fechamento das linhas de separação
@@ -43,7 +59,7 @@ void ItemMateria::exibirDetalhes() const {
 // Usado no método gerarResumo() para serializar corretamente
 // Quando carrega do arquivo, lê primeiro getTipo() para saber se cria ItemProduto ou ItemMateria
 string ItemMateria::getTipo() const {
-    return "MATERIA";  // Constante que identifica tipo - "MATERIA" para matéria-prima
+    return nomeTipoItem(TIPO_MATERIA);  // Constante que identifica tipo - "MATERIA" para matéria-prima
 }
 
 // Retorna detalhe específico de ItemMateria: o nome do fornecedor
@@ -52,4 +68,13 @@ string ItemMateria::getTipo() const {
 // Requisito POO: polimorfismo (mesmo método, comportamento diferente)
 string ItemMateria::getDetalheEspecifico() const {
     return fornecedor;  // Retorna o campo específico de ItemMateria
+}
+
+// Contabiliza campos comuns (Item) + objeto completo e campo específico
+void ItemMateria::contabilizarMemoria(RelatorioMemoria& relatorio) const {
+    Item::contabilizarMemoria(relatorio);
+    relatorio.numMaterias++;
+    relatorio.bytesObjetosItens += sizeof(ItemMateria);
+    relatorio.bytesStringsItens += bytesHeapString(fornecedor);
+    relatorio.somaTamDetalhe += fornecedor.size();
 }
\ No newline at end of file
@@ -27,6 +27,11 @@ public:
      */
     ItemMateria(const std::string& nome, const std::string& desc, int qtd, const std::string& link, const std::string& fornecedor);
 
+    /**
+     * Construtor de carregamento: ID já definido (arquivo ou bloco reservado).
+     */
+    ItemMateria(int id, const std::string& nome, const std::string& desc, int qtd, const std::string& link, const std::string& fornecedor);
+
     /**
      * Sobrescreve exibirDetalhes() da classe base.
      * Exibe: ID, nome, descrição, quantidade, link e fornecedor.
@@ -49,6 +54,16 @@ public:
      * Requisito POO: polimorfismo (método virtual com implementação diferente).
      */
     virtual std::string getDetalheEspecifico() const override;
+
+    /**
+     * Acesso direto ao fornecedor, sem cópia (usado pelo despacho por etiqueta).
+     */
+    const std::string& getFornecedor() const { return fornecedor; }
+
+    /**
+     * Acrescenta o objeto ItemMateria e o campo fornecedor ao relatório de memória.
+     */
+    virtual void contabilizarMemoria(RelatorioMemoria& relatorio) const override;
 };
 
 #endif // ITEMMATERIA_H
\ No newline at end of file
@@ -1,5 +1,6 @@
 // ItemProduto.cpp - Implementação da classe especializada para Produto Final
 #include "ItemProduto.h"
+#include "RegistroTiposItem.h"
 #include <iostream>
 
 using std::cout;
@@ -11,12 +12,19 @@ using std::string;
 // depois o campo específico categoriaProduto
 // Requisito POO: construtor com cadeia de inicialização de classe base
 ItemProduto::ItemProduto(const string& nome, const string& desc, int qtd, const string& link, const string& categoria)
-    : Item(nome, desc, qtd, link),  // Inicializa classe base
+    : Item(TIPO_PRODUTO, nome, desc, qtd, link),  // Inicializa classe base
       categoriaProduto(categoria)     // Inicializa membro de ItemProduto
 {
     // Corpo vazio - toda inicialização feita em lista de inicializadores
 }
 
+// Construtor de carregamento: repassa o ID para a classe base (não gera novo ID)
+ItemProduto::ItemProduto(int id, const string& nome, const string& desc, int qtd, const string& link, const string& categoria)
+    : Item(TIPO_PRODUTO, id, nome, desc, qtd, link),
+      categoriaProduto(categoria)
+{
+}
+
 // Exibe todos os detalhes deste item de produto no console
 // Requer acesso a campos privados da classe base (Item)
 // Funciona porque ItemProduto herda de Item (acesso protected)
@@ -32,7 +40,15 @@ void ItemProduto::exibirDetalhes() const {
     // Exibe categoria de produto - CAMPO ESPECIALIZADO
     cout << "Categoria: " << categoriaProduto << endl;
     // Exibe quantidade atual em estoque
-    cout << "Quantidade: " << quantidade << endl;
+    cout << "Quantidade: " << getQuantidade() << endl;
+    // Exibe a parte reservada, se houver (aguardando confirmação)
+    if (getReservado() > 0) {
+        cout << "Reservado: " << getReservado() << " (disponivel: " << getDisponivel() << ")" << endl;
+    }
+    // Exibe o estoque mínimo, se definido
+    if (minimo > 0) {
+        cout << "Estoque minimo: " << minimo << (estaAbaixoDoMinimo() ? " (ABAIXO DO MINIMO)" : "") << endl;
+    }
     // Exibe link para ficha técnica ou documentação
     cout << "Link: " << linkInfo << endl;
     // Fechamento das linhas de separação
@@ -43,7 +59,7 @@ void ItemProduto::exibirDetalhes() const {
 // Usado no método gerarResumo() para serializar corretamente
 // Quando carrega do arquivo, lê primeiro getTipo() para saber se cria ItemProduto ou ItemMateria
 string ItemProduto::getTipo() const {
-    return "PRODUTO";  // Constante que identifica tipo - "PRODUTO" para produto final
+    return nomeTipoItem(TIPO_PRODUTO);  // Constante que identifica tipo - "PRODUTO" para produto final
 }
 
 // Retorna detalhe específico de ItemProduto: a categoria do produto
@@ -52,4 +68,13 @@ string ItemProduto::getTipo() const {
 // Requisito POO: polimorfismo (mesmo método, comportamento diferente)
 string ItemProduto::getDetalheEspecifico() const {
     return categoriaProduto;  // Retorna o campo específico de ItemProduto
+}
+
+// Contabiliza campos comuns (Item) + objeto completo e campo específico
+void ItemProduto::contabilizarMemoria(RelatorioMemoria& relatorio) const {
+    Item::contabilizarMemoria(relatorio);
+    relatorio.numProdutos++;
+    relatorio.bytesObjetosItens += sizeof(ItemProduto);
+    relatorio.bytesStringsItens += bytesHeapString(categoriaProduto);
+    relatorio.somaTamDetalhe += categoriaProduto.size();
 }
\ No newline at end of file
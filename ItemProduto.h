@@ -23,6 +23,11 @@ public:
      */
     ItemProduto(const std::string& nome, const std::string& desc, int qtd, const std::string& link, const std::string& categoria);
 
+    /**
+     * Construtor de carregamento: ID já definido (arquivo ou bloco reservado).
+     */
+    ItemProduto(int id, const std::string& nome, const std::string& desc, int qtd, const std::string& link, const std::string& categoria);
+
     /**
      * Sobrescreve exibirDetalhes() para exibir com categoria.
      * override: marca que sobrescreve método virtual da classe base.
@@ -45,6 +50,16 @@ public:
      * Usado ao salvar em arquivo.
      */
     virtual std::string getDetalheEspecifico() const override;
+
+    /**
+     * Acesso direto à categoria, sem cópia (usado pelo despacho por etiqueta).
+     */
+    const std::string& getCategoria() const { return categoriaProduto; }
+
+    /**
+     * Acrescenta o objeto ItemProduto e o campo categoriaProduto ao relatório de memória.
+     */
+    virtual void contabilizarMemoria(RelatorioMemoria& relatorio) const override;
 };
 
 // Fecha guarda de header
@@ -2,20 +2,31 @@
 #define LISTAGENERICA_H
 
 #include <vector>
+#include <iterator> // Para std::make_move_iterator
+#include <utility> // Para std::move, std::forward
 #include <stdexcept> // Para std::out_of_range
 
 /**
  * Classe template para uma lista genérica dinâmica.
  * Requisito POO: uso de templates/generics para código reutilizável.
  * 
- * Funciona com qualquer tipo T:
- * - ListaGenerica<Item*> para armazenar ponteiros de items
- * - ListaGenerica<MovimentoEstoque*> para armazenar movimentos
- * - ListaGenerica<int> para armazenar inteiros (exemplo teórico)
+ * Funciona com qualquer tipo T, inclusive tipos só movíveis:
+ * - ListaGenerica<std::unique_ptr<Item> > para itens (a lista é dona deles)
+ * - ListaGenerica<std::unique_ptr<MovimentoEstoque> > para movimentos
+ * - ListaGenerica<int> ou de structs: elementos guardados em linha
  * 
  * Implementação: wrapper em torno de std::vector para abstrair detalhes
  * Conversão feita: changed indices from int to std::size_t para eliminar
  * warnings de comparação signed/unsigned com vector::size()
+ * 
+ * Acesso:
+ * - get(i): verifica o índice (std::out_of_range); uso geral
+ * - operator[](i): sem verificação; laços que já limitam i por tamanho()
+ * - begin()/end(): percorre com range-for (for (const T& x : lista))
+ * 
+ * Nenhum método copia T: referências são devolvidas e os elementos são
+ * movidos para dentro da lista (adicionar só aceita temporário ou
+ * std::move; construir cria o elemento no lugar)
  *
  * @tparam T O tipo de dado genérico que a lista irá armazenar
  */
@@ -27,18 +38,45 @@ private:
     std::vector<T> elementos;
 
 public:
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
     /**
      * Adiciona um item ao final da lista.
      * Operação: O(1) amortizado (crescimento exponencial de capacidade)
      * 
      * Parâmetro:
-     *   - item: elemento do tipo T a ser adicionado
+     *   - item: elemento do tipo T a ser adicionado, sempre movido
+     *     (temporário ou std::move; para copiar, passe T(original))
      * 
-     * Exemplo: lista.adicionar(novoItem);
+     * Exemplo: itens.adicionar(std::unique_ptr<Item>(novo));
+     *          lista.adicionar(std::move(valor));
      * Requisito POO: template permite tipo genérico T sem casting
      */
-    void adicionar(T item) {
-        elementos.push_back(item);  // push_back() adiciona ao final
+    void adicionar(T&& item) {
+        elementos.push_back(std::move(item));  // push_back() adiciona ao final
+    }
+
+    /**
+     * Constrói um item diretamente no final da lista (emplace),
+     * repassando os argumentos ao construtor de T.
+     * 
+     * Exemplo: pares.construir(id, quantidade);  // ListaGenerica<std::pair<int, int> >
+     */
+    template <typename... Args>
+    T& construir(Args&&... args) {
+        elementos.emplace_back(std::forward<Args>(args)...);
+        return elementos.back();
+    }
+
+    /**
+     * Reserva capacidade para pelo menos n elementos.
+     * Evita realocações sucessivas em cargas em lote (importação, carregamento).
+     * 
+     * Exemplo: lista.reservar(lista.tamanho() + novos.size());
+     */
+    void reservar(std::size_t n) {
+        elementos.reserve(n);
     }
 
     /**
@@ -65,6 +103,38 @@ public:
         elementos.erase(elementos.begin() + indice);
     }
 
+    /**
+     * Insere vários itens no início, preservando a ordem de 'novos'.
+     * Operação: O(tamanho() + novos.size()) - um único deslocamento
+     * 
+     * Parâmetro:
+     *   - novos: itens que passam a ocupar as posições 0..novos.size()-1
+     *     (movidos para a lista; 'novos' fica com elementos vazios)
+     * 
+     * Exemplo: historico.adicionarInicio(std::move(movimentosDoArquivo));
+     */
+    void adicionarInicio(std::vector<T>&& novos) {
+        elementos.insert(elementos.begin(), std::make_move_iterator(novos.begin()),
+                         std::make_move_iterator(novos.end()));
+    }
+
+    /**
+     * Remove os n primeiros itens de uma vez e devolve a folga de memória.
+     * Operação: O(tamanho()) - um único deslocamento, em vez de n chamadas a remover(0)
+     * 
+     * Parâmetro:
+     *   - n: quantidade de itens a remover do início (n > tamanho() remove todos)
+     * 
+     * Exemplo: historico.removerInicio(movimentosArquivados);
+     */
+    void removerInicio(std::size_t n) {
+        if (n > elementos.size()) {
+            n = elementos.size();
+        }
+        elementos.erase(elementos.begin(), elementos.begin() + n);
+        elementos.shrink_to_fit();  // Lista compactada não deve manter a capacidade antiga
+    }
+
     /**
      * Obtém (acessa) um item em posição específica.
      * Operação: O(1) acesso direto ao vetor
@@ -72,27 +142,48 @@ public:
      * Parâmetro:
      *   - indice: posição do elemento (0-based), deve ser < tamanho()
      * 
-     * Retorna: cópia do elemento T na posição indice
+     * Retorna: referência constante ao elemento T na posição indice
+     *          (válida até a lista ser alterada)
      * 
      * const: método não modifica a lista
      * 
      * Lança: std::out_of_range se indice >= tamanho()
      * 
-     * Nota: Para ponteiros (ex: Item*), retorna cópia do ponteiro
-     * não cópia do objeto apontado
+     * Nota: Para ponteiros inteligentes (ex: unique_ptr<Item>), use
+     * get(i).get() para obter o Item* sem transferir a posse
      * 
-     * Exemplo: Item* item = lista.get(0);
+     * Exemplo: const Item& item = *lista.get(0);
      */
-    T get(std::size_t indice) const {
+    const T& get(std::size_t indice) const {
         // Verifica se índice está dentro dos limites válidos [0, tamanho)
         if (indice >= elementos.size()) {
             // Lança exceção padrão C++ - a chamadora deve capturar
             throw std::out_of_range("Indice fora do intervalo da lista.");
         }
-        // Retorna cópia do elemento na posição indice
+        // Retorna o elemento na posição indice (sem cópia)
         return elementos[indice];
     }
 
+    /**
+     * Acesso sem verificação de índice: para laços limitados por tamanho().
+     * Índice >= tamanho() tem comportamento indefinido.
+     * 
+     * Exemplo: for (std::size_t i = 0; i < lista.tamanho(); ++i) soma += lista[i];
+     */
+    T& operator[](std::size_t indice) {
+        return elementos[indice];
+    }
+
+    const T& operator[](std::size_t indice) const {
+        return elementos[indice];
+    }
+
+    // Iteradores (range-for e algoritmos da STL)
+    iterator begin() { return elementos.begin(); }
+    iterator end() { return elementos.end(); }
+    const_iterator begin() const { return elementos.begin(); }
+    const_iterator end() const { return elementos.end(); }
+
     /**
      * Retorna o número total de itens na lista.
      * Operação: O(1) - std::vector mantém tamanho cache
@@ -112,6 +203,16 @@ public:
         // Retorna o tamanho do vector (número de elementos)
         return elementos.size();
     }
+
+    /**
+     * Retorna quantos elementos cabem sem realocar (capacity do vector).
+     * capacidade() - tamanho() = folga alocada e ainda não usada.
+     * 
+     * Exemplo: relatorio de memória compara tamanho() x capacidade()
+     */
+    std::size_t capacidade() const {
+        return elementos.capacity();
+    }
 };
 
 #endif // LISTAGENERICA_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+// LogDesfazer.cpp - Buffer circular de operações desfazíveis do Estoque
+#include "LogDesfazer.h"
+#include "Item.h"
+#include <utility> // Para std::move
+
+// Definição do membro estático (necessária em C++11 quando usado por referência)
+const std::size_t LogDesfazer::CAPACIDADE;
+
+LogDesfazer::LogDesfazer() : anel(CAPACIDADE), inicio(0), desfaziveis(0), total(0) {
+}
+
+LogDesfazer::~LogDesfazer() {
+    limpar();
+}
+
+void LogDesfazer::liberar(OperacaoDesfazivel& operacao, bool ladoRefazer) {
+    bool dono = (operacao.tipo == DESFAZ_REMOVER_ITEM && !ladoRefazer) ||
+                (operacao.tipo == DESFAZ_ADICIONAR_ITEM && ladoRefazer);
+    if (dono) {
+        delete operacao.item;
+    }
+    operacao.item = nullptr;
+}
+
+void LogDesfazer::registrar(OperacaoDesfazivel operacao) {
+    // Nova operação invalida o que tinha sido desfeito
+    for (std::size_t i = desfaziveis; i < total; ++i) {
+        liberar(posicao(i), true);
+    }
+    total = desfaziveis;
+
+    // Anel cheio: esquece a operação mais antiga
+    if (total == CAPACIDADE) {
+        liberar(posicao(0), false);
+        inicio = (inicio + 1) % CAPACIDADE;
+        --total;
+        --desfaziveis;
+    }
+    posicao(total) = std::move(operacao);
+    ++total;
+    ++desfaziveis;
+}
+
+OperacaoDesfazivel& LogDesfazer::proximaDesfazer() {
+    return posicao(desfaziveis - 1);
+}
+
+OperacaoDesfazivel& LogDesfazer::proximaRefazer() {
+    return posicao(desfaziveis);
+}
+
+void LogDesfazer::limpar() {
+    for (std::size_t i = 0; i < total; ++i) {
+        liberar(posicao(i), i >= desfaziveis);
+    }
+    inicio = desfaziveis = total = 0;
+}
@@ -0,0 +1,105 @@
+#ifndef LOGDESFAZER_H
+#define LOGDESFAZER_H
+
+#include <string>
+#include <vector>
+#include "TransacaoEstoque.h"
+
+class Item;
+
+// Operações do Estoque que podem ser desfeitas/refeitas
+enum TipoDesfazivel {
+    DESFAZ_ADICIONAR_ITEM,
+    DESFAZ_REMOVER_ITEM,
+    DESFAZ_EDITAR_ITEM,
+    DESFAZ_ENTRADA,
+    DESFAZ_SAIDA,
+    DESFAZ_DEFINIR_MINIMO,
+    DESFAZ_TRANSACAO
+};
+
+/**
+ * Registro de uma operação com o necessário para invertê-la em O(1).
+ *
+ * Campos usados por tipo:
+ *   - ADICIONAR/REMOVER_ITEM: item (o próprio objeto, nunca copiado)
+ *   - EDITAR_ITEM: nome/descricao/link da "outra" versão (trocados a cada desfazer/refazer)
+ *   - ENTRADA/SAIDA: quantidade
+ *   - DEFINIR_MINIMO: quantidade = o "outro" mínimo (trocado a cada desfazer/refazer)
+ *   - TRANSACAO: linhas da transação (desfeita/refeita inteira, tudo ou nada)
+ *
+ * Posse de item: o registro é dono do objeto enquanto ele estiver fora do
+ * Estoque (REMOVER ainda não desfeito, ou ADICIONAR já desfeito).
+ */
+struct OperacaoDesfazivel {
+    TipoDesfazivel tipo;
+    int idItem;
+    int quantidade;
+    Item* item;
+    std::string nome;
+    std::string descricao;
+    std::string link;
+    std::vector<LinhaTransacao> linhas;
+};
+
+/**
+ * Log limitado de operações desfazíveis em buffer circular.
+ *
+ * Layout: CAPACIDADE posições; [0, desfaziveis) a partir de 'inicio' são as
+ * operações que podem ser desfeitas (a última é a mais recente) e
+ * [desfaziveis, total) as que podem ser refeitas.
+ *
+ * Registrar descarta o lado "refazer" e, com o anel cheio, sobrescreve a
+ * operação mais antiga. Desfazer/refazer só movem o cursor: O(1) por passo,
+ * sem copiar estado do Estoque.
+ *
+ * Sem trava própria: usado com mutexEstado do Estoque travado.
+ */
+class LogDesfazer {
+public:
+    // Número máximo de operações lembradas
+    static const std::size_t CAPACIDADE = 256;
+
+    LogDesfazer();
+
+    // Libera os itens que ainda pertencem ao log
+    ~LogDesfazer();
+
+    // Acrescenta uma operação (descarta o que podia ser refeito)
+    void registrar(OperacaoDesfazivel operacao);
+
+    std::size_t numeroDesfaziveis() const { return desfaziveis; }
+    std::size_t numeroRefaziveis() const { return total - desfaziveis; }
+
+    // Operação mais recente ainda não desfeita. Pré-condição: numeroDesfaziveis() > 0
+    OperacaoDesfazivel& proximaDesfazer();
+
+    // Operação desfeita mais recente. Pré-condição: numeroRefaziveis() > 0
+    OperacaoDesfazivel& proximaRefazer();
+
+    // A operação de proximaDesfazer() foi invertida: passa para o lado refazer
+    void confirmarDesfazer() { --desfaziveis; }
+
+    // A operação de proximaRefazer() foi reaplicada: volta para o lado desfazer
+    void confirmarRefazer() { ++desfaziveis; }
+
+    // Descarta tudo (ex: após recarregar dados)
+    void limpar();
+
+private:
+    std::vector<OperacaoDesfazivel> anel;
+    std::size_t inicio;       // Posição da operação mais antiga
+    std::size_t desfaziveis;  // Operações no lado desfazer
+    std::size_t total;        // Desfazer + refazer
+
+    OperacaoDesfazivel& posicao(std::size_t i) { return anel[(inicio + i) % CAPACIDADE]; }
+
+    // Libera o item do registro se o log for o dono (ver OperacaoDesfazivel)
+    static void liberar(OperacaoDesfazivel& operacao, bool ladoRefazer);
+
+    // Não copiável: o log é dono de itens
+    LogDesfazer(const LogDesfazer&);
+    LogDesfazer& operator=(const LogDesfazer&);
+};
+
+#endif // LOGDESFAZER_H
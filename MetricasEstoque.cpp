@@ -0,0 +1,160 @@
+// MetricasEstoque.cpp - Histogramas de latência (estilo HDR) por operação do Estoque
+#include "MetricasEstoque.h"
+#include <iomanip>
+
+using std::uint64_t;
+using std::memory_order_relaxed;
+using std::endl;
+
+// Definições dos membros estáticos (necessárias em C++11 quando usados por referência)
+const int HistogramaLatencia::BITS_SUBFAIXA;
+const int HistogramaLatencia::SUBFAIXAS;
+const int HistogramaLatencia::NUM_FAIXAS;
+
+// Construtor: atomics em array não são zerados automaticamente
+HistogramaLatencia::HistogramaLatencia() {
+    zerar();
+}
+
+// Posição do bit mais significativo (valor > 0)
+static int bitMaisSignificativo(uint64_t valor) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(valor);  // Uma instrução (bsr/lzcnt)
+#else
+    int posicao = 0;
+    while (valor >>= 1) ++posicao;
+    return posicao;
+#endif
+}
+
+// Faixas 0..15: valores 0..15 (lineares)
+// Demais: grupo = posição do bit mais alto; 16 sub-faixas dentro do grupo
+int HistogramaLatencia::indiceFaixa(uint64_t valor) {
+    if (valor < static_cast<uint64_t>(SUBFAIXAS)) {
+        return static_cast<int>(valor);
+    }
+    int deslocamento = bitMaisSignificativo(valor) - BITS_SUBFAIXA;
+    int sub = static_cast<int>((valor >> deslocamento) & (SUBFAIXAS - 1));
+    return (deslocamento + 1) * SUBFAIXAS + sub;
+}
+
+// Inverso de indiceFaixa: último valor que cai na faixa
+uint64_t HistogramaLatencia::limiteSuperior(int indice) {
+    if (indice < SUBFAIXAS) {
+        return static_cast<uint64_t>(indice);
+    }
+    int deslocamento = indice / SUBFAIXAS - 1;
+    uint64_t sub = static_cast<uint64_t>(indice % SUBFAIXAS);
+    return ((SUBFAIXAS + sub + 1) << deslocamento) - 1;
+}
+
+// Registro sem travas: incrementos relaxed e máximo por compare-and-swap
+void HistogramaLatencia::registrar(uint64_t nanos) {
+    contagens[indiceFaixa(nanos)].fetch_add(1, memory_order_relaxed);
+    numAmostras.fetch_add(1, memory_order_relaxed);
+    soma.fetch_add(nanos, memory_order_relaxed);
+    uint64_t atual = maior.load(memory_order_relaxed);
+    while (nanos > atual && !maior.compare_exchange_weak(atual, nanos, memory_order_relaxed)) {
+        // compare_exchange_weak atualiza 'atual' com o valor vigente e tenta de novo
+    }
+}
+
+uint64_t HistogramaLatencia::total() const {
+    return numAmostras.load(memory_order_relaxed);
+}
+
+uint64_t HistogramaLatencia::maximo() const {
+    return maior.load(memory_order_relaxed);
+}
+
+double HistogramaLatencia::media() const {
+    uint64_t n = total();
+    return n ? static_cast<double>(soma.load(memory_order_relaxed)) / n : 0.0;
+}
+
+// Percorre as faixas acumulando até alcançar p% das amostras
+uint64_t HistogramaLatencia::percentil(double p) const {
+    uint64_t n = total();
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t alvo = static_cast<uint64_t>(p / 100.0 * n + 0.5);
+    if (alvo < 1) alvo = 1;
+    uint64_t acumulado = 0;
+    for (int i = 0; i < NUM_FAIXAS; ++i) {
+        acumulado += contagens[i].load(memory_order_relaxed);
+        if (acumulado >= alvo) {
+            uint64_t limite = limiteSuperior(i);
+            uint64_t max = maximo();
+            return limite < max ? limite : max;  // Nunca acima do máximo observado
+        }
+    }
+    return maximo();
+}
+
+void HistogramaLatencia::zerar() {
+    for (int i = 0; i < NUM_FAIXAS; ++i) {
+        contagens[i].store(0, memory_order_relaxed);
+    }
+    numAmostras.store(0, memory_order_relaxed);
+    soma.store(0, memory_order_relaxed);
+    maior.store(0, memory_order_relaxed);
+}
+
+// Nomes iguais aos métodos do Estoque (facilita leitura do relatório)
+const char* MetricasEstoque::nomeOperacao(OperacaoEstoque op) {
+    switch (op) {
+        case OP_ADICIONAR_ITEM:    return "adicionarItem";
+        case OP_REMOVER_ITEM:      return "removerItem";
+        case OP_BUSCAR_POR_ID:     return "buscarItemPorId";
+        case OP_BUSCAR_POR_NOME:   return "buscarItemPorNome";
+        case OP_BUSCAR_POR_NOME_APROXIMADO: return "buscarItensPorNomeAproximado";
+        case OP_BUSCAR_POR_DESCRICAO:       return "buscarPorDescricao";
+        case OP_REGISTRAR_ENTRADA: return "registrarEntrada";
+        case OP_REGISTRAR_SAIDA:   return "registrarSaida";
+        case OP_SALVAR_DADOS:      return "salvarDados";
+        case OP_CARREGAR_DADOS:    return "carregarDados";
+        case OP_CARREGAR_HISTORICO: return "carregarHistorico";
+        case OP_RESERVAR:          return "reservar";
+        case OP_CONFIRMAR_RESERVA: return "confirmarReserva";
+        case OP_LIBERAR_RESERVA:   return "liberarReserva";
+        case OP_EXECUTAR_TRANSACAO: return "executarTransacao";
+        case OP_EXPIRAR_RESERVAS:  return "expirarReservas";
+        default:                   return "?";
+    }
+}
+
+void MetricasEstoque::registrar(OperacaoEstoque op, uint64_t nanos) {
+    histogramas[op].registrar(nanos);
+}
+
+const HistogramaLatencia& MetricasEstoque::histograma(OperacaoEstoque op) const {
+    return histogramas[op];
+}
+
+// Tabela em microssegundos: n, media, p50, p99, p999, max
+void MetricasEstoque::imprimir(std::ostream& saida) const {
+    std::ios::fmtflags flags = saida.flags();
+    saida << std::fixed << std::setprecision(2);
+    saida << std::left << std::setw(20) << "operacao" << std::right
+          << std::setw(10) << "n" << std::setw(12) << "media(us)" << std::setw(12) << "p50(us)"
+          << std::setw(12) << "p99(us)" << std::setw(12) << "p999(us)" << std::setw(12) << "max(us)" << endl;
+    for (int i = 0; i < NUM_OPERACOES; ++i) {
+        const HistogramaLatencia& h = histogramas[i];
+        if (h.total() == 0) continue;
+        saida << std::left << std::setw(20) << nomeOperacao(static_cast<OperacaoEstoque>(i)) << std::right
+              << std::setw(10) << h.total()
+              << std::setw(12) << h.media() / 1000.0
+              << std::setw(12) << h.percentil(50.0) / 1000.0
+              << std::setw(12) << h.percentil(99.0) / 1000.0
+              << std::setw(12) << h.percentil(99.9) / 1000.0
+              << std::setw(12) << h.maximo() / 1000.0 << endl;
+    }
+    saida.flags(flags);
+}
+
+void MetricasEstoque::zerar() {
+    for (int i = 0; i < NUM_OPERACOES; ++i) {
+        histogramas[i].zerar();
+    }
+}
@@ -0,0 +1,143 @@
+#ifndef METRICASESTOQUE_H
+#define METRICASESTOQUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Operações públicas do Estoque com latência medida
+enum OperacaoEstoque {
+    OP_ADICIONAR_ITEM,
+    OP_REMOVER_ITEM,
+    OP_BUSCAR_POR_ID,
+    OP_BUSCAR_POR_NOME,
+    OP_BUSCAR_POR_NOME_APROXIMADO,
+    OP_BUSCAR_POR_DESCRICAO,
+    OP_REGISTRAR_ENTRADA,
+    OP_REGISTRAR_SAIDA,
+    OP_SALVAR_DADOS,
+    OP_CARREGAR_DADOS,
+    OP_CARREGAR_HISTORICO,
+    OP_RESERVAR,
+    OP_CONFIRMAR_RESERVA,
+    OP_LIBERAR_RESERVA,
+    OP_EXECUTAR_TRANSACAO,
+    OP_EXPIRAR_RESERVAS,
+    NUM_OPERACOES
+};
+
+/**
+ * Histograma de latências no estilo HDR (log-linear), em nanossegundos.
+ *
+ * Cada potência de dois é dividida em 16 sub-faixas lineares:
+ * erro relativo máximo de 1/16 (6,25%) em qualquer percentil,
+ * de 1 ns até o limite de um uint64_t, em memória fixa (1024 contadores).
+ *
+ * Registro sem travas: contadores std::atomic com memory_order_relaxed.
+ * Várias threads podem registrar ao mesmo tempo; a leitura de percentis
+ * durante registros vê um estado aproximado (suficiente para monitoração).
+ */
+class HistogramaLatencia {
+public:
+    static const int BITS_SUBFAIXA = 4;
+    static const int SUBFAIXAS = 1 << BITS_SUBFAIXA;
+    static const int NUM_FAIXAS = 64 * SUBFAIXAS;
+
+    HistogramaLatencia();
+
+    // Registra uma amostra (ns). Sem travas.
+    void registrar(std::uint64_t nanos);
+
+    // Número total de amostras
+    std::uint64_t total() const;
+
+    // Maior amostra registrada (ns)
+    std::uint64_t maximo() const;
+
+    // Média das amostras (ns)
+    double media() const;
+
+    /**
+     * Valor (ns) abaixo do qual estão p% das amostras.
+     * Retorna o limite superior da faixa que contém o percentil (estimativa conservadora).
+     * Exemplo: percentil(99.9) -> p999
+     */
+    std::uint64_t percentil(double p) const;
+
+    // Zera todas as contagens
+    void zerar();
+
+private:
+    std::atomic<std::uint64_t> contagens[NUM_FAIXAS];
+    std::atomic<std::uint64_t> numAmostras;
+    std::atomic<std::uint64_t> soma;
+    std::atomic<std::uint64_t> maior;
+
+    // Índice da faixa que contém o valor
+    static int indiceFaixa(std::uint64_t valor);
+
+    // Maior valor contido na faixa
+    static std::uint64_t limiteSuperior(int indice);
+
+    HistogramaLatencia(const HistogramaLatencia&);
+    HistogramaLatencia& operator=(const HistogramaLatencia&);
+};
+
+/**
+ * Conjunto de histogramas, um por operação do Estoque.
+ */
+class MetricasEstoque {
+public:
+    // Nome legível da operação (ex: "registrarSaida")
+    static const char* nomeOperacao(OperacaoEstoque op);
+
+    // Registra a latência de uma operação (sem travas)
+    void registrar(OperacaoEstoque op, std::uint64_t nanos);
+
+    // Histograma de uma operação (somente leitura)
+    const HistogramaLatencia& histograma(OperacaoEstoque op) const;
+
+    /**
+     * Imprime tabela com amostras, média, p50, p99, p999 e máximo (em microssegundos).
+     * Operações sem amostras são omitidas.
+     */
+    void imprimir(std::ostream& saida) const;
+
+    // Zera todos os histogramas
+    void zerar();
+
+private:
+    HistogramaLatencia histogramas[NUM_OPERACOES];
+};
+
+/**
+ * Cronômetro RAII: mede do construtor ao destrutor e registra em MetricasEstoque.
+ * Usado através da macro ESTOQUE_MEDIR.
+ */
+class CronometroOperacao {
+public:
+    CronometroOperacao(MetricasEstoque& metricas, OperacaoEstoque op)
+        : metricas(metricas), op(op), inicio(std::chrono::steady_clock::now()) {}
+
+    ~CronometroOperacao() {
+        std::chrono::steady_clock::duration d = std::chrono::steady_clock::now() - inicio;
+        metricas.registrar(op, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()));
+    }
+
+private:
+    MetricasEstoque& metricas;
+    OperacaoEstoque op;
+    std::chrono::steady_clock::time_point inicio;
+};
+
+// Instrumentação removível em tempo de compilação:
+// compile com -DESTOQUE_SEM_METRICAS para eliminar todo o custo de medição
+#ifdef ESTOQUE_SEM_METRICAS
+#define ESTOQUE_MEDIR(metricas, op) ((void)0)
+#else
+#define ESTOQUE_MEDIR(metricas, op) CronometroOperacao cronometroOperacao_(metricas, op)
+#endif
+
+#endif // METRICASESTOQUE_H
@@ -96,7 +96,7 @@ int MovimentoEstoque::getId() const {
 }
 
 // Retorna a data/hora formatada "YYYY-MM-DD HH:MM:SS"
-std::string MovimentoEstoque::getData() const { 
+const std::string& MovimentoEstoque::getData() const { 
     return data; 
 }
 
@@ -116,10 +116,18 @@ int MovimentoEstoque::getIdItem() const {
 }
 
 // Retorna o nome do item no momento do movimento
-std::string MovimentoEstoque::getNomeItem() const { 
+const std::string& MovimentoEstoque::getNomeItem() const { 
     return nomeItem; 
 }
 
+// Contabiliza objeto e strings (data e nome do item) no relatório de memória
+void MovimentoEstoque::contabilizarMemoria(RelatorioMemoria& relatorio) const {
+    relatorio.numMovimentos++;
+    relatorio.bytesObjetosMovimentos += sizeof(MovimentoEstoque);
+    relatorio.bytesStringsMovimentos += bytesHeapString(data) + bytesHeapString(nomeItem);
+    relatorio.somaTamNomeItemMov += nomeItem.size();
+}
+
 // Define o próximo ID a ser atribuído
 // Essencial na recarga de dados do arquivo para evitar duplicação de IDs
 //
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <ctime> // Para a data
+#include "RelatorioMemoria.h"
 
 // Enumeração que identifica tipo de movimentação
 // ENTRADA: item foi recebido (quantidade aumenta)
@@ -136,8 +137,9 @@ public:
     
     /**
      * Retorna data/hora formatada "YYYY-MM-DD HH:MM:SS".
+     * Referência: sem cópia nos laços sobre o histórico inteiro (relatórios).
      */
-    std::string getData() const;
+    const std::string& getData() const;
     
     /**
      * Retorna tipo da movimentação: ENTRADA ou SAIDA.
@@ -157,7 +159,12 @@ public:
     /**
      * Retorna nome do item no momento do movimento.
      */
-    std::string getNomeItem() const;
+    const std::string& getNomeItem() const;
+
+    /**
+     * Soma no relatório os bytes deste movimento (objeto e strings).
+     */
+    void contabilizarMemoria(RelatorioMemoria& relatorio) const;
 
     /**
      * Define o valor do próximo ID a ser atribuído.
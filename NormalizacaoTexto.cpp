@@ -0,0 +1,47 @@
+// NormalizacaoTexto.cpp - Minúsculas, remoção de acentos e espaços para os índices de busca
+#include "NormalizacaoTexto.h"
+
+using std::string;
+
+// Letra sem acento para o segundo byte de "\xC3 xx" (U+00C0..U+00FF), ou 0 se não é letra acentuada
+// Maiúsculas (0x80..0x9F) e minúsculas (0xA0..0xBF) usam a mesma tabela
+static char letraBase(unsigned char segundo) {
+    static const char TABELA[32] = {
+        'a', 'a', 'a', 'a', 'a', 'a', 0,   'c',   // À Á Â Ã Ä Å Æ Ç
+        'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',   // È É Ê Ë Ì Í Î Ï
+        0,   'n', 'o', 'o', 'o', 'o', 'o', 0,     // Ð Ñ Ò Ó Ô Õ Ö ×
+        0,   'u', 'u', 'u', 'u', 'y', 0,   0      // Ø Ù Ú Û Ü Ý Þ ß
+    };
+    if (segundo < 0x80 || segundo > 0xBF) {
+        return 0;
+    }
+    return TABELA[(segundo - 0x80) & 0x1F];
+}
+
+// Uma passagem, byte a byte, sem alocações além da string de saída
+string normalizarTexto(const string& texto) {
+    string saida;
+    saida.reserve(texto.size());
+    bool espacoPendente = false;
+    for (std::size_t i = 0; i < texto.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(texto[i]);
+        char letra = 0;
+        if (c < 0x80) {
+            if (c >= 'A' && c <= 'Z') letra = static_cast<char>(c - 'A' + 'a');
+            else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) letra = static_cast<char>(c);
+            else { espacoPendente = true; continue; }  // Pontuação/espaço: separador
+        } else if (c == 0xC3 && i + 1 < texto.size() &&
+                   (letra = letraBase(static_cast<unsigned char>(texto[i + 1]))) != 0) {
+            ++i;  // Consumiu os dois bytes da letra acentuada
+        } else {
+            // Outro byte UTF-8: mantido (não há equivalente sem acento)
+            letra = static_cast<char>(c);
+        }
+        if (espacoPendente && !saida.empty()) {
+            saida += ' ';
+        }
+        espacoPendente = false;
+        saida += letra;
+    }
+    return saida;
+}
@@ -0,0 +1,20 @@
+#ifndef NORMALIZACAOTEXTO_H
+#define NORMALIZACAOTEXTO_H
+
+#include <string>
+
+/**
+ * Normaliza texto para busca (nomes e descrições em português).
+ *
+ * - Minúsculas (ASCII)
+ * - Remove acentos do Latin-1 em UTF-8: "Aço" -> "aco", "Válvula" -> "valvula",
+ *   "Pinhão" -> "pinhao", "Ç" -> "c"
+ * - Pontuação e espaços viram um único espaço; sem espaços nas pontas
+ *   ("Parafuso  M4," -> "parafuso m4")
+ * - Demais caracteres não ASCII são mantidos como estão
+ *
+ * Exemplo: normalizarTexto("  Cabo de AÇO-Inox ") == "cabo de aco inox"
+ */
+std::string normalizarTexto(const std::string& texto);
+
+#endif // NORMALIZACAOTEXTO_H
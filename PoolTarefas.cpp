@@ -0,0 +1,244 @@
+// PoolTarefas.cpp - Escalonador com roubo de trabalho compartilhado pelo Estoque
+#include "PoolTarefas.h"
+#include <cstdlib>  // Para std::getenv, std::atoi
+#include <iostream>
+
+using std::size_t;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+
+// Trabalhador em execução nesta thread (submissões internas vão para a própria fila)
+static thread_local const PoolTarefas* poolDaThread = nullptr;
+static thread_local unsigned indiceDaThread = 0;
+
+// Núcleos - 1: o núcleo restante atende o menu/servidor
+static unsigned trabalhadoresPadrao() {
+    unsigned nucleos = std::thread::hardware_concurrency();
+    return nucleos > 1 ? nucleos - 1 : 1;
+}
+
+PoolTarefas::PoolTarefas(unsigned numTrabalhadores)
+    : proximaFila(0), pendentes(0), encerrar(false) {
+    if (numTrabalhadores == 0) {
+        numTrabalhadores = trabalhadoresPadrao();
+    }
+    for (unsigned i = 0; i < numTrabalhadores; ++i) {
+        filas.push_back(std::unique_ptr<FilaTrabalhador>(new FilaTrabalhador()));
+    }
+    // Filas completas antes da primeira thread: trabalhadores roubam de qualquer uma
+    for (unsigned i = 0; i < numTrabalhadores; ++i) {
+        trabalhadores.push_back(std::thread(&PoolTarefas::executarTrabalhador, this, i));
+    }
+}
+
+PoolTarefas::~PoolTarefas() {
+    {
+        lock_guard<mutex> trava(travaSono);
+        encerrar = true;
+    }
+    acordar.notify_all();
+    for (size_t i = 0; i < trabalhadores.size(); ++i) {
+        trabalhadores[i].join();
+    }
+}
+
+// ESTOQUE_THREADS=n define o número de trabalhadores (ausente ou inválido = padrão)
+static unsigned trabalhadoresDoAmbiente() {
+    const char* valor = std::getenv("ESTOQUE_THREADS");
+    int n = valor ? std::atoi(valor) : 0;
+    return n > 0 ? static_cast<unsigned>(n) : 0;
+}
+
+PoolTarefas& PoolTarefas::global() {
+    static PoolTarefas pool(trabalhadoresDoAmbiente());  // Inicialização thread-safe (C++11)
+    return pool;
+}
+
+unsigned PoolTarefas::numTrabalhadores() const {
+    return static_cast<unsigned>(trabalhadores.size());
+}
+
+// O contador sobe antes da tarefa entrar na fila e sob travaSono:
+// um trabalhador prestes a dormir sempre enxerga a submissão
+void PoolTarefas::submeter(const Tarefa& tarefa, PrioridadeTarefa prioridade) {
+    unsigned destino = (poolDaThread == this)
+        ? indiceDaThread
+        : proximaFila.fetch_add(1, std::memory_order_relaxed) % static_cast<unsigned>(filas.size());
+    {
+        lock_guard<mutex> trava(travaSono);
+        pendentes.fetch_add(1);
+    }
+    {
+        lock_guard<mutex> trava(filas[destino]->trava);
+        filas[destino]->filas[prioridade].push_back(tarefa);
+    }
+    acordar.notify_one();
+}
+
+bool PoolTarefas::obterTarefa(unsigned indice, Tarefa& tarefa) {
+    const unsigned n = static_cast<unsigned>(filas.size());
+    for (int p = 0; p < NUM_PRIORIDADES; ++p) {
+        // Própria fila pelo fim (a mais recente)
+        {
+            FilaTrabalhador& propria = *filas[indice];
+            lock_guard<mutex> trava(propria.trava);
+            if (!propria.filas[p].empty()) {
+                tarefa.swap(propria.filas[p].back());
+                propria.filas[p].pop_back();
+                pendentes.fetch_sub(1);
+                return true;
+            }
+        }
+        // Roubo pelo início (a mais antiga), começando pelo vizinho
+        for (unsigned k = 1; k < n; ++k) {
+            FilaTrabalhador& vitima = *filas[(indice + k) % n];
+            lock_guard<mutex> trava(vitima.trava);
+            if (!vitima.filas[p].empty()) {
+                tarefa.swap(vitima.filas[p].front());
+                vitima.filas[p].pop_front();
+                pendentes.fetch_sub(1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void PoolTarefas::executarTrabalhador(unsigned indice) {
+    poolDaThread = this;
+    indiceDaThread = indice;
+    for (;;) {
+        Tarefa tarefa;
+        if (obterTarefa(indice, tarefa)) {
+            try {
+                tarefa();
+            } catch (const std::exception& e) {
+                std::cerr << "Erro em tarefa de fundo: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "Erro em tarefa de fundo." << std::endl;
+            }
+            continue;
+        }
+        unique_lock<mutex> trava(travaSono);
+        acordar.wait(trava, [this]() { return pendentes.load() > 0 || encerrar; });
+        if (encerrar && pendentes.load() == 0) {
+            return;  // Encerramento só depois de esvaziar as filas
+        }
+    }
+}
+
+unsigned PoolTarefas::trechosPara(size_t n, size_t minimoPorTrecho, unsigned pedidos) const {
+    unsigned trechos = pedidos ? pedidos : numTrabalhadores() + 1;
+    if (minimoPorTrecho > 0 && trechos > n / minimoPorTrecho + 1) {
+        trechos = static_cast<unsigned>(n / minimoPorTrecho + 1);  // Lotes pequenos: menos trechos
+    }
+    return trechos;
+}
+
+void PoolTarefas::paraCadaTrecho(size_t n, unsigned trechos,
+                                 const std::function<void(unsigned, size_t, size_t)>& corpo,
+                                 PrioridadeTarefa prioridade) {
+    if (trechos <= 1) {
+        corpo(0, 0, n);
+        return;
+    }
+    GrupoTarefas grupo(*this);
+    for (unsigned t = 1; t < trechos; ++t) {
+        grupo.submeter([&corpo, t, n, trechos]() {
+            corpo(t, n * t / trechos, n * (t + 1) / trechos);
+        }, prioridade);
+    }
+    corpo(0, 0, n / trechos);
+    grupo.aguardar();
+}
+
+// === GRUPO DE TAREFAS ===
+
+// Tarefa do grupo: quem a marcar como iniciada primeiro (trabalhador ou aguardar) executa
+struct GrupoTarefas::Entrada {
+    PoolTarefas::Tarefa tarefa;
+    std::atomic<bool> iniciada;
+
+    explicit Entrada(const PoolTarefas::Tarefa& tarefa) : tarefa(tarefa), iniciada(false) {}
+};
+
+struct GrupoTarefas::Estado {
+    mutex trava;
+    std::condition_variable concluiu;
+    std::vector<std::shared_ptr<Entrada> > entradas;
+    size_t restantes;
+    std::exception_ptr erro;   // Primeira exceção (relançada por aguardar)
+
+    Estado() : restantes(0) {}
+
+    void executar(Entrada& entrada) {
+        if (entrada.iniciada.exchange(true)) {
+            return;  // Já executada (ou em execução) por outra thread
+        }
+        std::exception_ptr falha;
+        try {
+            entrada.tarefa();
+        } catch (...) {
+            falha = std::current_exception();
+        }
+        lock_guard<mutex> guarda(trava);
+        if (falha && !erro) {
+            erro = falha;
+        }
+        if (--restantes == 0) {
+            concluiu.notify_all();
+        }
+    }
+};
+
+GrupoTarefas::GrupoTarefas(PoolTarefas& pool) : pool(pool), estado(new Estado()) {
+}
+
+GrupoTarefas::~GrupoTarefas() {
+    try {
+        aguardar();
+    } catch (...) {
+        // Destrutor não lança: quem quer o erro chama aguardar()
+    }
+}
+
+void GrupoTarefas::submeter(const PoolTarefas::Tarefa& tarefa, PrioridadeTarefa prioridade) {
+    std::shared_ptr<Entrada> entrada(new Entrada(tarefa));
+    {
+        lock_guard<mutex> trava(estado->trava);
+        // Grupos de longa duração (tarefas de fundo do Estoque): descarta as já executadas
+        std::vector<std::shared_ptr<Entrada> >& entradas = estado->entradas;
+        size_t mantidas = 0;
+        for (size_t i = 0; i < entradas.size(); ++i) {
+            if (!entradas[i]->iniciada.load()) entradas[mantidas++] = entradas[i];
+        }
+        entradas.resize(mantidas);
+        entradas.push_back(entrada);
+        ++estado->restantes;
+    }
+    // A tarefa do pool segura o estado: ela pode rodar depois que o grupo acabou
+    std::shared_ptr<Estado> estadoCompartilhado = estado;
+    pool.submeter([estadoCompartilhado, entrada]() {
+        estadoCompartilhado->executar(*entrada);
+    }, prioridade);
+}
+
+void GrupoTarefas::aguardar() {
+    std::vector<std::shared_ptr<Entrada> > entradas;
+    {
+        lock_guard<mutex> trava(estado->trava);
+        entradas.swap(estado->entradas);
+    }
+    // Executa aqui o que nenhum trabalhador pegou (ordem de submissão)
+    for (size_t i = 0; i < entradas.size(); ++i) {
+        estado->executar(*entradas[i]);
+    }
+    unique_lock<mutex> trava(estado->trava);
+    estado->concluiu.wait(trava, [this]() { return estado->restantes == 0; });
+    if (estado->erro) {
+        std::exception_ptr erro = estado->erro;
+        estado->erro = std::exception_ptr();
+        std::rethrow_exception(erro);
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef POOLTAREFAS_H
+#define POOLTAREFAS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Prioridade de uma tarefa do pool. Trabalhadores sempre procuram
+ * (na própria fila e nas dos outros) uma tarefa de prioridade maior
+ * antes de aceitar uma de prioridade menor.
+ */
+enum PrioridadeTarefa {
+    PRIORIDADE_ALTA,     // Segura a trava do Estoque (reconstrução de índices)
+    PRIORIDADE_NORMAL,   // Alguém espera o resultado (carga, importação, relatórios, verificação)
+    PRIORIDADE_BAIXA,    // Fundo: ninguém espera (checkpoint automático)
+    NUM_PRIORIDADES
+};
+
+/**
+ * Escalonador de tarefas com roubo de trabalho (work stealing).
+ *
+ * Cada trabalhador tem uma fila dupla por prioridade:
+ * - tarefas submetidas por um trabalhador vão para a sua própria fila e
+ *   são retiradas pelo fim (LIFO: dados ainda no cache)
+ * - sem tarefa própria, o trabalhador rouba do início da fila de outro (FIFO)
+ * - tarefas submetidas de fora do pool são distribuídas em rodízio
+ *
+ * Um único pool (global()) atende todo o trabalho paralelo do Estoque:
+ * carga, importação, reconstrução de índices, relatórios, verificação e
+ * checkpoint em fundo, sem que cada subsistema crie as próprias threads
+ * e dispute os núcleos com os demais.
+ *
+ * Número de trabalhadores do pool global: variável de ambiente
+ * ESTOQUE_THREADS; sem ela, núcleos - 1 (um núcleo fica livre para o
+ * menu/servidor, que registram as movimentações).
+ *
+ * Exceções de tarefas soltas (submeter) são exibidas em cerr; as de um
+ * GrupoTarefas são relançadas por aguardar().
+ */
+class PoolTarefas {
+public:
+    typedef std::function<void()> Tarefa;
+
+    // numTrabalhadores = 0: núcleos - 1 (mínimo 1)
+    explicit PoolTarefas(unsigned numTrabalhadores = 0);
+
+    // Executa as tarefas pendentes e encerra os trabalhadores
+    ~PoolTarefas();
+
+    // Pool compartilhado do processo (criado no primeiro uso)
+    static PoolTarefas& global();
+
+    unsigned numTrabalhadores() const;
+
+    // Enfileira uma tarefa solta (sem espera pelo resultado)
+    void submeter(const Tarefa& tarefa, PrioridadeTarefa prioridade = PRIORIDADE_NORMAL);
+
+    /**
+     * Em quantos trechos dividir n elementos.
+     *
+     * Parâmetro:
+     *   - minimoPorTrecho: trechos menores não compensam o custo de uma tarefa
+     *   - pedidos: número pedido pelo chamador (0 = trabalhadores + a thread que chama)
+     * Retorna: ao menos 1
+     */
+    unsigned trechosPara(std::size_t n, std::size_t minimoPorTrecho, unsigned pedidos = 0) const;
+
+    /**
+     * Divide [0, n) em 'trechos' partes contíguas e executa
+     * corpo(t, inicio, fim) para cada uma; retorna quando todas terminarem.
+     * A thread que chama executa o trecho 0 e os que ninguém iniciou.
+     *
+     * Lança: a primeira exceção lançada por um trecho
+     */
+    void paraCadaTrecho(std::size_t n, unsigned trechos,
+                        const std::function<void(unsigned, std::size_t, std::size_t)>& corpo,
+                        PrioridadeTarefa prioridade = PRIORIDADE_NORMAL);
+
+private:
+    // Filas de um trabalhador, uma por prioridade (trava própria: roubos não disputam uma trava global)
+    struct FilaTrabalhador {
+        std::mutex trava;
+        std::deque<Tarefa> filas[NUM_PRIORIDADES];
+    };
+
+    void executarTrabalhador(unsigned indice);
+
+    // Próxima tarefa: maior prioridade primeiro; própria fila (fim) antes das outras (início)
+    bool obterTarefa(unsigned indice, Tarefa& tarefa);
+
+    std::vector<std::unique_ptr<FilaTrabalhador> > filas;
+    std::vector<std::thread> trabalhadores;
+    std::atomic<unsigned> proximaFila;   // Rodízio das submissões externas
+    std::atomic<long> pendentes;         // Tarefas enfileiradas e ainda não retiradas
+    std::mutex travaSono;
+    std::condition_variable acordar;
+    bool encerrar;
+
+    // Não copiável: dono das threads
+    PoolTarefas(const PoolTarefas&);
+    PoolTarefas& operator=(const PoolTarefas&);
+};
+
+/**
+ * Conjunto de tarefas submetidas ao pool com espera pelo fim de todas
+ * (fork-join).
+ *
+ * aguardar() executa na própria thread as tarefas do grupo que nenhum
+ * trabalhador iniciou e espera as que estão em andamento. Por isso um
+ * grupo pode ser aguardado de dentro de outra tarefa do pool sem
+ * bloqueio mútuo, e a thread que espera nunca executa tarefas alheias.
+ *
+ * Exemplo:
+ *   GrupoTarefas grupo;
+ *   grupo.submeter([&]() { indiceA.reconstruir(); });
+ *   grupo.submeter([&]() { indiceB.reconstruir(); });
+ *   grupo.aguardar();
+ */
+class GrupoTarefas {
+public:
+    explicit GrupoTarefas(PoolTarefas& pool = PoolTarefas::global());
+
+    // Aguarda as tarefas ainda pendentes (exceções são descartadas)
+    ~GrupoTarefas();
+
+    void submeter(const PoolTarefas::Tarefa& tarefa, PrioridadeTarefa prioridade = PRIORIDADE_NORMAL);
+
+    /**
+     * Retorna quando todas as tarefas submetidas até aqui terminarem.
+     * Lança: a primeira exceção lançada por uma delas
+     */
+    void aguardar();
+
+private:
+    struct Entrada;
+    struct Estado;
+
+    PoolTarefas& pool;
+    std::shared_ptr<Estado> estado;   // Compartilhado com as tarefas enfileiradas
+
+    GrupoTarefas(const GrupoTarefas&);
+    GrupoTarefas& operator=(const GrupoTarefas&);
+};
+
+#endif // POOLTAREFAS_H
@@ -0,0 +1,19 @@
+#ifndef RANKINGESTOQUE_H
+#define RANKINGESTOQUE_H
+
+class Item;
+
+/**
+ * Posição de um item em uma consulta top-K do Estoque
+ * (maioresQuantidades, menoresQuantidades, maioresSaidas).
+ *
+ * valor é a grandeza ordenada: quantidade em estoque ou unidades saídas.
+ * Empates são desfeitos pelo menor ID, para que a ordem seja estável
+ * entre execuções.
+ */
+struct PosicaoRanking {
+    Item* item;
+    long long valor;
+};
+
+#endif // RANKINGESTOQUE_H
@@ -0,0 +1,66 @@
+// RegistroTiposItem.cpp - Tabelas de descritores geradas a partir de RegistroItens
+#include "RegistroTiposItem.h"
+#include <cstring>
+
+// Fábrica genérica: ID > 0 usa o construtor de carga (preserva o ID do arquivo),
+// ID 0 usa o construtor que gera novo ID
+template <typename Traits>
+static Item* criarItem(const CamposItem& c) {
+    typedef typename Traits::Classe Classe;
+    if (c.id > 0) {
+        return new Classe(c.id, c.nome, c.descricao, c.quantidade, c.link, c.detalhe);
+    }
+    return new Classe(c.nome, c.descricao, c.quantidade, c.link, c.detalhe);
+}
+
+// Tabelas preenchidas uma única vez a partir da lista de tipos
+struct TabelasTipos {
+    DescritorTipoItem porTipo[NUM_TIPOS_ITEM];
+    const DescritorTipoItem* porHash[TAMANHO_TABELA_TIPOS];
+
+    TabelasTipos() {
+        for (std::size_t i = 0; i < TAMANHO_TABELA_TIPOS; ++i) {
+            porHash[i] = nullptr;
+        }
+        registrar(static_cast<RegistroItens*>(nullptr));
+    }
+
+    // Percorre a lista de tipos em tempo de compilação (um registrar por tipo)
+    void registrar(RegistroTipos<>*) {}
+
+    template <typename Primeiro, typename... Resto>
+    void registrar(RegistroTipos<Primeiro, Resto...>*) {
+        DescritorTipoItem& d = porTipo[Primeiro::tipo];
+        d.tipo = Primeiro::tipo;
+        d.nome = Primeiro::tag();
+        d.rotuloMenu = Primeiro::rotuloMenu();
+        d.rotuloExibicao = Primeiro::rotuloExibicao();
+        d.rotuloDetalhe = Primeiro::rotuloDetalhe();
+        d.promptDetalhe = Primeiro::promptDetalhe();
+        d.criar = &criarItem<Primeiro>;
+        d.detalhe = &Primeiro::detalhe;
+        porHash[RegistroTipos<Primeiro, Resto...>::posicao()] = &d;
+        registrar(static_cast<RegistroTipos<Resto...>*>(nullptr));
+    }
+};
+
+// Inicialização sob demanda (thread-safe em C++11): válida mesmo durante
+// a construção de objetos estáticos de outras unidades de tradução
+static const TabelasTipos& tabelas() {
+    static const TabelasTipos instancia;
+    return instancia;
+}
+
+const DescritorTipoItem& descritorTipo(TipoItem tipo) {
+    return tabelas().porTipo[tipo];
+}
+
+// Hash -> posição -> confirma a tag (a posição pode conter outro tipo
+// se a tag lida não estiver registrada)
+const DescritorTipoItem* localizarTipo(const char* tag, std::size_t tamanho) {
+    const DescritorTipoItem* d = tabelas().porHash[hashTag(tag, tamanho) % TAMANHO_TABELA_TIPOS];
+    if (d && d->nome.size() == tamanho && std::memcmp(d->nome.data(), tag, tamanho) == 0) {
+        return d;
+    }
+    return nullptr;
+}
@@ -0,0 +1,210 @@
+#ifndef REGISTROTIPOSITEM_H
+#define REGISTROTIPOSITEM_H
+
+#include <string>
+#include <cstdint>
+#include "TipoItem.h"
+#include "Item.h"
+#include "ItemProduto.h"
+#include "ItemMateria.h"
+
+/**
+ * Registro de tipos de item resolvido em tempo de compilação.
+ *
+ * Cada tipo é descrito por uma struct de traits com:
+ *   - Classe: subclasse concreta de Item (construtores (nome, ...) e (id, nome, ...))
+ *   - tipo: etiqueta TipoItem (índice no registro)
+ *   - tag(): texto gravado em itens.txt ("PRODUTO", "MATERIA", ...)
+ *   - rótulos de menu/exibição e prompt do campo específico
+ *   - detalhe(): acesso ao campo específico sem cópia (codec de gravação)
+ *
+ * A partir da lista de tipos (RegistroItens) são gerados:
+ *   - uma tabela de descritores indexada pela etiqueta
+ *   - uma tabela hash perfeita (FNV-1a mod TAMANHO_TABELA_TIPOS) por tag:
+ *     static_assert garante que as tags não colidem; a leitura de um arquivo
+ *     calcula um hash, acessa uma posição e confirma com uma única comparação
+ *
+ * Para adicionar um tipo: criar a subclasse, acrescentar a etiqueta em
+ * TipoItem.h, escrever os traits abaixo e incluí-los em RegistroItens.
+ * Loader, gravação, importador, servidor e menu passam a aceitá-lo.
+ */
+
+// === HASH DAS TAGS ===
+
+// FNV-1a de 32 bits em constexpr (C++11: recursão em vez de laço)
+constexpr std::uint32_t hashTag(const char* s, std::uint32_t h = 2166136261u) {
+    return *s ? hashTag(s + 1, (h ^ static_cast<unsigned char>(*s)) * 16777619u) : h;
+}
+
+// Mesma função para texto com tamanho conhecido (campos lidos de arquivo)
+inline std::uint32_t hashTag(const char* s, std::size_t n) {
+    std::uint32_t h = 2166136261u;
+    for (std::size_t i = 0; i < n; ++i) {
+        h = (h ^ static_cast<unsigned char>(s[i])) * 16777619u;
+    }
+    return h;
+}
+
+// Posições da tabela hash de tags (potência de dois)
+const std::size_t TAMANHO_TABELA_TIPOS = 16;
+
+// === CODEC COMUM ===
+
+// Campos de uma linha TYPE;ID;NAME;DESC;QTY;LINK;DETAIL (sem o tipo)
+struct CamposItem {
+    int id;                  // 0 = gerar novo ID (Item::proximoId)
+    std::string nome;
+    std::string descricao;
+    int quantidade;
+    std::string link;
+    std::string detalhe;     // campo específico do tipo
+};
+
+/**
+ * Descritor de tempo de execução gerado a partir dos traits.
+ */
+struct DescritorTipoItem {
+    TipoItem tipo;
+    std::string nome;                 // tag como std::string (comparada por localizarTipo)
+    const char* rotuloMenu;           // ex: "Produto"
+    const char* rotuloExibicao;       // ex: "PRODUTO" em "ID: 1 (PRODUTO)"
+    const char* rotuloDetalhe;        // ex: "Categoria"
+    const char* promptDetalhe;        // ex: "Categoria do Produto: "
+    Item* (*criar)(const CamposItem& campos);
+    const std::string& (*detalhe)(const Item& item);
+};
+
+// === TRAITS DOS TIPOS ===
+
+struct TraitsProduto {
+    typedef ItemProduto Classe;
+    static const TipoItem tipo = TIPO_PRODUTO;
+    static constexpr const char* tag() { return "PRODUTO"; }
+    static const char* rotuloMenu() { return "Produto"; }
+    static const char* rotuloExibicao() { return "PRODUTO"; }
+    static const char* rotuloDetalhe() { return "Categoria"; }
+    static const char* promptDetalhe() { return "Categoria do Produto: "; }
+    static const std::string& detalhe(const Item& item) {
+        return static_cast<const ItemProduto&>(item).getCategoria();
+    }
+};
+
+struct TraitsMateria {
+    typedef ItemMateria Classe;
+    static const TipoItem tipo = TIPO_MATERIA;
+    static constexpr const char* tag() { return "MATERIA"; }
+    static const char* rotuloMenu() { return "Materia-Prima"; }
+    static const char* rotuloExibicao() { return "MATERIA-PRIMA"; }
+    static const char* rotuloDetalhe() { return "Fornecedor"; }
+    static const char* promptDetalhe() { return "Fornecedor da Materia-Prima: "; }
+    static const std::string& detalhe(const Item& item) {
+        return static_cast<const ItemMateria&>(item).getFornecedor();
+    }
+};
+
+// === LISTA DE TIPOS ===
+
+template <typename... Tipos>
+struct RegistroTipos;
+
+// Caso base: lista vazia
+template <>
+struct RegistroTipos<> {
+    static const std::size_t quantidade = 0;
+    static constexpr bool posicaoLivre(std::size_t) { return true; }
+    static constexpr bool semColisoes() { return true; }
+    static constexpr bool etiquetasEmOrdem(int) { return true; }
+};
+
+// Caso recursivo: primeiro tipo + restante da lista
+template <typename Primeiro, typename... Resto>
+struct RegistroTipos<Primeiro, Resto...> {
+    typedef RegistroTipos<Resto...> Restante;
+    static const std::size_t quantidade = 1 + Restante::quantidade;
+
+    static constexpr std::size_t posicao() {
+        return hashTag(Primeiro::tag()) % TAMANHO_TABELA_TIPOS;
+    }
+    // Nenhum tipo desta lista ocupa a posição p
+    static constexpr bool posicaoLivre(std::size_t p) {
+        return posicao() != p && Restante::posicaoLivre(p);
+    }
+    // Todas as tags caem em posições distintas (hash perfeito)
+    static constexpr bool semColisoes() {
+        return Restante::posicaoLivre(posicao()) && Restante::semColisoes();
+    }
+    // Etiquetas listadas na mesma ordem do enum TipoItem (0, 1, 2, ...)
+    static constexpr bool etiquetasEmOrdem(int esperado) {
+        return Primeiro::tipo == esperado && Restante::etiquetasEmOrdem(esperado + 1);
+    }
+};
+
+// Tipos registrados, na ordem do enum TipoItem
+typedef RegistroTipos<TraitsProduto, TraitsMateria> RegistroItens;
+
+static_assert(RegistroItens::quantidade == NUM_TIPOS_ITEM,
+              "Todo TipoItem precisa de traits em RegistroItens");
+static_assert(RegistroItens::etiquetasEmOrdem(0),
+              "RegistroItens deve seguir a ordem do enum TipoItem");
+static_assert(RegistroItens::semColisoes(),
+              "Tags de tipo colidem na tabela hash: aumente TAMANHO_TABELA_TIPOS");
+
+// === DESPACHO INLINE (caminhos quentes) ===
+
+// Gerado da mesma lista: uma comparação da etiqueta por tipo e static_cast
+// nos traits, expandido no ponto de chamada (sem tabela, guarda estática
+// nem chamada indireta). O último tipo atende sem comparar, como o default
+// de um switch.
+template <typename Registro>
+struct DespachoTipos;
+
+template <typename Ultimo>
+struct DespachoTipos<RegistroTipos<Ultimo> > {
+    static constexpr const char* tag(TipoItem) { return Ultimo::tag(); }
+    static const std::string& detalhe(const Item& item) { return Ultimo::detalhe(item); }
+};
+
+template <typename Primeiro, typename Segundo, typename... Resto>
+struct DespachoTipos<RegistroTipos<Primeiro, Segundo, Resto...> > {
+    typedef DespachoTipos<RegistroTipos<Segundo, Resto...> > Restante;
+
+    static constexpr const char* tag(TipoItem tipo) {
+        return tipo == Primeiro::tipo ? Primeiro::tag() : Restante::tag(tipo);
+    }
+    static const std::string& detalhe(const Item& item) {
+        return item.getTipoItem() == Primeiro::tipo ? Primeiro::detalhe(item) : Restante::detalhe(item);
+    }
+};
+
+// === CONSULTAS ===
+
+/**
+ * Descritor de um tipo pela etiqueta. O(1).
+ * Para menu, exibição e fábricas; nome e detalhe têm acesso inline abaixo.
+ */
+const DescritorTipoItem& descritorTipo(TipoItem tipo);
+
+/**
+ * Localiza o tipo pela tag lida de arquivo/protocolo (ex: "PRODUTO").
+ * Um hash + uma comparação, sem cadeia de if/else.
+ * Retorna: nullptr se a tag não está registrada.
+ */
+const DescritorTipoItem* localizarTipo(const char* tag, std::size_t tamanho);
+
+/**
+ * Nome do tipo usado na persistência ("PRODUTO" / "MATERIA").
+ * Retorna a tag constante dos traits: nenhuma alocação.
+ */
+inline constexpr const char* nomeTipoItem(TipoItem tipo) {
+    return DespachoTipos<RegistroItens>::tag(tipo);
+}
+
+/**
+ * Equivalente não virtual de getDetalheEspecifico(): referência para
+ * o campo específico (categoria, fornecedor, ...) sem cópia.
+ */
+inline const std::string& detalheItem(const Item& item) {
+    return DespachoTipos<RegistroItens>::detalhe(item);
+}
+
+#endif // REGISTROTIPOSITEM_H
@@ -0,0 +1,74 @@
+// RelatorioMemoria.cpp - Formatação do relatório de memória do Estoque
+#include "RelatorioMemoria.h"
+#include <iomanip>
+
+using std::endl;
+
+// Construtor: zera todos os contadores
+RelatorioMemoria::RelatorioMemoria()
+    : numItens(0), numProdutos(0), numMaterias(0),
+      bytesObjetosItens(0), bytesStringsItens(0),
+      somaTamNome(0), somaTamDescricao(0), somaTamLink(0), somaTamDetalhe(0),
+      numMovimentos(0), bytesObjetosMovimentos(0), bytesStringsMovimentos(0), somaTamNomeItemMov(0),
+      tamanhoListaItens(0), capacidadeListaItens(0),
+      tamanhoListaHistorico(0), capacidadeListaHistorico(0),
+      entradasIndices(0), bytesIndices(0), estadosPublicados(0), bytesSnapshots(0),
+      rssBytes(0) {
+}
+
+// Folga das listas: cada posição é um ponteiro (Item* ou MovimentoEstoque*)
+std::size_t RelatorioMemoria::bytesFolgaListas() const {
+    return ((capacidadeListaItens - tamanhoListaItens) +
+            (capacidadeListaHistorico - tamanhoListaHistorico)) * sizeof(void*);
+}
+
+// Total estimado: objetos + strings + vetores das listas + índices + snapshots
+std::size_t RelatorioMemoria::bytesTotal() const {
+    return bytesObjetosItens + bytesStringsItens +
+           bytesObjetosMovimentos + bytesStringsMovimentos +
+           (capacidadeListaItens + capacidadeListaHistorico) * sizeof(void*) +
+           bytesIndices + bytesSnapshots;
+}
+
+// Média segura (0 se não há elementos)
+static double media(std::size_t soma, std::size_t quantidade) {
+    return quantidade ? static_cast<double>(soma) / quantidade : 0.0;
+}
+
+// Escreve o relatório, agrupado por subsistema
+void RelatorioMemoria::imprimir(std::ostream& saida) const {
+    std::ios::fmtflags flags = saida.flags();
+    saida << std::fixed << std::setprecision(1);
+
+    saida << "--- Itens ---" << endl;
+    saida << "Quantidade: " << numItens << " (produtos: " << numProdutos
+          << ", materias: " << numMaterias << ")" << endl;
+    saida << "Bytes em objetos: " << bytesObjetosItens << endl;
+    saida << "Bytes em strings (heap): " << bytesStringsItens << endl;
+    saida << "Tamanho medio - nome: " << media(somaTamNome, numItens)
+          << ", descricao: " << media(somaTamDescricao, numItens)
+          << ", link: " << media(somaTamLink, numItens)
+          << ", detalhe: " << media(somaTamDetalhe, numItens) << endl;
+
+    saida << "--- Historico ---" << endl;
+    saida << "Movimentos: " << numMovimentos << endl;
+    saida << "Bytes em objetos: " << bytesObjetosMovimentos << endl;
+    saida << "Bytes em strings (heap): " << bytesStringsMovimentos << endl;
+    saida << "Tamanho medio - nome do item: " << media(somaTamNomeItemMov, numMovimentos) << endl;
+
+    saida << "--- Listas (tamanho/capacidade) ---" << endl;
+    saida << "itens: " << tamanhoListaItens << "/" << capacidadeListaItens << endl;
+    saida << "historico: " << tamanhoListaHistorico << "/" << capacidadeListaHistorico << endl;
+    saida << "Bytes de folga: " << bytesFolgaListas() << endl;
+
+    saida << "--- Indices e snapshots ---" << endl;
+    saida << "Entradas de indice: " << entradasIndices << " (" << bytesIndices << " bytes)" << endl;
+    saida << "Estados publicados: " << estadosPublicados << " (" << bytesSnapshots << " bytes)" << endl;
+
+    saida << "--- Total ---" << endl;
+    saida << "Estimado: " << bytesTotal() << " bytes" << endl;
+    if (rssBytes) {
+        saida << "Residente (RSS) do processo: " << rssBytes << " bytes" << endl;
+    }
+    saida.flags(flags);
+}
@@ -0,0 +1,80 @@
+#ifndef RELATORIOMEMORIA_H
+#define RELATORIOMEMORIA_H
+
+#include <string>
+#include <ostream>
+
+/**
+ * Retorna os bytes alocados no heap por uma std::string.
+ * Strings curtas ficam no buffer interno (SSO) e não alocam nada;
+ * as demais ocupam capacity() + 1 (terminador).
+ */
+inline std::size_t bytesHeapString(const std::string& s) {
+    const char* dados = s.data();
+    const char* objeto = reinterpret_cast<const char*>(&s);
+    bool interno = (dados >= objeto && dados < objeto + sizeof(std::string));
+    return interno ? 0 : s.capacity() + 1;
+}
+
+/**
+ * Relatório de uso de memória do Estoque, por subsistema.
+ * Gerado por Estoque::gerarRelatorioMemoria().
+ *
+ * Os valores são estimativas a partir de sizeof() e capacity():
+ * não incluem o overhead do alocador (cabeçalhos de bloco, fragmentação).
+ * Para comparação, rssBytes traz a memória residente real do processo
+ * (Linux: /proc/self/statm; 0 em outros sistemas).
+ *
+ * Preenchimento: Item::contabilizarMemoria() e
+ * MovimentoEstoque::contabilizarMemoria() somam seus próprios campos.
+ */
+struct RelatorioMemoria {
+    // === ITENS ===
+    std::size_t numItens;
+    std::size_t numProdutos;
+    std::size_t numMaterias;
+    std::size_t bytesObjetosItens;     // sizeof(ItemProduto/ItemMateria) somados
+    std::size_t bytesStringsItens;     // heap das strings dos itens
+    std::size_t somaTamNome;           // soma de size() para médias
+    std::size_t somaTamDescricao;
+    std::size_t somaTamLink;
+    std::size_t somaTamDetalhe;
+
+    // === HISTÓRICO ===
+    std::size_t numMovimentos;
+    std::size_t bytesObjetosMovimentos;
+    std::size_t bytesStringsMovimentos;
+    std::size_t somaTamNomeItemMov;
+
+    // === CONTÊINERES (ListaGenerica: tamanho x capacidade) ===
+    std::size_t tamanhoListaItens;
+    std::size_t capacidadeListaItens;
+    std::size_t tamanhoListaHistorico;
+    std::size_t capacidadeListaHistorico;
+
+    // === ÍNDICES E CACHE DE SNAPSHOT ===
+    std::size_t entradasIndices;
+    std::size_t bytesIndices;          // estimativa: nós + buckets das tabelas hash
+    std::size_t estadosPublicados;     // EstadoItem mantidos para snapshots
+    std::size_t bytesSnapshots;
+
+    // === PROCESSO ===
+    std::size_t rssBytes;
+
+    // Inicia todos os contadores em zero
+    RelatorioMemoria();
+
+    // Bytes de vetor alocados e não usados (capacidade - tamanho) nas listas
+    std::size_t bytesFolgaListas() const;
+
+    // Soma estimada de todos os subsistemas
+    std::size_t bytesTotal() const;
+
+    /**
+     * Escreve o relatório formatado (uma métrica por linha).
+     * Exemplo: relatorio.imprimir(std::cout);
+     */
+    void imprimir(std::ostream& saida) const;
+};
+
+#endif // RELATORIOMEMORIA_H
@@ -0,0 +1,232 @@
+// RelatoriosEstoque.cpp - Relatórios paralelos sobre o catálogo e o histórico
+#include "RelatoriosEstoque.h"
+#include "EstoqueException.h"
+#include "NormalizacaoTexto.h"
+#include "PoolTarefas.h"
+
+#include <cstdio>
+#include <map>
+
+using std::string;
+using std::vector;
+using std::size_t;
+using std::shared_ptr;
+
+// Trechos menores que isso não compensam uma tarefa
+static const size_t MIN_ITENS_POR_TRECHO = 4096;
+static const size_t MIN_MOVIMENTOS_POR_TRECHO = 65536;
+
+// Construtor: guarda o Estoque consultado e o número de trechos
+RelatoriosEstoque::RelatoriosEstoque(const Estoque& estoque, unsigned numTrechos)
+    : estoque(estoque), numTrechos(numTrechos) {
+}
+
+// "YYYY-MM..." -> YYYY * 100 + MM, sem alocar; -1 se o início não tiver esse formato
+static int chaveMes(const string& data) {
+    if (data.size() < 7 || data[4] != '-') {
+        return -1;
+    }
+    int valor = 0;
+    for (int i = 0; i < 7; ++i) {
+        if (i == 4) continue;
+        char c = data[i];
+        if (c < '0' || c > '9') return -1;
+        valor = valor * 10 + (c - '0');
+    }
+    return valor;
+}
+
+static string formatarMes(int chave) {
+    if (chave < 0) {
+        return "invalida";
+    }
+    char texto[16];
+    std::snprintf(texto, sizeof(texto), "%04d-%02d", chave / 100, chave % 100);
+    return texto;
+}
+
+static FluxoMovimentos fluxoVazio(const string& chave) {
+    FluxoMovimentos f = { chave, 0, 0, 0, 0 };
+    return f;
+}
+
+static void somarMovimento(FluxoMovimentos& fluxo, const MovimentoEstoque* mov) {
+    if (mov->getTipo() == ENTRADA) {
+        ++fluxo.numEntradas;
+        fluxo.quantidadeEntradas += mov->getQuantidade();
+    } else {
+        ++fluxo.numSaidas;
+        fluxo.quantidadeSaidas += mov->getQuantidade();
+    }
+}
+
+static void juntarFluxo(FluxoMovimentos& destino, const FluxoMovimentos& parcial) {
+    destino.numEntradas += parcial.numEntradas;
+    destino.numSaidas += parcial.numSaidas;
+    destino.quantidadeEntradas += parcial.quantidadeEntradas;
+    destino.quantidadeSaidas += parcial.quantidadeSaidas;
+}
+
+// === ESTOQUE POR GRUPO ===
+
+// (tipo, detalhe normalizado): ordem do resultado
+typedef std::pair<int, string> ChaveGrupo;
+typedef std::map<ChaveGrupo, EstoquePorGrupo> MapaGrupos;
+
+vector<EstoquePorGrupo> RelatoriosEstoque::estoquePorGrupo() {
+    shared_ptr<const SnapshotEstoque> snapshot = estoque.obterSnapshot();
+    const vector<shared_ptr<const EstadoItem> >& itens = snapshot->getItens();
+    PoolTarefas& pool = PoolTarefas::global();
+    unsigned trechos = pool.trechosPara(itens.size(), MIN_ITENS_POR_TRECHO, numTrechos);
+
+    // Normalização (a parte cara) em paralelo, um mapa por trecho
+    vector<MapaGrupos> parciais(trechos);
+    pool.paraCadaTrecho(itens.size(), trechos, [&](unsigned t, size_t inicio, size_t fim) {
+        MapaGrupos& grupos = parciais[t];
+        for (size_t i = inicio; i < fim; ++i) {
+            const EstadoItem& item = *itens[i];
+            ChaveGrupo chave(item.tipo, normalizarTexto(item.detalhe));
+            MapaGrupos::iterator it = grupos.find(chave);
+            if (it == grupos.end()) {
+                EstoquePorGrupo novo = { item.tipo, item.detalhe, 0, 0 };
+                it = grupos.insert(std::make_pair(chave, novo)).first;
+            }
+            ++it->second.itens;
+            it->second.quantidade += item.quantidade;
+        }
+    });
+
+    // Consolidação na ordem dos trechos: o nome vem do primeiro item cadastrado
+    MapaGrupos total;
+    for (unsigned t = 0; t < trechos; ++t) {
+        for (MapaGrupos::const_iterator it = parciais[t].begin(); it != parciais[t].end(); ++it) {
+            MapaGrupos::iterator destino = total.find(it->first);
+            if (destino == total.end()) {
+                total.insert(*it);
+            } else {
+                destino->second.itens += it->second.itens;
+                destino->second.quantidade += it->second.quantidade;
+            }
+        }
+    }
+
+    vector<EstoquePorGrupo> resultado;
+    resultado.reserve(total.size());
+    for (MapaGrupos::const_iterator it = total.begin(); it != total.end(); ++it) {
+        resultado.push_back(it->second);
+    }
+    return resultado;
+}
+
+// === MOVIMENTOS POR MÊS ===
+
+vector<FluxoMovimentos> RelatoriosEstoque::movimentosPorMes() {
+    shared_ptr<const SnapshotEstoque> snapshot = estoque.obterSnapshot();
+    const size_t n = snapshot->tamanhoHistorico();
+    PoolTarefas& pool = PoolTarefas::global();
+    unsigned trechos = pool.trechosPara(n, MIN_MOVIMENTOS_POR_TRECHO, numTrechos);
+
+    // Chave inteira YYYYMM: sem montar string por movimento
+    typedef std::map<int, FluxoMovimentos> MapaMeses;
+    vector<MapaMeses> parciais(trechos);
+    pool.paraCadaTrecho(n, trechos, [&](unsigned t, size_t inicio, size_t fim) {
+        MapaMeses& meses = parciais[t];
+        int mesAtual = -2;  // Histórico em ordem de data: o mês muda raramente
+        FluxoMovimentos* fluxo = nullptr;
+        for (size_t i = inicio; i < fim; ++i) {
+            const MovimentoEstoque* mov = snapshot->movimento(i);
+            int mes = chaveMes(mov->getData());
+            if (mes != mesAtual) {
+                MapaMeses::iterator it = meses.find(mes);
+                if (it == meses.end()) {
+                    it = meses.insert(std::make_pair(mes, fluxoVazio(string()))).first;
+                }
+                fluxo = &it->second;
+                mesAtual = mes;
+            }
+            somarMovimento(*fluxo, mov);
+        }
+    });
+
+    MapaMeses total;
+    for (unsigned t = 0; t < trechos; ++t) {
+        for (MapaMeses::const_iterator it = parciais[t].begin(); it != parciais[t].end(); ++it) {
+            MapaMeses::iterator destino = total.find(it->first);
+            if (destino == total.end()) {
+                destino = total.insert(std::make_pair(it->first, fluxoVazio(formatarMes(it->first)))).first;
+            }
+            juntarFluxo(destino->second, it->second);
+        }
+    }
+
+    vector<FluxoMovimentos> resultado;
+    resultado.reserve(total.size());
+    for (MapaMeses::const_iterator it = total.begin(); it != total.end(); ++it) {
+        resultado.push_back(it->second);
+    }
+    return resultado;
+}
+
+// === FLUXO POR FORNECEDOR ===
+
+vector<FluxoMovimentos> RelatoriosEstoque::fluxoPorFornecedor(const string& mes) {
+    int filtroMes = 0;
+    if (!mes.empty()) {
+        filtroMes = chaveMes(mes);
+        if (mes.size() != 7 || filtroMes < 0 || filtroMes % 100 < 1 || filtroMes % 100 > 12) {
+            throw EstoqueException("Mes invalido (use YYYY-MM): " + mes);
+        }
+    }
+
+    shared_ptr<const SnapshotEstoque> snapshot = estoque.obterSnapshot();
+    const vector<shared_ptr<const EstadoItem> >& itens = snapshot->getItens();
+
+    // Fornecedor de cada ID em vetor denso: consulta sem hash no laço dos movimentos
+    int maiorId = 0;
+    for (size_t i = 0; i < itens.size(); ++i) {
+        if (itens[i]->id > maiorId) maiorId = itens[i]->id;
+    }
+    vector<int> grupoPorId(maiorId + 1, -1);
+    std::map<string, int> grupoPorNome;  // Nome normalizado -> índice (ordem do resultado)
+    vector<string> nomes;
+    for (size_t i = 0; i < itens.size(); ++i) {
+        const EstadoItem& item = *itens[i];
+        if (item.tipo != TIPO_MATERIA) continue;
+        std::pair<std::map<string, int>::iterator, bool> inserido =
+            grupoPorNome.insert(std::make_pair(normalizarTexto(item.detalhe), static_cast<int>(nomes.size())));
+        if (inserido.second) {
+            nomes.push_back(item.detalhe);  // Primeiro item cadastrado dá o nome
+        }
+        grupoPorId[item.id] = inserido.first->second;
+    }
+
+    const size_t n = snapshot->tamanhoHistorico();
+    PoolTarefas& pool = PoolTarefas::global();
+    unsigned trechos = pool.trechosPara(n, MIN_MOVIMENTOS_POR_TRECHO, numTrechos);
+    vector<vector<FluxoMovimentos> > parciais(trechos, vector<FluxoMovimentos>(nomes.size(), fluxoVazio(string())));
+    pool.paraCadaTrecho(n, trechos, [&](unsigned t, size_t inicio, size_t fim) {
+        vector<FluxoMovimentos>& fluxos = parciais[t];
+        for (size_t i = inicio; i < fim; ++i) {
+            const MovimentoEstoque* mov = snapshot->movimento(i);
+            int id = mov->getIdItem();
+            if (id < 0 || id > maiorId || grupoPorId[id] < 0) {
+                continue;  // Produto ou item removido
+            }
+            if (filtroMes && chaveMes(mov->getData()) != filtroMes) {
+                continue;
+            }
+            somarMovimento(fluxos[grupoPorId[id]], mov);
+        }
+    });
+
+    vector<FluxoMovimentos> resultado;
+    resultado.reserve(nomes.size());
+    for (std::map<string, int>::const_iterator it = grupoPorNome.begin(); it != grupoPorNome.end(); ++it) {
+        FluxoMovimentos fluxo = fluxoVazio(nomes[it->second]);
+        for (unsigned t = 0; t < trechos; ++t) {
+            juntarFluxo(fluxo, parciais[t][it->second]);
+        }
+        resultado.push_back(fluxo);
+    }
+    return resultado;
+}
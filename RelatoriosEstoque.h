@@ -0,0 +1,93 @@
+#ifndef RELATORIOSESTOQUE_H
+#define RELATORIOSESTOQUE_H
+
+#include "Estoque.h"
+#include <string>
+#include <vector>
+
+/**
+ * Quantidade em estoque de um grupo de itens:
+ * categoria (produtos) ou fornecedor (matérias-primas).
+ */
+struct EstoquePorGrupo {
+    TipoItem tipo;           // TIPO_PRODUTO ou TIPO_MATERIA
+    std::string grupo;       // Nome como foi cadastrado no primeiro item do grupo
+    std::size_t itens;
+    long long quantidade;    // Soma das quantidades dos itens
+};
+
+/**
+ * Entradas e saídas agregadas por uma chave (mês "YYYY-MM" ou fornecedor).
+ */
+struct FluxoMovimentos {
+    std::string chave;
+    std::size_t numEntradas;
+    std::size_t numSaidas;
+    long long quantidadeEntradas;
+    long long quantidadeSaidas;
+
+    // Fluxo líquido: unidades que entraram menos as que saíram
+    long long saldo() const {
+        return quantidadeEntradas - quantidadeSaidas;
+    }
+};
+
+/**
+ * Relatórios que percorrem o catálogo inteiro ou o histórico inteiro,
+ * divididos entre os trabalhadores do pool global (PoolTarefas.h).
+ *
+ * Processo (cada relatório):
+ * 1. Estoque::obterSnapshot(): visão consistente; movimentações continuam
+ *    sendo registradas durante o relatório
+ * 2. Divide itens ou movimentos em trechos contíguos (PoolTarefas::paraCadaTrecho)
+ * 3. Cada trecho é agregado em acumuladores próprios (sem travas)
+ * 4. Consolida os parciais na ordem dos trechos; resultado ordenado pela chave
+ *
+ * Determinismo: somas inteiras e nome de cada grupo tomado do primeiro item
+ * em ordem de cadastro; o resultado não depende do número de trechos.
+ *
+ * Agrupamento por categoria/fornecedor ignora maiúsculas e acentos
+ * (mesma regra de Estoque::agruparPorCategoria).
+ *
+ * Exemplo:
+ *   RelatoriosEstoque relatorios(estoque);
+ *   std::vector<FluxoMovimentos> meses = relatorios.movimentosPorMes();
+ */
+class RelatoriosEstoque {
+private:
+    // Estoque consultado (não pertence aos relatórios)
+    const Estoque& estoque;
+
+    // Número de trechos (0 = trabalhadores do pool + a thread que chama)
+    unsigned numTrechos;
+
+public:
+    RelatoriosEstoque(const Estoque& estoque, unsigned numTrechos = 0);
+
+    /**
+     * Itens e quantidade total por categoria (produtos) e por fornecedor
+     * (matérias-primas). Ordem: tipo, depois nome do grupo.
+     */
+    std::vector<EstoquePorGrupo> estoquePorGrupo();
+
+    /**
+     * Entradas e saídas de cada mês do histórico (inclui o histórico
+     * ainda não carregado). Ordem cronológica; chave "YYYY-MM".
+     */
+    std::vector<FluxoMovimentos> movimentosPorMes();
+
+    /**
+     * Fluxo de cada fornecedor: movimentos das matérias-primas cadastradas,
+     * agrupados pelo fornecedor atual do item. Ordem por nome do fornecedor.
+     *
+     * Parâmetro:
+     *   - mes: "YYYY-MM" para o fechamento de um mês; vazio = histórico inteiro
+     *
+     * Movimentos de itens removidos ou de produtos não entram no relatório.
+     *
+     * Lança: EstoqueException se mes não estiver no formato YYYY-MM
+     */
+    std::vector<FluxoMovimentos> fluxoPorFornecedor(const std::string& mes = "");
+};
+
+#endif // RELATORIOSESTOQUE_H
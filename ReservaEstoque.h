@@ -0,0 +1,24 @@
+#ifndef RESERVAESTOQUE_H
+#define RESERVAESTOQUE_H
+
+#include <chrono>
+
+class Item;
+
+/**
+ * Reserva de estoque: quantidade presa para um pedido, ainda não retirada.
+ *
+ * Criada por Estoque::reservar(); termina em confirmarReserva() (vira SAIDA),
+ * liberarReserva() ou expirarReservas(). Mantida apenas em memória: reservas
+ * não são gravadas em arquivo e somem ao reiniciar (o saldo gravado é a
+ * quantidade em estoque, que já inclui a parte reservada).
+ */
+struct ReservaEstoque {
+    int id;                                          // Identificador da reserva
+    int idItem;                                      // Item reservado
+    Item* item;                                      // Fixado: removerItem recusa itens com saldo reservado
+    int quantidade;                                  // Unidades reservadas
+    std::chrono::steady_clock::time_point criadaEm;  // Para expiração
+};
+
+#endif // RESERVAESTOQUE_H
@@ -0,0 +1,585 @@
+// ServidorEstoque.cpp - Servidor residente do Estoque via socket Unix
+// Mantém o Estoque em memória e atende o protocolo de linha descrito em ServidorEstoque.h
+#include "ServidorEstoque.h"
+#include "EstoqueException.h"
+#include "RegistroTiposItem.h"
+#include "RelatoriosEstoque.h"
+#include "PoolTarefas.h"
+
+#include <iostream>
+#include <sstream>
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+using std::string;
+using std::vector;
+using std::stringstream;
+using std::ostringstream;
+using std::to_string;
+using std::cerr;
+using std::endl;
+
+// Maior linha incompleta aceita de um cliente (sem '\n'); acima disso a conexão é encerrada
+static const std::size_t TAMANHO_MAXIMO_LINHA = 64 * 1024;
+
+// Comandos proporcionais ao histórico ou ao catálogo: executados no pool
+static bool comandoDemorado(const string& linha) {
+    string comando = linha.substr(0, linha.find(';'));
+    return comando == "COMPACTAR" || comando == "RELATORIO" || comando == "SAVE" || comando == "CHECKPOINT";
+}
+
+// Separa uma linha do protocolo em campos delimitados por ';'
+static vector<string> separarCampos(const string& linha) {
+    vector<string> campos;
+    stringstream ss(linha);
+    string campo;
+    while (std::getline(ss, campo, ';')) {
+        campos.push_back(campo);
+    }
+    return campos;
+}
+
+// Formata um item no mesmo layout de uma linha de itens.txt
+static string formatarItem(const Item* item) {
+    ostringstream oss;
+    oss << nomeTipoItem(item->getTipoItem()) << ";" << item->getId() << ";" << item->getNome() << ";"
+        << item->getDescricao() << ";" << item->getQuantidade() << ";"
+        << item->getLink() << ";" << detalheItem(*item);
+    return oss.str();
+}
+
+// Resposta "*<n>" + uma linha formatarItem por item
+static string listaDeItens(const vector<Item*>& itens) {
+    ostringstream oss;
+    oss << "*" << itens.size() << "\n";
+    for (std::size_t i = 0; i < itens.size(); ++i) {
+        oss << formatarItem(itens[i]) << "\n";
+    }
+    return oss.str();
+}
+
+// Resposta "*<n>" + uma linha NOME;QTD_ITENS por grupo
+static string listaDeGrupos(const vector<GrupoItens>& grupos) {
+    ostringstream oss;
+    oss << "*" << grupos.size() << "\n";
+    for (std::size_t i = 0; i < grupos.size(); ++i) {
+        oss << grupos[i].nome << ";" << grupos[i].itens.size() << "\n";
+    }
+    return oss.str();
+}
+
+// Resposta "*<n>" + uma linha ID;NOME;VALOR por posição do ranking
+static string listaDeRanking(const vector<PosicaoRanking>& ranking) {
+    ostringstream oss;
+    oss << "*" << ranking.size() << "\n";
+    for (std::size_t i = 0; i < ranking.size(); ++i) {
+        oss << ranking[i].item->getId() << ";" << ranking[i].item->getNome() << ";" << ranking[i].valor << "\n";
+    }
+    return oss.str();
+}
+
+// Resposta "*<n>" + uma linha CHAVE;ENTRADAS;UNID_ENTRADAS;SAIDAS;UNID_SAIDAS;SALDO por linha do relatório
+static string listaDeFluxos(const vector<FluxoMovimentos>& fluxos) {
+    ostringstream oss;
+    oss << "*" << fluxos.size() << "\n";
+    for (std::size_t i = 0; i < fluxos.size(); ++i) {
+        const FluxoMovimentos& f = fluxos[i];
+        oss << f.chave << ";" << f.numEntradas << ";" << f.quantidadeEntradas << ";"
+            << f.numSaidas << ";" << f.quantidadeSaidas << ";" << f.saldo() << "\n";
+    }
+    return oss.str();
+}
+
+// Converte um texto de várias linhas em resposta "*<n>" + n linhas
+static string comoLinhas(const string& texto) {
+    std::size_t linhas = 0;
+    for (std::size_t i = 0; i < texto.size(); ++i) {
+        if (texto[i] == '\n') ++linhas;
+    }
+    return "*" + to_string(linhas) + "\n" + texto;
+}
+
+// Construtor: apenas guarda parâmetros; socket aberto em iniciar()
+ServidorEstoque::ServidorEstoque(Estoque& estoque, const string& caminhoSocket)
+    : estoque(estoque), caminhoSocket(caminhoSocket), fdEscuta(-1), encerrar(false), tarefasEmAndamento(0) {
+    fdAviso[0] = fdAviso[1] = -1;
+}
+
+// Destrutor: fecha clientes e socket de escuta, remove o arquivo do socket
+ServidorEstoque::~ServidorEstoque() {
+    for (std::size_t i = 0; i < conexoes.size(); ++i) {
+        close(conexoes[i].fd);
+    }
+    if (fdEscuta >= 0) {
+        close(fdEscuta);
+        unlink(caminhoSocket.c_str());
+    }
+    for (int i = 0; i < 2; ++i) {
+        if (fdAviso[i] >= 0) close(fdAviso[i]);
+    }
+}
+
+// Endereço Unix do caminho
+// Lança: EstoqueException se o caminho não cabe em sun_path
+static sockaddr_un montarEndereco(const string& caminho) {
+    sockaddr_un endereco;
+    std::memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (caminho.size() >= sizeof(endereco.sun_path)) {
+        throw EstoqueException("Caminho de socket muito longo: " + caminho);
+    }
+    std::strncpy(endereco.sun_path, caminho.c_str(), sizeof(endereco.sun_path) - 1);
+    return endereco;
+}
+
+// Só remove o que for comprovadamente um socket abandonado:
+// arquivo comum, diretório ou link nunca são apagados, e um servidor
+// que ainda atende no caminho não perde o seu socket
+void ServidorEstoque::prepararCaminho(const string& caminhoSocket) {
+    sockaddr_un endereco = montarEndereco(caminhoSocket);
+
+    struct stat info;
+    if (lstat(caminhoSocket.c_str(), &info) < 0) {
+        if (errno == ENOENT) return;  // Caminho livre
+        throw EstoqueException("Nao foi possivel verificar " + caminhoSocket + ": " + std::strerror(errno));
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        throw EstoqueException(caminhoSocket + " existe e nao e um socket; escolha outro caminho.");
+    }
+
+    int sonda = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sonda < 0) {
+        throw EstoqueException(string("Nao foi possivel criar o socket: ") + std::strerror(errno));
+    }
+    int resultado = connect(sonda, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco));
+    int erroConexao = errno;
+    close(sonda);
+    if (resultado == 0) {
+        throw EstoqueException("Ja existe um servidor ativo em " + caminhoSocket + ".");
+    }
+    if (erroConexao != ECONNREFUSED && erroConexao != ENOENT) {
+        throw EstoqueException("Nao foi possivel verificar " + caminhoSocket + ": " + std::strerror(erroConexao));
+    }
+    unlink(caminhoSocket.c_str());  // Ninguém escuta: servidor anterior encerrado sem remover
+}
+
+// Cria o socket Unix em modo não bloqueante e começa a escutar
+void ServidorEstoque::iniciar() {
+    prepararCaminho(caminhoSocket);
+    sockaddr_un endereco = montarEndereco(caminhoSocket);
+
+    fdEscuta = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fdEscuta < 0) {
+        throw EstoqueException(string("Nao foi possivel criar o socket: ") + std::strerror(errno));
+    }
+
+    if (bind(fdEscuta, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0 ||
+        listen(fdEscuta, 64) < 0) {
+        string erro = std::strerror(errno);
+        close(fdEscuta);
+        fdEscuta = -1;
+        throw EstoqueException("Nao foi possivel escutar em " + caminhoSocket + ": " + erro);
+    }
+    fcntl(fdEscuta, F_SETFL, fcntl(fdEscuta, F_GETFL, 0) | O_NONBLOCK);
+
+    if (pipe(fdAviso) < 0) {
+        throw EstoqueException(string("Nao foi possivel criar o pipe de aviso: ") + std::strerror(errno));
+    }
+    for (int i = 0; i < 2; ++i) {
+        fcntl(fdAviso[i], F_SETFL, fcntl(fdAviso[i], F_GETFL, 0) | O_NONBLOCK);
+    }
+}
+
+// Pede encerramento: o laço termina na próxima volta do poll()
+void ServidorEstoque::parar() {
+    encerrar = true;
+}
+
+// Descarta o que o cliente já enviou (limitado a 1 MiB) antes de fechar:
+// em socket Unix, fechar com dados não lidos faz o cliente receber
+// ECONNRESET e perder a última resposta (ex: "ERRO linha muito longa")
+static void descartarEntrada(int fd) {
+    char buffer[4096];
+    std::size_t total = 0;
+    ssize_t lidos;
+    while (total < (1u << 20) && (lidos = read(fd, buffer, sizeof(buffer))) > 0) {
+        total += static_cast<std::size_t>(lidos);
+    }
+}
+
+// Laço principal com poll():
+// - socket de escuta: aceita novos clientes
+// - pipe de aviso: alguma tarefa do pool terminou
+// - clientes: lê comandos (POLLIN) e envia respostas pendentes (POLLOUT)
+void ServidorEstoque::executar() {
+    while (!encerrar) {
+        vector<pollfd> fds;
+        fds.reserve(conexoes.size() + 2);
+        pollfd escuta = { fdEscuta, POLLIN, 0 };
+        fds.push_back(escuta);
+        pollfd aviso = { fdAviso[0], POLLIN, 0 };
+        fds.push_back(aviso);
+        for (std::size_t i = 0; i < conexoes.size(); ++i) {
+            pollfd p = { conexoes[i].fd, 0, 0 };
+            if (!conexoes[i].adiada && !conexoes[i].fecharAposEnvio) {
+                p.events |= POLLIN;  // Com comando no pool, o resto fica no socket
+            }
+            if (!conexoes[i].saida.empty()) {
+                p.events |= POLLOUT;  // Há resposta pendente
+            }
+            fds.push_back(p);
+        }
+
+        if (poll(&fds[0], fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;  // Sinal: reavalia 'encerrar'
+            cerr << "Erro em poll(): " << std::strerror(errno) << endl;
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            char descarte[64];
+            while (read(fdAviso[0], descarte, sizeof(descarte)) > 0) {
+            }
+        }
+
+        // Clientes existentes (percorridos de trás para frente para remover com segurança)
+        for (std::size_t i = conexoes.size(); i-- > 0; ) {
+            short eventos = fds[i + 2].revents;
+            bool ativo = true;
+            Conexao& conexao = conexoes[i];
+            if (conexao.adiada && conexao.adiada->pronta) {
+                conexao.saida += conexao.adiada->texto;
+                conexao.adiada.reset();
+                processarLinhas(conexao);  // Linhas que esperavam a resposta
+            }
+            if (conexao.adiada) {
+                if (eventos & (POLLHUP | POLLERR)) {
+                    ativo = false;  // Cliente saiu; a tarefa termina sem ninguém para responder
+                }
+            } else if (eventos & (POLLIN | POLLHUP | POLLERR)) {
+                ativo = lerCliente(conexao);
+            }
+            if (ativo && !conexao.saida.empty()) {
+                ativo = escreverCliente(conexao);
+            }
+            if (ativo && conexao.fecharAposEnvio && conexao.saida.empty()) {
+                ativo = false;
+            }
+            if (!ativo) {
+                if (conexao.fecharAposEnvio) {
+                    descartarEntrada(conexao.fd);
+                }
+                close(conexoes[i].fd);
+                conexoes.erase(conexoes.begin() + i);
+            }
+        }
+
+        // Novas conexões
+        if (fds[0].revents & POLLIN) {
+            int fdCliente;
+            while ((fdCliente = accept(fdEscuta, nullptr, nullptr)) >= 0) {
+                fcntl(fdCliente, F_SETFL, fcntl(fdCliente, F_GETFL, 0) | O_NONBLOCK);
+                Conexao conexao;
+                conexao.fd = fdCliente;
+                conexoes.push_back(conexao);
+            }
+        }
+    }
+
+    // As tarefas usam este objeto (processarComando, pipe de aviso)
+    std::unique_lock<std::mutex> trava(mutexTarefas);
+    fimTarefas.wait(trava, [this]() { return tarefasEmAndamento == 0; });
+}
+
+// Lê os bytes disponíveis e processa cada linha completa (pipelining)
+// Lê no máximo até passar de TAMANHO_MAXIMO_LINHA: o restante continua no
+// socket e chega na próxima volta do poll()
+bool ServidorEstoque::lerCliente(Conexao& conexao) {
+    char buffer[4096];
+    while (conexao.entrada.size() <= TAMANHO_MAXIMO_LINHA) {
+        ssize_t lidos = read(conexao.fd, buffer, sizeof(buffer));
+        if (lidos > 0) {
+            conexao.entrada.append(buffer, static_cast<std::size_t>(lidos));
+            continue;
+        }
+        if (lidos == 0) {
+            return false;  // Cliente fechou a conexão
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;  // Nada mais por agora
+        return false;
+    }
+    processarLinhas(conexao);
+    return true;
+}
+
+// Processa as linhas completas, na ordem em que chegaram
+// Comando demorado: vai para o pool e as linhas seguintes esperam a resposta
+void ServidorEstoque::processarLinhas(Conexao& conexao) {
+    std::size_t inicio = 0;
+    std::size_t fim;
+    while (!encerrar && !conexao.adiada && (fim = conexao.entrada.find('\n', inicio)) != string::npos) {
+        string linha = conexao.entrada.substr(inicio, fim - inicio);
+        if (!linha.empty() && linha[linha.size() - 1] == '\r') {
+            linha.erase(linha.size() - 1);  // Aceita clientes que enviam CRLF
+        }
+        if (linha.empty()) {
+            // Linha em branco: ignorada
+        } else if (comandoDemorado(linha)) {
+            adiarComando(conexao, linha);
+        } else {
+            conexao.saida += processarComando(linha);
+        }
+        inicio = fim + 1;
+    }
+    conexao.entrada.erase(0, inicio);  // Mantém o que ainda não foi processado
+
+    // Sem comando no pool, só resta a linha incompleta
+    if (!conexao.adiada && conexao.entrada.size() > TAMANHO_MAXIMO_LINHA) {
+        conexao.saida += "ERRO linha muito longa (maximo " + to_string(TAMANHO_MAXIMO_LINHA) + " bytes)\n";
+        conexao.entrada.clear();
+        conexao.fecharAposEnvio = true;
+    }
+}
+
+// Executa o comando no pool compartilhado; ao terminar, a tarefa preenche
+// a resposta e acorda o poll() pelo pipe de aviso
+void ServidorEstoque::adiarComando(Conexao& conexao, const string& linha) {
+    std::shared_ptr<RespostaAdiada> resposta = std::make_shared<RespostaAdiada>();
+    conexao.adiada = resposta;
+    {
+        std::lock_guard<std::mutex> trava(mutexTarefas);
+        ++tarefasEmAndamento;
+    }
+    PoolTarefas::global().submeter([this, resposta, linha]() {
+        resposta->texto = processarComando(linha);  // Exceções já viram "ERRO ..."
+        resposta->pronta = true;
+        char sinal = 1;
+        if (write(fdAviso[1], &sinal, 1) < 0) {
+            // Pipe cheio: o laço já tem avisos pendentes para ler
+        }
+        std::lock_guard<std::mutex> trava(mutexTarefas);
+        --tarefasEmAndamento;
+        fimTarefas.notify_all();
+    });
+}
+
+// Escreve o máximo possível do buffer de saída sem bloquear
+bool ServidorEstoque::escreverCliente(Conexao& conexao) {
+    while (!conexao.saida.empty()) {
+        ssize_t escritos = write(conexao.fd, conexao.saida.data(), conexao.saida.size());
+        if (escritos > 0) {
+            conexao.saida.erase(0, static_cast<std::size_t>(escritos));
+            continue;
+        }
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;  // POLLOUT depois
+        return false;
+    }
+    return true;
+}
+
+// Interpreta e executa um comando do protocolo
+// Exceções de negócio (EstoqueException) e de conversão viram "ERRO <mensagem>"
+string ServidorEstoque::processarComando(const string& linha) {
+    vector<string> campos = separarCampos(linha);
+    if (campos.empty()) {
+        return "ERRO comando vazio\n";
+    }
+    const string& comando = campos[0];
+
+    try {
+        if (comando == "PING") {
+            return "OK PONG\n";
+        } else if (comando == "ADD" && campos.size() == 7) {
+            const DescritorTipoItem* descritor = localizarTipo(campos[1].data(), campos[1].size());
+            if (!descritor) {
+                return "ERRO tipo desconhecido: " + campos[1] + "\n";
+            }
+            CamposItem dados;
+            dados.id = 0;  // Novo ID
+            dados.nome = campos[2];
+            dados.descricao = campos[3];
+            dados.quantidade = std::stoi(campos[4]);
+            dados.link = campos[5];
+            dados.detalhe = campos[6];
+            Item* item = descritor->criar(dados);
+            estoque.adicionarItem(item);
+            return "OK " + to_string(item->getId()) + "\n";
+        } else if (comando == "DEL" && campos.size() == 2) {
+            estoque.removerItem(std::stoi(campos[1]));
+            return "OK\n";
+        } else if (comando == "GET" && campos.size() == 2) {
+            return "OK " + formatarItem(estoque.buscarItemPorId(std::stoi(campos[1]))) + "\n";
+        } else if (comando == "ENTRADA" && campos.size() == 3) {
+            int id = std::stoi(campos[1]);
+            estoque.registrarEntrada(id, std::stoi(campos[2]));
+            return "OK " + to_string(estoque.buscarItemPorId(id)->getQuantidade()) + "\n";
+        } else if (comando == "SAIDA" && campos.size() == 3) {
+            int id = std::stoi(campos[1]);
+            estoque.registrarSaida(id, std::stoi(campos[2]));
+            return "OK " + to_string(estoque.buscarItemPorId(id)->getQuantidade()) + "\n";
+        } else if (comando == "RESERVAR" && campos.size() == 3) {
+            return "OK " + to_string(estoque.reservar(std::stoi(campos[1]), std::stoi(campos[2]))) + "\n";
+        } else if (comando == "CONFIRMAR" && campos.size() == 2) {
+            estoque.confirmarReserva(std::stoi(campos[1]));
+            return "OK\n";
+        } else if (comando == "LIBERAR" && campos.size() == 2) {
+            estoque.liberarReserva(std::stoi(campos[1]));
+            return "OK\n";
+        } else if (comando == "EXPIRAR" && campos.size() == 2) {
+            std::size_t liberadas = estoque.expirarReservas(std::chrono::seconds(std::stoi(campos[1])));
+            return "OK " + to_string(liberadas) + "\n";
+        } else if (comando == "MINIMO" && campos.size() == 3) {
+            estoque.definirMinimo(std::stoi(campos[1]), std::stoi(campos[2]));
+            return "OK\n";
+        } else if (comando == "BAIXO") {
+            vector<Item*> baixos = estoque.listarEstoqueBaixo();
+            ostringstream oss;
+            oss << "*" << baixos.size() << "\n";
+            for (std::size_t i = 0; i < baixos.size(); ++i) {
+                oss << baixos[i]->getId() << ";" << baixos[i]->getNome() << ";"
+                    << baixos[i]->getQuantidade() << ";" << baixos[i]->getMinimo() << "\n";
+            }
+            return oss.str();
+        } else if (comando == "DESC" && campos.size() == 2) {
+            return listaDeItens(estoque.buscarPorDescricao(campos[1]));
+        } else if (comando == "CATEGORIA" && campos.size() == 2) {
+            return listaDeItens(estoque.listarPorCategoria(campos[1]));
+        } else if (comando == "CATEGORIA") {
+            return listaDeGrupos(estoque.agruparPorCategoria());
+        } else if (comando == "FORNECEDOR" && campos.size() == 2) {
+            return listaDeItens(estoque.listarPorFornecedor(campos[1]));
+        } else if (comando == "FORNECEDOR") {
+            return listaDeGrupos(estoque.agruparPorFornecedor());
+        } else if (comando == "TRANSACAO" && campos.size() >= 2) {
+            TransacaoEstoque transacao;
+            for (std::size_t i = 1; i < campos.size(); ++i) {
+                std::size_t p1 = campos[i].find(':');
+                std::size_t p2 = (p1 == string::npos) ? string::npos : campos[i].find(':', p1 + 1);
+                if (p2 == string::npos) {
+                    return "ERRO linha de transacao invalida: " + campos[i] + "\n";
+                }
+                string tipo = campos[i].substr(0, p1);
+                int id = std::stoi(campos[i].substr(p1 + 1, p2 - p1 - 1));
+                int qtd = std::stoi(campos[i].substr(p2 + 1));
+                if (tipo == "ENTRADA") {
+                    transacao.entrada(id, qtd);
+                } else if (tipo == "SAIDA") {
+                    transacao.saida(id, qtd);
+                } else {
+                    return "ERRO tipo de movimento invalido: " + tipo + "\n";
+                }
+            }
+            estoque.executarTransacao(transacao);
+            return "OK " + to_string(transacao.getLinhas().size()) + "\n";
+        } else if (comando == "DESFAZER" || comando == "REFAZER") {
+            bool desfazer = (comando == "DESFAZER");
+            string descricao = desfazer ? estoque.descreverProximoDesfazer() : estoque.descreverProximoRefazer();
+            if (!(desfazer ? estoque.desfazer() : estoque.refazer())) {
+                return desfazer ? "ERRO nada a desfazer\n" : "ERRO nada a refazer\n";
+            }
+            return "OK " + descricao + "\n";
+        } else if (comando == "COMPACTAR" && campos.size() == 2) {
+            return "OK " + to_string(estoque.compactarHistorico(std::stoi(campos[1]))) + "\n";
+        } else if (comando == "TOP" && campos.size() >= 3 && std::stoi(campos[2]) >= 0) {
+            std::size_t k = static_cast<std::size_t>(std::stoi(campos[2]));
+            if (campos[1] == "MAIORES" && campos.size() == 3) {
+                return listaDeRanking(estoque.maioresQuantidades(k));
+            } else if (campos[1] == "MENORES" && campos.size() == 3) {
+                return listaDeRanking(estoque.menoresQuantidades(k));
+            } else if (campos[1] == "SAIDAS" && campos.size() <= 4) {
+                int dias = campos.size() == 4 ? std::stoi(campos[3]) : 0;
+                return listaDeRanking(estoque.maioresSaidas(k, dias));
+            }
+            return "ERRO comando invalido: " + linha + "\n";
+        } else if (comando == "AGREGADOS" && campos.size() <= 2) {
+            AgregadosQuantidade a = estoque.agregarQuantidades(campos.size() == 2 ? std::stoi(campos[1]) : 0);
+            return "OK " + to_string(a.itens) + " " + to_string(a.soma) + " " + to_string(a.minimo) + " "
+                + to_string(a.maximo) + " " + to_string(a.abaixoDoLimite) + "\n";
+        } else if (comando == "FAIXAS" && campos.size() >= 2) {
+            vector<int> limites;
+            for (std::size_t i = 1; i < campos.size(); ++i) {
+                limites.push_back(std::stoi(campos[i]));
+            }
+            vector<std::size_t> faixas = estoque.contarPorFaixaDeQuantidade(limites);
+            ostringstream oss;
+            oss << "*" << faixas.size() << "\n";
+            for (std::size_t i = 0; i < faixas.size(); ++i) {
+                oss << faixas[i] << "\n";
+            }
+            return oss.str();
+        } else if (comando == "TOTAIS") {
+            TotaisMovimentos t = estoque.totalizarMovimentos();
+            return "OK " + to_string(t.numEntradas) + " " + to_string(t.quantidadeEntradas) + " "
+                + to_string(t.numSaidas) + " " + to_string(t.quantidadeSaidas) + "\n";
+        } else if (comando == "RELATORIO" && campos.size() == 2 && campos[1] == "GRUPOS") {
+            vector<EstoquePorGrupo> grupos = RelatoriosEstoque(estoque).estoquePorGrupo();
+            ostringstream oss;
+            oss << "*" << grupos.size() << "\n";
+            for (std::size_t i = 0; i < grupos.size(); ++i) {
+                oss << nomeTipoItem(grupos[i].tipo) << ";" << grupos[i].grupo << ";"
+                    << grupos[i].itens << ";" << grupos[i].quantidade << "\n";
+            }
+            return oss.str();
+        } else if (comando == "RELATORIO" && campos.size() == 2 && campos[1] == "MESES") {
+            return listaDeFluxos(RelatoriosEstoque(estoque).movimentosPorMes());
+        } else if (comando == "RELATORIO" && (campos.size() == 2 || campos.size() == 3) && campos[1] == "FORNECEDORES") {
+            return listaDeFluxos(RelatoriosEstoque(estoque).fluxoPorFornecedor(campos.size() == 3 ? campos[2] : ""));
+        } else if (comando == "LIST") {
+            // Lista a partir do snapshot: não bloqueia outras operações
+            std::shared_ptr<const SnapshotEstoque> snapshot = estoque.obterSnapshot();
+            const vector<std::shared_ptr<const EstadoItem> >& estados = snapshot->getItens();
+            ostringstream oss;
+            oss << "*" << estados.size() << "\n";
+            for (std::size_t i = 0; i < estados.size(); ++i) {
+                const EstadoItem& e = *estados[i];
+                oss << nomeTipoItem(e.tipo) << ";" << e.id << ";" << e.nome << ";" << e.descricao << ";"
+                    << e.quantidade << ";" << e.link << ";" << e.detalhe << "\n";
+            }
+            return oss.str();
+        } else if (comando == "MEM") {
+            ostringstream relatorio;
+            estoque.gerarRelatorioMemoria().imprimir(relatorio);
+            return comoLinhas(relatorio.str());
+        } else if (comando == "STATS") {
+            ostringstream tabela;
+            estoque.obterMetricas().imprimir(tabela);
+            return comoLinhas(tabela.str());
+        } else if (comando == "SAVE") {
+            estoque.salvarDados();
+            return "OK\n";
+        } else if (comando == "CHECKPOINT") {
+            estoque.salvarDados();
+            estoque.gravarCheckpoint();
+            return "OK\n";
+        } else if (comando == "BGSAVE" && campos.size() == 1) {
+            return "OK " + to_string(estoque.salvarEmSegundoPlano()) + "\n";
+        } else if (comando == "BGSAVE" && campos.size() == 2 && campos[1] == "STATUS") {
+            StatusSalvamento status = estoque.consultarSalvamentoEmSegundoPlano();
+            switch (status.situacao) {
+                case SALVAMENTO_EM_ANDAMENTO:
+                    return "EM_ANDAMENTO " + to_string(status.pid) + "\n";
+                case SALVAMENTO_CONCLUIDO:
+                    return "CONCLUIDO " + to_string(status.duracaoMs) + "\n";
+                case SALVAMENTO_FALHOU:
+                    return "FALHOU " + to_string(status.codigoSaida) + "\n";
+                default:
+                    return "NENHUM\n";
+            }
+        } else if (comando == "SHUTDOWN") {
+            parar();  // Destrutor do Estoque (na main do servidor) salva os dados
+            return "OK\n";
+        }
+        return "ERRO comando invalido: " + linha + "\n";
+    } catch (const std::exception& e) {
+        return string("ERRO ") + e.what() + "\n";
+    }
+}
@@ -0,0 +1,195 @@
+#ifndef SERVIDORESTOQUE_H
+#define SERVIDORESTOQUE_H
+
+#include "Estoque.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Servidor residente que mantém um Estoque em memória e atende
+ * comandos por um socket Unix (AF_UNIX, SOCK_STREAM). Apenas POSIX.
+ *
+ * Motivação: as ferramentas (add_items, remove_item, test_flow) reabrem e
+ * regravam itens.txt/movimentos.txt a cada operação. Com o servidor, o custo
+ * de uma operação é o da própria operação em memória.
+ *
+ * Protocolo de linha (campos separados por ';', como nos arquivos):
+ *   PING                                   -> OK PONG
+ *   ADD;TIPO;NOME;DESC;QTD;LINK;DETALHE    -> OK <id>
+ *   DEL;ID                                 -> OK
+ *   GET;ID                                 -> OK TIPO;ID;NOME;DESC;QTD;LINK;DETALHE
+ *   ENTRADA;ID;QTD  /  SAIDA;ID;QTD        -> OK <quantidade atual>
+ *   RESERVAR;ID;QTD                        -> OK <id da reserva>
+ *   CONFIRMAR;RESERVA  /  LIBERAR;RESERVA  -> OK
+ *   EXPIRAR;SEGUNDOS                       -> OK <reservas liberadas>
+ *   MINIMO;ID;QTD                          -> OK (define o estoque mínimo; 0 desativa)
+ *   BAIXO                                  -> *<n> linhas ID;NOME;QTD;MINIMO abaixo do mínimo
+ *   DESC;CONSULTA                          -> *<n> linhas de item cuja descrição atende
+ *                                             a consulta ("m8 inox", "m8 OU inox")
+ *   CATEGORIA;NOME                         -> *<n> linhas de produto da categoria
+ *   CATEGORIA                              -> *<n> linhas NOME;QTD_ITENS por categoria
+ *   FORNECEDOR;NOME                        -> *<n> linhas de matéria-prima do fornecedor
+ *   FORNECEDOR                             -> *<n> linhas NOME;QTD_ITENS por fornecedor
+ *   TOP;MAIORES|MENORES;K                  -> *<n> linhas ID;NOME;QTD (mais/menos estocados)
+ *   TOP;SAIDAS;K[;DIAS]                    -> *<n> linhas ID;NOME;UNIDADES saídas nos
+ *                                             últimos DIAS (sem DIAS: todo o histórico)
+ *   AGREGADOS[;LIMITE]                     -> OK <itens> <soma> <min> <max> <abaixo de LIMITE>
+ *   FAIXAS;L1;L2...                        -> *<n+1> linhas com a contagem de itens por faixa
+ *                                             de quantidade (< L1, [L1,L2), ..., >= Ln)
+ *   TOTAIS                                 -> OK <entradas> <unid. entradas> <saídas> <unid. saídas>
+ *   RELATORIO;GRUPOS                       -> *<n> linhas TIPO;GRUPO;ITENS;QUANTIDADE
+ *                                             (categoria ou fornecedor)
+ *   RELATORIO;MESES                        -> *<n> linhas MES;ENTRADAS;UNID_ENTRADAS;SAIDAS;
+ *                                             UNID_SAIDAS;SALDO (MES = YYYY-MM)
+ *   RELATORIO;FORNECEDORES[;YYYY-MM]       -> *<n> linhas no mesmo formato, por fornecedor
+ *                                             (sem mês: histórico inteiro)
+ *   COMPACTAR;DIAS                         -> OK <movimentos arquivados> (mantém os últimos DIAS)
+ *   TRANSACAO;TIPO:ID:QTD[;TIPO:ID:QTD...]  -> OK <movimentos aplicados> (TIPO = ENTRADA|SAIDA;
+ *                                             todos ou nenhum, ex: TRANSACAO;SAIDA:2:1;SAIDA:5:4)
+ *   DESFAZER                               -> OK <operação desfeita> | ERRO se não houver
+ *   REFAZER                                -> OK <operação refeita> | ERRO se não houver
+ *   LIST                                   -> *<n> seguido de n linhas de item
+ *   MEM                                    -> *<n> linhas do relatório de memória
+ *   STATS                                  -> *<n> linhas de latência por operação
+ *   SAVE                                   -> OK (acréscimo ao diário e a movimentos.txt)
+ *   CHECKPOINT                             -> OK (SAVE + itens.txt e estoque.ckp completos)
+ *   BGSAVE                                 -> OK <pid> (processo filho grava a imagem do estoque;
+ *                                             o servidor continua atendendo)
+ *   BGSAVE;STATUS                          -> NENHUM | EM_ANDAMENTO <pid> | CONCLUIDO <ms>
+ *                                             | FALHOU <código de saída do filho>
+ *   SHUTDOWN                               -> OK (salva e encerra o servidor)
+ * Erros: "ERRO <mensagem>".
+ * Linha sem '\n' maior que 64 KiB: "ERRO linha muito longa" e a conexão é fechada.
+ *
+ * Pipelining: o cliente pode enviar vários comandos sem esperar resposta;
+ * todas as linhas completas recebidas são processadas em ordem e as respostas
+ * são enviadas juntas, na mesma ordem.
+ *
+ * Arquitetura: laço único com poll() sobre o socket de escuta e os clientes.
+ * COMPACTAR, RELATORIO, SAVE e CHECKPOINT (proporcionais ao histórico ou ao
+ * catálogo) rodam no pool compartilhado (PoolTarefas::global()): o laço
+ * segue atendendo os outros clientes e escreve a resposta quando a tarefa
+ * termina. As linhas seguintes do mesmo cliente esperam por ela, para as
+ * respostas saírem na ordem dos comandos.
+ */
+class ServidorEstoque {
+private:
+    // Resposta de um comando executado no pool, preenchida pela tarefa
+    struct RespostaAdiada {
+        std::string texto;
+        std::atomic<bool> pronta;  // texto já escrito
+
+        RespostaAdiada() : pronta(false) {}
+    };
+
+    // Conexão de um cliente: buffers de entrada (linhas incompletas) e saída
+    struct Conexao {
+        int fd;
+        std::string entrada;
+        std::string saida;
+        std::shared_ptr<RespostaAdiada> adiada;  // Comando em andamento no pool (ou nulo)
+        bool fecharAposEnvio;                     // Fecha quando 'saida' esvaziar
+
+        Conexao() : fd(-1), fecharAposEnvio(false) {}
+    };
+
+    // Estoque servido (não pertence ao servidor)
+    Estoque& estoque;
+
+    // Caminho do arquivo do socket Unix (ex: "estoque.sock")
+    std::string caminhoSocket;
+
+    // Descritor do socket de escuta (-1 se fechado)
+    int fdEscuta;
+
+    // Clientes conectados
+    std::vector<Conexao> conexoes;
+
+    // Indica que o laço principal deve terminar
+    volatile bool encerrar;
+
+    // Pipe com que as tarefas do pool acordam o poll() (leitura, escrita)
+    int fdAviso[2];
+
+    // Tarefas do pool ainda em execução (executar() espera todas antes de retornar)
+    std::mutex mutexTarefas;
+    std::condition_variable fimTarefas;
+    int tarefasEmAndamento;
+
+    // Lê o que estiver disponível e processa as linhas completas
+    // Retorna false se o cliente fechou a conexão
+    bool lerCliente(Conexao& conexao);
+
+    // Processa as linhas completas de 'entrada' até acabarem ou até um
+    // comando ser enviado ao pool
+    void processarLinhas(Conexao& conexao);
+
+    // Envia o comando ao pool; a resposta fica em conexao.adiada
+    void adiarComando(Conexao& conexao, const std::string& linha);
+
+    // Envia o que for possível do buffer de saída
+    // Retorna false em erro de escrita
+    bool escreverCliente(Conexao& conexao);
+
+public:
+    /**
+     * Construtor: associa o servidor a um Estoque e a um caminho de socket.
+     * Não abre o socket (ver iniciar()).
+     */
+    ServidorEstoque(Estoque& estoque, const std::string& caminhoSocket);
+
+    /**
+     * Destrutor: fecha conexões e remove o arquivo do socket.
+     * Chamado depois de executar(), que já esperou as tarefas do pool.
+     */
+    ~ServidorEstoque();
+
+    /**
+     * Prepara o caminho do socket para o bind.
+     *
+     * - Caminho inexistente: nada a fazer
+     * - Existe e não é socket (lstat + S_ISSOCK): recusa, nunca remove
+     * - Socket com servidor ativo (connect() atendido): recusa
+     * - Socket abandonado (connect() recusado): remove
+     *
+     * Chamado por iniciar(); servidor_estoque também chama antes de
+     * carregar o Estoque, para uma segunda instância não carregar nem
+     * regravar os arquivos de um servidor em execução.
+     *
+     * Lança: EstoqueException nos casos recusados
+     */
+    static void prepararCaminho(const std::string& caminhoSocket);
+
+    /**
+     * Cria, associa (bind) e escuta o socket Unix (e o pipe de aviso das tarefas).
+     * Socket antigo no mesmo caminho só é removido se abandonado (prepararCaminho).
+     *
+     * Lança: EstoqueException se o caminho for recusado ou o socket não puder ser criado
+     */
+    void iniciar();
+
+    /**
+     * Laço principal: atende clientes até SHUTDOWN ou parar().
+     * Retorna depois que os comandos em andamento no pool terminarem.
+     */
+    void executar();
+
+    /**
+     * Pede o encerramento do laço (seguro para chamar de um handler de sinal).
+     */
+    void parar();
+
+    /**
+     * Executa um comando do protocolo e devolve a resposta (com '\n' final).
+     * Público para permitir uso sem socket (ex: testes manuais, scripts).
+     *
+     * Exemplo: processarComando("ENTRADA;2;10") -> "OK 215\n"
+     */
+    std::string processarComando(const std::string& linha);
+};
+
+#endif // SERVIDORESTOQUE_H
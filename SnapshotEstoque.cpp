@@ -0,0 +1,76 @@
+// SnapshotEstoque.cpp - Visão imutável (MVCC) do estoque para relatórios
+#include "SnapshotEstoque.h"
+#include "RegistroTiposItem.h"
+#include <iostream>
+#include <utility> // Para std::move
+
+using std::cout;
+using std::endl;
+using std::shared_ptr;
+using std::vector;
+
+// Exibe o estado do item com o mesmo layout usado por exibirDetalhes()
+// das subclasses: rótulos do tipo e do detalhe vêm do registro de tipos
+void EstadoItem::exibirDetalhes() const {
+    const DescritorTipoItem& descritor = descritorTipo(tipo);
+    cout << "---------------------------------" << endl;
+    cout << "ID: " << id << " (" << descritor.rotuloExibicao << ")" << endl;
+    cout << "Nome: " << nome << endl;
+    cout << "Descricao: " << descricao << endl;
+    cout << descritor.rotuloDetalhe << ": " << detalhe << endl;
+    cout << "Quantidade: " << quantidade << endl;
+    if (minimo > 0) {
+        cout << "Estoque minimo: " << minimo << (quantidade < minimo ? " (ABAIXO DO MINIMO)" : "") << endl;
+    }
+    cout << "Link: " << link << endl;
+    cout << "---------------------------------" << endl;
+}
+
+// Última referência à época: nenhum snapshot pode ver estes movimentos
+EpocaHistorico::~EpocaHistorico() {
+    for (std::size_t i = 0; i < aposentados.size(); ++i) {
+        delete aposentados[i];
+    }
+}
+
+void EpocaHistorico::aposentar(const vector<MovimentoEstoque*>& movimentos) {
+    aposentados.insert(aposentados.end(), movimentos.begin(), movimentos.end());
+}
+
+void EpocaHistorico::encadear(const shared_ptr<EpocaHistorico>& seguinte) {
+    proxima = seguinte;
+}
+
+// Definição do membro estático (necessária em C++11 quando usado por referência)
+const std::size_t SnapshotEstoque::TAMANHO_BLOCO;
+
+// Construtor: recebe vetores já montados por Estoque::obterSnapshot()
+SnapshotEstoque::SnapshotEstoque(unsigned long versao,
+                                 vector<shared_ptr<const EstadoItem> > itens,
+                                 vector<shared_ptr<const BlocoHistorico> > blocos,
+                                 std::size_t totalMovimentos,
+                                 shared_ptr<const EpocaHistorico> epoca)
+    : versao(versao),
+      itens(std::move(itens)),
+      blocos(std::move(blocos)),
+      totalMovimentos(totalMovimentos),
+      epoca(std::move(epoca))
+{
+}
+
+unsigned long SnapshotEstoque::getVersao() const {
+    return versao;
+}
+
+const vector<shared_ptr<const EstadoItem> >& SnapshotEstoque::getItens() const {
+    return itens;
+}
+
+std::size_t SnapshotEstoque::tamanhoHistorico() const {
+    return totalMovimentos;
+}
+
+// Localiza o bloco (indice / TAMANHO_BLOCO) e a posição dentro dele
+const MovimentoEstoque* SnapshotEstoque::movimento(std::size_t indice) const {
+    return (*blocos[indice / TAMANHO_BLOCO])[indice % TAMANHO_BLOCO];
+}
@@ -0,0 +1,116 @@
+#ifndef SNAPSHOTESTOQUE_H
+#define SNAPSHOTESTOQUE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "MovimentoEstoque.h"
+#include "TipoItem.h"
+
+/**
+ * Estado imutável de um item em uma determinada versão.
+ * Cópia por valor dos campos de Item, publicada em copy-on-write:
+ * só é recriada quando a versão do Item muda (Item::getVersao()).
+ *
+ * Compartilhada entre snapshots via std::shared_ptr<const EstadoItem>:
+ * a última referência liberada recupera a memória (reclamação por contagem).
+ */
+struct EstadoItem {
+    int id;
+    TipoItem tipo;           // Etiqueta (nome via nomeTipoItem)
+    std::string nome;
+    std::string descricao;
+    int quantidade;
+    std::string link;
+    std::string detalhe;     // categoria (produto) ou fornecedor (materia)
+    int minimo;              // estoque mínimo (0 = sem alerta)
+    unsigned long versao;    // versão do Item no momento da cópia
+
+    /**
+     * Exibe o estado no mesmo formato de ItemProduto/ItemMateria::exibirDetalhes().
+     */
+    void exibirDetalhes() const;
+};
+
+// Bloco de ponteiros para movimentos (imutáveis depois de criados)
+typedef std::vector<const MovimentoEstoque*> BlocoHistorico;
+
+/**
+ * Época do histórico: intervalo entre duas compactações (Estoque::compactarHistorico).
+ *
+ * Todo snapshot guarda a época em que foi gerado. Os movimentos retirados
+ * do histórico ao fim de uma época são entregues a ela (aposentar) em vez
+ * de apagados, porque snapshots dessa época ou de anteriores ainda podem
+ * apontar para eles.
+ *
+ * Cada época mantém viva a seguinte (encadear): a época N só é destruída
+ * quando não restam snapshots das épocas 1..N, e o destrutor então libera
+ * os movimentos aposentados nela.
+ */
+class EpocaHistorico {
+public:
+    ~EpocaHistorico();
+
+    // Assume a posse dos movimentos retirados do histórico ao fim desta época
+    void aposentar(const std::vector<MovimentoEstoque*>& movimentos);
+
+    // Liga a próxima época: ela vive ao menos enquanto esta viver
+    void encadear(const std::shared_ptr<EpocaHistorico>& seguinte);
+
+private:
+    std::vector<MovimentoEstoque*> aposentados;
+    std::shared_ptr<EpocaHistorico> proxima;
+};
+
+/**
+ * Visão consistente e imutável do Estoque em uma versão (MVCC).
+ *
+ * Obtida por Estoque::obterSnapshot(). O leitor "fixa" a versão enquanto
+ * mantiver o shared_ptr, e pode iterar sem bloquear registrarEntrada/Saida.
+ *
+ * Itens: vetor de EstadoItem compartilhados com snapshots anteriores
+ * (somente itens alterados são copiados novamente).
+ * Histórico: blocos de tamanho fixo; blocos cheios são selados e reutilizados
+ * por todos os snapshots seguintes, apenas o bloco final é copiado.
+ *
+ * Compactação: movimentos arquivados só são liberados quando a época do
+ * snapshot termina (EpocaHistorico), então o snapshot continua válido.
+ *
+ * Restrição: o snapshot não deve sobreviver ao Estoque que o gerou
+ * (os movimentos são de propriedade do Estoque).
+ */
+class SnapshotEstoque {
+public:
+    // Quantidade de movimentos por bloco selado do histórico
+    static const std::size_t TAMANHO_BLOCO = 1024;
+
+    SnapshotEstoque(unsigned long versao,
+                    std::vector<std::shared_ptr<const EstadoItem> > itens,
+                    std::vector<std::shared_ptr<const BlocoHistorico> > blocos,
+                    std::size_t totalMovimentos,
+                    std::shared_ptr<const EpocaHistorico> epoca);
+
+    // Versão do Estoque em que o snapshot foi gerado
+    unsigned long getVersao() const;
+
+    // Itens na ordem de cadastro
+    const std::vector<std::shared_ptr<const EstadoItem> >& getItens() const;
+
+    // Número de movimentos visíveis neste snapshot
+    std::size_t tamanhoHistorico() const;
+
+    /**
+     * Acessa o movimento na posição indice (0-based) do histórico.
+     * Pré-condição: indice < tamanhoHistorico() (sem verificação).
+     */
+    const MovimentoEstoque* movimento(std::size_t indice) const;
+
+private:
+    unsigned long versao;
+    std::vector<std::shared_ptr<const EstadoItem> > itens;
+    std::vector<std::shared_ptr<const BlocoHistorico> > blocos;
+    std::size_t totalMovimentos;
+    std::shared_ptr<const EpocaHistorico> epoca;  // Segura movimentos aposentados
+};
+
+#endif // SNAPSHOTESTOQUE_H
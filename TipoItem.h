@@ -0,0 +1,10 @@
+#ifndef TIPOITEM_H
+#define TIPOITEM_H
+
+// Etiqueta compacta do tipo concreto de um Item
+// Gravada no próprio objeto: laços em massa (salvar, listar, filtrar)
+// despacham por switch nesta etiqueta em vez de chamar métodos virtuais
+// Tags, rótulos e fábricas de cada tipo: RegistroTiposItem.h
+enum TipoItem { TIPO_PRODUTO, TIPO_MATERIA, NUM_TIPOS_ITEM };
+
+#endif // TIPOITEM_H
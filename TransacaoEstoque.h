@@ -0,0 +1,59 @@
+#ifndef TRANSACAOESTOQUE_H
+#define TRANSACAOESTOQUE_H
+
+#include "EstoqueException.h"
+#include "MovimentoEstoque.h"
+#include <string>
+#include <vector>
+
+/**
+ * Uma linha de transação: movimento preparado, ainda não aplicado.
+ */
+struct LinhaTransacao {
+    TipoMovimento tipo;   // ENTRADA ou SAIDA
+    int idItem;
+    int quantidade;       // Sempre > 0
+};
+
+/**
+ * Conjunto de movimentos aplicados juntos por Estoque::executarTransacao:
+ * todos ou nenhum (ex: saída de um kit com vários itens).
+ *
+ * Apenas prepara as linhas; nada é validado contra o estoque até a execução.
+ *
+ * Exemplo:
+ *   TransacaoEstoque kit;
+ *   kit.saida(2, 1).saida(5, 4).saida(9, 2);
+ *   estoque.executarTransacao(kit);  // Lança sem aplicar nada se faltar algum item
+ */
+class TransacaoEstoque {
+public:
+    // Prepara uma ENTRADA. Lança: EstoqueException se qtd <= 0
+    TransacaoEstoque& entrada(int idItem, int qtd) {
+        return adicionarLinha(ENTRADA, idItem, qtd);
+    }
+
+    // Prepara uma SAIDA. Lança: EstoqueException se qtd <= 0
+    TransacaoEstoque& saida(int idItem, int qtd) {
+        return adicionarLinha(SAIDA, idItem, qtd);
+    }
+
+    const std::vector<LinhaTransacao>& getLinhas() const { return linhas; }
+    bool vazia() const { return linhas.empty(); }
+    void limpar() { linhas.clear(); }
+
+private:
+    std::vector<LinhaTransacao> linhas;
+
+    TransacaoEstoque& adicionarLinha(TipoMovimento tipo, int idItem, int qtd) {
+        if (qtd <= 0) {
+            throw EstoqueException("Quantidade da transacao deve ser positiva (item " +
+                                   std::to_string(idItem) + ").");
+        }
+        LinhaTransacao linha = { tipo, idItem, qtd };
+        linhas.push_back(linha);
+        return *this;
+    }
+};
+
+#endif // TRANSACAOESTOQUE_H
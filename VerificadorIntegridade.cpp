@@ -0,0 +1,302 @@
+// VerificadorIntegridade.cpp - Replay paralelo de movimentos.txt e conferência com o catálogo
+#include "VerificadorIntegridade.h"
+#include "EstoqueException.h"
+#include "CheckpointEstoque.h"
+#include "PoolTarefas.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::string;
+using std::vector;
+using std::size_t;
+
+// Acumulado de uma tarefa sobre o seu trecho de movimentos.txt
+struct ParcialReplay {
+    vector<long long> saldos;                  // Denso: índice = idItem (0..maiorId)
+    vector<char> movimentados;                 // Denso: item com ao menos um movimento no trecho
+    std::unordered_map<int, long long> outros; // IDs fora da faixa de itens.txt
+    size_t lidos;
+    size_t arquivados;
+    size_t invalidas;
+};
+
+// Lê um inteiro decimal (com sinal opcional) terminado em ';', '\r', '\n' ou fim
+// Avança p até o terminador. Retorna false se não houver dígitos.
+static bool lerNumero(const char*& p, const char* fim, long long& valor) {
+    bool negativo = false;
+    if (p < fim && *p == '-') {
+        negativo = true;
+        ++p;
+    }
+    const char* inicio = p;
+    long long v = 0;
+    while (p < fim && static_cast<unsigned>(*p - '0') < 10u) {
+        v = v * 10 + (*p - '0');
+        ++p;
+    }
+    if (p == inicio) {
+        return false;
+    }
+    valor = negativo ? -v : v;
+    return true;
+}
+
+// Pula até depois do próximo ';' da linha; false se a linha acabar antes
+static bool pularCampo(const char*& p, const char* fimLinha) {
+    const char* sep = static_cast<const char*>(std::memchr(p, ';', fimLinha - p));
+    if (!sep) {
+        return false;
+    }
+    p = sep + 1;
+    return true;
+}
+
+// Reproduz as linhas completas de [p, fim): ID;DATA;TIPO;QTD;IDITEM;NOMEITEM
+static void reproduzirTrecho(const char* p, const char* fim, long long ultimoArquivado, ParcialReplay& parcial) {
+    const long long limiteDenso = static_cast<long long>(parcial.saldos.size());
+    while (p < fim) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', fim - p));
+        const char* fimLinha = nl ? nl : fim;
+        const char* c = p;
+        p = fimLinha + 1;
+        if (c == fimLinha || (fimLinha - c == 1 && *c == '\r')) {
+            continue;  // Linha vazia
+        }
+
+        long long id, qtd, idItem;
+        bool ok = lerNumero(c, fimLinha, id) && c < fimLinha && *c++ == ';'
+               && pularCampo(c, fimLinha)                 // DATA
+               && c < fimLinha;
+        char tipo = ok ? *c : 0;
+        ok = ok && (tipo == 'E' || tipo == 'S')
+               && pularCampo(c, fimLinha)                 // TIPO
+               && lerNumero(c, fimLinha, qtd) && c < fimLinha && *c++ == ';'
+               && lerNumero(c, fimLinha, idItem);
+        if (!ok) {
+            ++parcial.invalidas;
+            continue;
+        }
+        if (id <= ultimoArquivado) {
+            ++parcial.arquivados;  // Já somado no resumo (compactação interrompida)
+            continue;
+        }
+        long long delta = (tipo == 'E') ? qtd : -qtd;
+        if (idItem >= 0 && idItem < limiteDenso) {
+            parcial.saldos[static_cast<size_t>(idItem)] += delta;
+            parcial.movimentados[static_cast<size_t>(idItem)] = 1;
+        } else {
+            parcial.outros[static_cast<int>(idItem)] += delta;
+        }
+        ++parcial.lidos;
+    }
+}
+
+// Lê o arquivo inteiro para 'conteudo'; false se não puder abrir
+static bool lerArquivo(const string& caminho, string& conteudo) {
+    std::ifstream arq(caminho.c_str(), std::ios::binary);
+    if (!arq.is_open()) {
+        return false;
+    }
+    std::ostringstream fluxo;
+    fluxo << arq.rdbuf();
+    conteudo = fluxo.str();
+    return true;
+}
+
+VerificadorIntegridade::VerificadorIntegridade(const string& diretorio, unsigned numThreads)
+    : diretorio(diretorio), numThreads(numThreads) {
+}
+
+// Ver descrição do processo em VerificadorIntegridade.h
+ResultadoVerificacao VerificadorIntegridade::verificar() {
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    ResultadoVerificacao resultado = ResultadoVerificacao();
+
+    // 1a. Catálogo como o Estoque o carrega: estoque.ckp + diario_itens.txt
+    //     (itens.txt só é atualizado no checkpoint; sem checkpoint válido, itens.txt + diário)
+    vector<RegistroItem> registros;
+    unsigned long long seqCheckpoint = 0;
+    int proximoIdItem = 0;
+    // Sem nenhum dos dois, o diário sozinho é o catálogo (nenhum checkpoint
+    // gravado ainda: o encerramento só grava checkpoint com diário grande)
+    if (!CheckpointEstoque::ler(diretorio + "/estoque.ckp", seqCheckpoint, proximoIdItem, registros) &&
+        !CheckpointEstoque::lerItensTexto(diretorio + "/itens.txt", registros) &&
+        !std::ifstream((diretorio + "/diario_itens.txt").c_str()).is_open()) {
+        throw EstoqueException("Nao foi possivel abrir " + diretorio + "/estoque.ckp, " +
+                               diretorio + "/itens.txt nem " + diretorio + "/diario_itens.txt.");
+    }
+    unsigned long long ultimaSeq = 0;
+    int maiorIdDiario = 0;
+    bool diarioTerminaEmQuebra = true;
+    CheckpointEstoque::reaplicarDiario(diretorio + "/diario_itens.txt", seqCheckpoint, registros,
+                                       ultimaSeq, maiorIdDiario, diarioTerminaEmQuebra);
+
+    // (ID, QTY) dos itens cadastrados (id 0: removido pelo diário)
+    vector<std::pair<int, long long> > cadastro;
+    cadastro.reserve(registros.size());
+    int maiorId = 0;
+    for (size_t i = 0; i < registros.size(); ++i) {
+        int id = registros[i].campos.id;
+        if (id > 0) {
+            cadastro.push_back(std::make_pair(id, static_cast<long long>(registros[i].campos.quantidade)));
+            if (id > maiorId) maiorId = id;
+        }
+    }
+    vector<RegistroItem>().swap(registros);
+    resultado.itensVerificados = cadastro.size();
+
+    // 1b. resumo_movimentos.txt: ATE;ULTIMO_ID;DATA e IDITEM;ENTRADAS;SAIDAS;MOVIMENTOS
+    vector<long long> base(static_cast<size_t>(maiorId) + 1, 0);
+    vector<char> baseMovimentados(static_cast<size_t>(maiorId) + 1, 0);
+    std::unordered_map<int, long long> baseOutros;
+    long long ultimoArquivado = 0;
+    string conteudo;
+    if (lerArquivo(diretorio + "/resumo_movimentos.txt", conteudo)) {
+        const char* p = conteudo.data();
+        const char* fim = p + conteudo.size();
+        bool cabecalho = true;
+        while (p < fim) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', fim - p));
+            const char* fimLinha = nl ? nl : fim;
+            const char* c = p;
+            p = fimLinha + 1;
+            if (cabecalho) {
+                cabecalho = false;
+                if (fimLinha - c > 4 && std::memcmp(c, "ATE;", 4) == 0) {
+                    c += 4;
+                    lerNumero(c, fimLinha, ultimoArquivado);
+                }
+                continue;
+            }
+            long long idItem, entradas, saidas;
+            if (lerNumero(c, fimLinha, idItem) && c < fimLinha && *c++ == ';'
+                && lerNumero(c, fimLinha, entradas) && c < fimLinha && *c++ == ';'
+                && lerNumero(c, fimLinha, saidas)) {
+                if (idItem >= 0 && idItem <= maiorId) {
+                    base[static_cast<size_t>(idItem)] += entradas - saidas;
+                    baseMovimentados[static_cast<size_t>(idItem)] = 1;  // Linha só existe com movimentos
+                } else {
+                    baseOutros[static_cast<int>(idItem)] += entradas - saidas;
+                }
+            }
+        }
+    }
+    string().swap(conteudo);
+
+    // 2. movimentos.txt mapeado em memória (sem cópia para o heap)
+    const char* dados = nullptr;
+    size_t tamanho = 0;
+    int fd = open((diretorio + "/movimentos.txt").c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            tamanho = static_cast<size_t>(info.st_size);
+            void* mapa = mmap(nullptr, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapa == MAP_FAILED) {
+                close(fd);
+                throw EstoqueException("Nao foi possivel mapear " + diretorio + "/movimentos.txt.");
+            }
+            madvise(mapa, tamanho, MADV_SEQUENTIAL);
+            dados = static_cast<const char*>(mapa);
+        }
+    }
+    resultado.bytesLidos = tamanho;
+
+    PoolTarefas& pool = PoolTarefas::global();
+    unsigned threads = pool.trechosPara(tamanho, 1 << 20, numThreads);  // Arquivos pequenos: menos trechos
+
+    // Trechos de bytes alinhados ao início de linha
+    vector<const char*> limites(threads + 1);
+    limites[0] = dados;
+    limites[threads] = dados + tamanho;
+    for (unsigned t = 1; t < threads; ++t) {
+        const char* alvo = dados + tamanho * t / threads;
+        if (alvo < limites[t - 1]) alvo = limites[t - 1];
+        const char* nl = static_cast<const char*>(std::memchr(alvo, '\n', limites[threads] - alvo));
+        limites[t] = nl ? nl + 1 : limites[threads];
+    }
+
+    // 3. Reprodução em paralelo: uma tarefa por trecho de bytes (índice t)
+    vector<ParcialReplay> parciais(threads);
+    pool.paraCadaTrecho(threads, threads, [&](unsigned t, size_t, size_t) {
+        ParcialReplay& parcial = parciais[t];
+        parcial.saldos.assign(static_cast<size_t>(maiorId) + 1, 0);
+        parcial.movimentados.assign(static_cast<size_t>(maiorId) + 1, 0);
+        parcial.lidos = parcial.arquivados = parcial.invalidas = 0;
+        reproduzirTrecho(limites[t], limites[t + 1], ultimoArquivado, parcial);
+    });
+    if (dados) {
+        munmap(const_cast<char*>(dados), tamanho);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    // 4. Consolidação particionada por idItem: faixa [t*n/T, (t+1)*n/T) de IDs por thread
+    vector<long long> gravada(static_cast<size_t>(maiorId) + 1, 0);
+    vector<char> cadastrado(static_cast<size_t>(maiorId) + 1, 0);
+    for (size_t i = 0; i < cadastro.size(); ++i) {
+        gravada[static_cast<size_t>(cadastro[i].first)] = cadastro[i].second;
+        cadastrado[static_cast<size_t>(cadastro[i].first)] = 1;
+    }
+    const size_t numIds = static_cast<size_t>(maiorId) + 1;
+    vector<vector<DivergenciaQuantidade> > divergenciasPorFaixa(threads);
+    vector<size_t> semCadastroPorFaixa(threads, 0);
+    vector<size_t> saldoInicialPorFaixa(threads, 0);
+    pool.paraCadaTrecho(numIds, threads, [&](unsigned t, size_t inicio, size_t fim) {
+        for (size_t id = inicio; id < fim; ++id) {
+            long long saldo = base[id];
+            bool movimentado = baseMovimentados[id] != 0;
+            for (unsigned k = 0; k < threads; ++k) {
+                saldo += parciais[k].saldos[id];
+                movimentado = movimentado || parciais[k].movimentados[id];
+            }
+            if (!cadastrado[id]) {
+                if (saldo != 0) ++semCadastroPorFaixa[t];
+            } else if (!movimentado) {
+                // Nenhum movimento: QTY do catálogo é o saldo de abertura
+                // (cadastro anterior à ENTRADA de saldo inicial)
+                if (gravada[id] != 0) ++saldoInicialPorFaixa[t];
+            } else if (saldo != gravada[id]) {
+                DivergenciaQuantidade d;
+                d.idItem = static_cast<int>(id);
+                d.gravada = gravada[id];
+                d.reconstruida = saldo;
+                divergenciasPorFaixa[t].push_back(d);
+            }
+        }
+    });
+
+    // 5. Junta as faixas em ordem (resultado determinístico) e os contadores
+    for (unsigned t = 0; t < threads; ++t) {
+        resultado.divergencias.insert(resultado.divergencias.end(),
+                                      divergenciasPorFaixa[t].begin(), divergenciasPorFaixa[t].end());
+        resultado.itensSemCadastro += semCadastroPorFaixa[t];
+        resultado.itensSaldoInicial += saldoInicialPorFaixa[t];
+        resultado.movimentosLidos += parciais[t].lidos;
+        resultado.movimentosArquivados += parciais[t].arquivados;
+        resultado.linhasInvalidas += parciais[t].invalidas;
+    }
+
+    // IDs fora da faixa de itens.txt (itens removidos com ID maior que o último cadastrado)
+    std::unordered_map<int, long long>::const_iterator it;
+    for (unsigned t = 0; t < threads; ++t) {
+        for (it = parciais[t].outros.begin(); it != parciais[t].outros.end(); ++it) {
+            baseOutros[it->first] += it->second;
+        }
+    }
+    for (it = baseOutros.begin(); it != baseOutros.end(); ++it) {
+        if (it->second != 0) ++resultado.itensSemCadastro;
+    }
+
+    resultado.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return resultado;
+}
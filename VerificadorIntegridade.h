@@ -0,0 +1,87 @@
+#ifndef VERIFICADORINTEGRIDADE_H
+#define VERIFICADORINTEGRIDADE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Item cuja quantidade gravada no catálogo difere da reconstruída
+ * a partir dos movimentos.
+ */
+struct DivergenciaQuantidade {
+    int idItem;
+    long long gravada;        // QTY do catálogo (checkpoint + diário)
+    long long reconstruida;   // Resumo arquivado + ENTRADAS - SAIDAS de movimentos.txt
+};
+
+/**
+ * Resultado de uma verificação: contadores, divergências e desempenho.
+ */
+struct ResultadoVerificacao {
+    std::size_t itensVerificados;      // Itens do catálogo
+    std::size_t movimentosLidos;       // Movimentos reproduzidos de movimentos.txt
+    std::size_t movimentosArquivados;  // Ignorados por já constarem do resumo (ID <= ATE)
+    std::size_t linhasInvalidas;       // Linhas de movimentos.txt que não puderam ser lidas
+    std::size_t itensSemCadastro;      // IDs com saldo reconstruído != 0 fora do catálogo (removidos)
+    std::size_t itensSaldoInicial;     // Sem nenhum movimento: QTY do catálogo aceita como saldo de abertura
+    std::vector<DivergenciaQuantidade> divergencias;  // Em ordem de ID
+    std::size_t bytesLidos;            // Tamanho de movimentos.txt
+    double segundos;                   // Tempo total
+
+    // Vazão da reprodução (0 se tempo desprezível)
+    double megabytesPorSegundo() const {
+        return segundos > 0.0 ? bytesLidos / (1024.0 * 1024.0) / segundos : 0.0;
+    }
+};
+
+/**
+ * Motor de reprodução (replay) do log de movimentos.
+ *
+ * Reconstrói a quantidade de cada item somente a partir dos eventos
+ * (resumo_movimentos.txt + movimentos.txt) e compara com o catálogo.
+ * Pensado para a verificação noturna de integridade (verificar_integridade).
+ *
+ * Processo:
+ * 1. Carrega o catálogo como o Estoque (estoque.ckp + reaplicação de
+ *    diario_itens.txt, CheckpointEstoque; sem checkpoint válido, itens.txt
+ *    + diário; sem nenhum dos dois, só o diário) e lê o resumo dos
+ *    movimentos arquivados
+ * 2. Mapeia movimentos.txt em memória e divide-o em trechos de bytes,
+ *    alinhados ao início de linha (um por tarefa do pool global, PoolTarefas.h)
+ * 3. Cada tarefa percorre seu trecho uma única vez (parse sem alocação)
+ *    acumulando ENTRADA - SAIDA em um vetor denso indexado por idItem
+ * 4. Consolidação particionada por idItem: cada tarefa soma uma faixa
+ *    contígua de IDs em todos os vetores parciais
+ * 5. Compara com a quantidade gravada e lista as divergências
+ *
+ * A quantidade informada no cadastro (menu, ADD do servidor, importação CSV)
+ * é registrada como ENTRADA (Estoque::adicionarItem/adicionarItens): todo
+ * saldo tem origem em movimentos. Itens sem nenhum movimento (nem no resumo
+ * nem em movimentos.txt), cadastrados antes dessa ENTRADA existir, não
+ * divergem: a QTY do catálogo é o saldo de abertura (itensSaldoInicial).
+ *
+ * Somente leitura: pode rodar com o sistema em uso (lê o último salvamento).
+ */
+class VerificadorIntegridade {
+private:
+    // Diretório com estoque.ckp, diario_itens.txt, itens.txt, movimentos.txt e resumo_movimentos.txt
+    std::string diretorio;
+
+    // Número de trechos (0 = trabalhadores do pool + a thread que chama)
+    unsigned numThreads;
+
+public:
+    VerificadorIntegridade(const std::string& diretorio = ".", unsigned numThreads = 0);
+
+    /**
+     * Executa a verificação completa.
+     *
+     * Retorna: ResultadoVerificacao (divergencias vazio = íntegro)
+     *
+     * Lança: EstoqueException se nem estoque.ckp, itens.txt nem diario_itens.txt puderem ser lidos
+     *        (movimentos.txt ausente = nenhum movimento)
+     */
+    ResultadoVerificacao verificar();
+};
+
+#endif // VERIFICADORINTEGRIDADE_H
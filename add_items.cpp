@@ -1,22 +1,36 @@
 #include <iostream>
+#include <cstdlib>
 #include "Estoque.h"
-#include "ItemProduto.h"
-#include "ItemMateria.h"
+#include "ImportadorCSV.h"
 
-int main() {
-    Estoque estoque; // carrega dados existentes
-
-    // Criar e adicionar um produto
-    Item* p = new ItemProduto("ParafusoAuto", "Parafuso automatico M4", 200, "http://google.com/search?q=\"ParafusoAuto\"", "FerragensAuto");
-    estoque.adicionarItem(p);
+// Importa um catálogo CSV para o estoque (formato em ImportadorCSV.h).
+// Uso: add_items <arquivo.csv> [threads]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: add_items <arquivo.csv> [threads]\n";
+        std::cerr << "Formato: tipo,nome,descricao,quantidade,link,detalhe\n";
+        return 1;
+    }
+    unsigned threads = (argc >= 3) ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
 
-    // Criar e adicionar uma matéria-prima
-    Item* m = new ItemMateria("MadeiraAuto", "Madeira tratada", 50, "http://example.com/madeira", "FornecedorAuto");
-    estoque.adicionarItem(m);
+    Estoque estoque; // carrega dados existentes
+    try {
+        ImportadorCSV importador(estoque, threads);
+        ResultadoImportacao r = importador.importar(argv[1]);
 
-    // Salvar dados explicitamente
-    estoque.salvarDados();
+        // Relata linhas rejeitadas sem abortar a importação
+        for (std::size_t i = 0; i < r.rejeitadas.size(); ++i) {
+            std::cerr << "Linha " << r.rejeitadas[i].linha << " rejeitada: " << r.rejeitadas[i].motivo << "\n";
+        }
+        std::cout << r.itensImportados << " de " << r.linhasLidas << " linhas importadas ("
+                  << r.rejeitadas.size() << " rejeitadas) em " << r.segundos << " s - "
+                  << static_cast<long long>(r.linhasPorSegundo()) << " linhas/s" << std::endl;
 
-    std::cout << "Itens adicionados e dados salvos com sucesso." << std::endl;
+        // Salvar dados explicitamente
+        estoque.salvarDados();
+    } catch (const std::exception& e) {
+        std::cerr << "Erro ao importar: " << e.what() << std::endl;
+        return 1;
+    }
     return 0;
 }
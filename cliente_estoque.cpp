@@ -0,0 +1,99 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Cliente leve para o servidor_estoque (protocolo descrito em ServidorEstoque.h).
+// Uso:
+//   cliente_estoque [-s caminho.sock] "ENTRADA;2;10" "SAIDA;2;5" ...
+//   cliente_estoque [-s caminho.sock] < comandos.txt
+// Todos os comandos são enviados de uma vez (pipelining) e as respostas
+// são impressas na mesma ordem.
+
+// Lê uma linha (até '\n') do socket, usando 'pendente' como buffer
+static bool lerLinha(int fd, std::string& pendente, std::string& linha) {
+    std::size_t pos;
+    while ((pos = pendente.find('\n')) == std::string::npos) {
+        char buffer[4096];
+        ssize_t lidos = read(fd, buffer, sizeof(buffer));
+        if (lidos <= 0) return false;
+        pendente.append(buffer, static_cast<std::size_t>(lidos));
+    }
+    linha = pendente.substr(0, pos);
+    pendente.erase(0, pos + 1);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string caminho = "estoque.sock";
+    std::vector<std::string> comandos;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            caminho = argv[++i];
+        } else {
+            comandos.push_back(argv[i]);
+        }
+    }
+    if (comandos.empty()) {
+        std::string linha;
+        while (std::getline(std::cin, linha)) {
+            if (!linha.empty()) comandos.push_back(linha);
+        }
+    }
+    if (comandos.empty()) {
+        std::cerr << "Uso: cliente_estoque [-s caminho.sock] COMANDO...\n";
+        return 1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un endereco;
+    std::memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    std::strncpy(endereco.sun_path, caminho.c_str(), sizeof(endereco.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0) {
+        std::cerr << "Erro: nao foi possivel conectar em " << caminho << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // Envia todos os comandos de uma vez (pipelining)
+    std::string envio;
+    for (std::size_t i = 0; i < comandos.size(); ++i) {
+        envio += comandos[i] + "\n";
+    }
+    std::size_t enviados = 0;
+    while (enviados < envio.size()) {
+        ssize_t n = write(fd, envio.data() + enviados, envio.size() - enviados);
+        if (n <= 0) {
+            std::cerr << "Erro ao enviar comandos." << std::endl;
+            return 1;
+        }
+        enviados += static_cast<std::size_t>(n);
+    }
+
+    // Uma resposta por comando; "*<n>" indica n linhas adicionais
+    int codigo = 0;
+    std::string pendente, linha;
+    for (std::size_t i = 0; i < comandos.size(); ++i) {
+        if (!lerLinha(fd, pendente, linha)) {
+            std::cerr << "Conexao encerrada pelo servidor." << std::endl;
+            return 1;
+        }
+        if (!linha.empty() && linha[0] == '*') {
+            int linhas = std::atoi(linha.c_str() + 1);
+            for (int j = 0; j < linhas && lerLinha(fd, pendente, linha); ++j) {
+                std::cout << linha << "\n";
+            }
+        } else {
+            std::cout << linha << "\n";
+            if (linha.compare(0, 4, "ERRO") == 0) codigo = 1;
+        }
+    }
+    close(fd);
+    return codigo;
+}
@@ -6,11 +6,13 @@
 #include <string>
 #include <limits>
 #include <cstdlib> // Para system()
+#include <chrono>
 
 #include "Estoque.h"
 #include "EstoqueException.h"
-#include "ItemProduto.h"
-#include "ItemMateria.h"
+#include "RegistroTiposItem.h" // ItemProduto, ItemMateria e fábricas por tipo
+#include "DeteccaoCPU.h" // Nível SIMD exibido no painel de quantidades
+#include "RelatoriosEstoque.h" // Relatórios paralelos (opção 22)
 
 // Usings para o std namespace (simplifica escrita)
 using std::cout;
@@ -68,6 +70,52 @@ void registrarSaida(Estoque& estoque);
 // Menu opção 9: Abre link do item no navegador
 void buscarInternet(Estoque& estoque);
 
+// Menu opção 10: Exibe relatório de uso de memória
+void exibirMemoria(Estoque& estoque);
+
+// Menu opção 11: Exibe latências (p50/p99/p999) por operação
+void exibirLatencias(Estoque& estoque);
+
+// Menu opção 12: Define o estoque mínimo de um item
+void definirMinimo(Estoque& estoque);
+
+// Menu opção 13: Lista itens abaixo do estoque mínimo
+void listarEstoqueBaixo(Estoque& estoque);
+
+// Menu opção 14: Busca itens por palavras da descrição (E / OU)
+void buscarPorDescricao(Estoque& estoque);
+
+// Menu opção 15: Itens por categoria (produtos) ou fornecedor (matérias-primas)
+void listarPorCategoriaFornecedor(Estoque& estoque);
+
+// Menu opção 16: Rankings (mais/menos estocados, maiores saídas)
+void exibirRankings(Estoque& estoque);
+
+// Menu opção 17: Checkpoint do histórico (arquiva movimentos antigos)
+void compactarHistorico(Estoque& estoque);
+
+// Menu opções 18/19: Desfaz / refaz a última operação
+void desfazerOperacao(Estoque& estoque);
+void refazerOperacao(Estoque& estoque);
+
+// Menu opção 20: Saída de kit (vários itens, tudo ou nada)
+void registrarSaidaKit(Estoque& estoque);
+
+// Menu opção 21: Painel de quantidades (agregados e faixas)
+void exibirPainelQuantidades(Estoque& estoque);
+
+// Menu opção 22: Relatórios (por grupo, por mês, por fornecedor)
+void exibirRelatorios(Estoque& estoque);
+
+// Menu opção 23: Salvar em segundo plano (processo filho)
+void salvarEmSegundoPlano(Estoque& estoque);
+
+// Avisa (uma vez) o fim do salvamento em segundo plano
+void informarSalvamentoEmSegundoPlano(Estoque& estoque, int& pidInformado);
+
+// Callback de alerta: avisa quando um item cruza o estoque mínimo
+void avisarEstoqueBaixo(const AlertaEstoqueBaixo& alerta);
+
 /**
  * Função principal - Ponto de entrada da aplicação.
  * 
@@ -91,10 +139,15 @@ int main() {
     // Cria objeto Estoque (construtor carrega dados de arquivos)
     Estoque estoque;
     int opcao;
+    int salvamentoInformado = 0;  // PID do último salvamento em segundo plano já informado
+
+    // Avisos imediatos quando uma SAIDA deixa um item abaixo do mínimo
+    estoque.adicionarAlertaEstoqueBaixo(avisarEstoqueBaixo);
 
     // Loop principal: menu-driven
     do {
         limparTela();  // Limpa tela antes de exibir menu
+        informarSalvamentoEmSegundoPlano(estoque, salvamentoInformado);
         opcao = exibirMenu();  // Exibe menu e obtém opção
 
         try {
@@ -137,6 +190,61 @@ int main() {
                 case 9:
                     buscarInternet(estoque);
                     break;
+                // Opção 10: Relatório de memória
+                case 10:
+                    exibirMemoria(estoque);
+                    break;
+                // Opção 11: Estatísticas de latência
+                case 11:
+                    exibirLatencias(estoque);
+                    break;
+                // Opção 12: Definir estoque mínimo
+                case 12:
+                    definirMinimo(estoque);
+                    break;
+                // Opção 13: Itens abaixo do mínimo
+                case 13:
+                    listarEstoqueBaixo(estoque);
+                    break;
+                // Opção 14: Busca na descrição
+                case 14:
+                    buscarPorDescricao(estoque);
+                    break;
+                // Opção 15: Categorias e fornecedores
+                case 15:
+                    listarPorCategoriaFornecedor(estoque);
+                    break;
+                // Opção 16: Rankings
+                case 16:
+                    exibirRankings(estoque);
+                    break;
+                // Opção 17: Compactar histórico
+                case 17:
+                    compactarHistorico(estoque);
+                    break;
+                // Opções 18/19: Desfazer / Refazer
+                case 18:
+                    desfazerOperacao(estoque);
+                    break;
+                case 19:
+                    refazerOperacao(estoque);
+                    break;
+                // Opção 20: Saída de kit
+                case 20:
+                    registrarSaidaKit(estoque);
+                    break;
+                // Opção 21: Painel de quantidades
+                case 21:
+                    exibirPainelQuantidades(estoque);
+                    break;
+                // Opção 22: Relatórios
+                case 22:
+                    exibirRelatorios(estoque);
+                    break;
+                // Opção 23: Salvar em segundo plano
+                case 23:
+                    salvarEmSegundoPlano(estoque);
+                    break;
                 // Opção 0: Salvar e sair
                 case 0:
                     cout << "Salvando dados e saindo..." << endl;
@@ -184,6 +292,20 @@ int exibirMenu() {
     cout << "7. Registrar SAIDA" << endl;
     cout << "8. Exibir Historico de Movimentacao" << endl;
     cout << "9. Buscar Item na Internet" << endl;
+    cout << "10. Relatorio de Memoria" << endl;
+    cout << "11. Estatisticas de Latencia" << endl;
+    cout << "12. Definir Estoque Minimo" << endl;
+    cout << "13. Itens Abaixo do Minimo" << endl;
+    cout << "14. Buscar na Descricao" << endl;
+    cout << "15. Itens por Categoria/Fornecedor" << endl;
+    cout << "16. Rankings" << endl;
+    cout << "17. Compactar Historico" << endl;
+    cout << "18. Desfazer" << endl;
+    cout << "19. Refazer" << endl;
+    cout << "20. Saida de Kit (varios itens)" << endl;
+    cout << "21. Painel de Quantidades" << endl;
+    cout << "22. Relatorios (grupos, meses, fornecedores)" << endl;
+    cout << "23. Salvar em Segundo Plano" << endl;
     cout << "---------------------------------" << endl;
     cout << "0. Salvar e Sair" << endl;
     cout << "=================================" << endl;
@@ -349,12 +471,12 @@ string lerStringNaoVazia(const string& prompt) {
  * Menu opção 1: Adiciona novo item ao estoque.
  * 
  * Fluxo:
- * 1. Pede tipo: 1 = PRODUTO, 2 = MATERIA-PRIMA
+ * 1. Pede tipo: opções geradas do registro de tipos (1 = Produto, 2 = Materia-Prima, ...)
  * 2. Pede dados comuns: nome, descrição, quantidade, link
- * 3. Pede detalhe específico:
+ * 3. Pede detalhe específico com o prompt do tipo:
  *    - PRODUTO: categoria
  *    - MATERIA: fornecedor
- * 4. Cria ItemProduto ou ItemMateria apropriado
+ * 4. Cria o item pela fábrica do tipo (ItemProduto, ItemMateria, ...)
  * 5. Adiciona ao estoque
  * 
  * Requisito POO:
@@ -369,11 +491,20 @@ void adicionarItem(Estoque& estoque) {
     limparTela();
     cout << "--- Adicionar Novo Item ---" << endl;
     
-    // Pede tipo: 1 = PRODUTO, 2 = MATERIA
+    // Monta "Tipo (1 - Produto, 2 - Materia-Prima): " a partir do registro
+    string prompt = "Tipo (";
+    for (int i = 0; i < NUM_TIPOS_ITEM; ++i) {
+        if (i > 0) prompt += ", ";
+        prompt += std::to_string(i + 1) + " - " + descritorTipo(static_cast<TipoItem>(i)).rotuloMenu;
+    }
+    prompt += "): ";
+
+    // Pede tipo: 1..NUM_TIPOS_ITEM
     int tipo = 0;
-    while (tipo != 1 && tipo != 2) {
-        tipo = lerInteiro("Tipo (1 - Produto, 2 - Materia-Prima): ");
+    while (tipo < 1 || tipo > NUM_TIPOS_ITEM) {
+        tipo = lerInteiro(prompt);
     }
+    const DescritorTipoItem& descritor = descritorTipo(static_cast<TipoItem>(tipo - 1));
 
     // Pede dados comuns a ambos os tipos
     string nome = lerStringNaoVazia("Nome: ");
@@ -386,24 +517,18 @@ void adicionarItem(Estoque& estoque) {
         link = "http://google.com/search?q=\"" + nome + "\"";
     }
 
-    // Cria item apropriado baseado em tipo
-    if (tipo == 1) {
-        // Tipo 1: PRODUTO
-        // Pede categoria específica de produto
-        string categoria = lerStringNaoVazia("Categoria do Produto: ");
-        // Cria ItemProduto (neto de Item) com new (alocação dinâmica)
-        Item* produto = new ItemProduto(nome, desc, qtd, link, categoria);
-        // Adiciona ao estoque (armazenado como Item* - polimórfico)
-        estoque.adicionarItem(produto);
-    } else {
-        // Tipo 2: MATERIA-PRIMA
-        // Pede fornecedor específico de matéria-prima
-        string fornecedor = lerStringNaoVazia("Fornecedor da Materia-Prima: ");
-        // Cria ItemMateria (neto de Item) com new (alocação dinâmica)
-        Item* materia = new ItemMateria(nome, desc, qtd, link, fornecedor);
-        // Adiciona ao estoque (armazenado como Item* - polimórfico)
-        estoque.adicionarItem(materia);
-    }
+    // Pede detalhe específico do tipo (categoria, fornecedor, ...)
+    CamposItem campos;
+    campos.id = 0;  // Novo ID
+    campos.nome = nome;
+    campos.descricao = desc;
+    campos.quantidade = qtd;
+    campos.link = link;
+    campos.detalhe = lerStringNaoVazia(descritor.promptDetalhe);
+
+    // Fábrica do tipo cria a subclasse apropriada (alocação dinâmica)
+    // Adiciona ao estoque (armazenado como Item* - polimórfico)
+    estoque.adicionarItem(descritor.criar(campos));
     
     cout << "Item '" << nome << "' adicionado com sucesso." << endl;
 }
@@ -477,12 +602,13 @@ void editarItem(Estoque& estoque) {
  * 
  * Fluxo:
  * 1. Oferece duas opções de busca:
- *    - 1: Por ID (busca rápida - O(n))
- *    - 2: Por Nome (busca linear - O(n))
+ *    - 1: Por ID (índice - O(1))
+ *    - 2: Por Nome (aproximada: ignora maiúsculas/acentos e tolera erros de digitação)
  * 2. Pede critério de busca
  * 3. Chama função de busca apropriada
- * 4. Se encontrado: exibe detalhes via exibirDetalhes()
- * 5. Se não encontrado: EstoqueException lançada e capturada em main
+ * 4. Por nome com vários candidatos: lista em ordem de semelhança e pede o ID
+ * 5. Se encontrado: exibe detalhes via exibirDetalhes()
+ * 6. Se não encontrado: EstoqueException lançada e capturada em main
  * 
  * Polimorfismo:
  * - itemEncontrado->exibirDetalhes() chama método virtual
@@ -514,9 +640,25 @@ void localizarItem(Estoque& estoque) {
         int id = lerInteiro("Digite o ID: ");
         itemEncontrado = estoque.buscarItemPorId(id);  // Pode lançar exceção
     } else {
-        // Busca por Nome
+        // Busca por Nome: candidatos do mais parecido para o menos
         string nome = lerStringNaoVazia("Digite o Nome: ");
-        itemEncontrado = estoque.buscarItemPorNome(nome);  // Pode lançar exceção
+        std::vector<Item*> candidatos = estoque.buscarItensPorNomeAproximado(nome, 10);
+        if (candidatos.empty()) {
+            throw EstoqueException("Nenhum item com nome parecido com '" + nome + "'.");
+        }
+        if (candidatos.size() == 1) {
+            itemEncontrado = candidatos[0];
+        } else {
+            cout << "Itens parecidos com '" << nome << "':" << endl;
+            for (std::size_t i = 0; i < candidatos.size(); ++i) {
+                cout << "  ID " << candidatos[i]->getId() << " - " << candidatos[i]->getNome() << endl;
+            }
+            int id = lerInteiro("Digite o ID para ver detalhes (0 = nenhum): ");
+            if (id == 0) {
+                return;
+            }
+            itemEncontrado = estoque.buscarItemPorId(id);  // Pode lançar exceção
+        }
     }
 
     // Se chegou aqui, encontrou o item
@@ -664,4 +806,459 @@ void buscarInternet(Estoque& estoque) {
         cerr << "Erro: Nao foi possivel abrir o navegador." << endl;
         cerr << "Comando executado: " << comando << endl;
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Menu opção 10: Exibe o relatório de uso de memória do estoque.
+ * 
+ * Mostra bytes por subsistema (itens, strings, histórico, listas,
+ * índices), tamanhos médios e a memória residente do processo.
+ * Útil para dimensionar máquinas e detectar crescimento após mudanças no catálogo.
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (apenas lê)
+ */
+void exibirMemoria(Estoque& estoque) {
+    limparTela();
+    cout << "--- Relatorio de Memoria ---" << endl;
+    estoque.gerarRelatorioMemoria().imprimir(cout);
+}
+
+
+/**
+ * Menu opção 11: Exibe as latências das operações do estoque.
+ * 
+ * Para cada operação com amostras: quantidade, média, p50, p99, p999
+ * e máximo, em microssegundos (histogramas de MetricasEstoque).
+ * Percentis altos (p99/p999) orientam os timeouts dos coletores.
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (apenas lê)
+ */
+void exibirLatencias(Estoque& estoque) {
+    limparTela();
+    cout << "--- Estatisticas de Latencia ---" << endl;
+    estoque.obterMetricas().imprimir(cout);
+}
+
+/**
+ * Menu opção 12: Define o estoque mínimo (ponto de reposição) de um item.
+ * 
+ * Fluxo:
+ * 1. Pede ID do item
+ * 2. Pede o mínimo (0 desativa o alerta)
+ * 3. Chama estoque.definirMinimo(id, minimo)
+ * 
+ * Exceções:
+ * - EstoqueException se ID não existe ou mínimo negativo (tratadas em main)
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (modifica o mínimo do item)
+ */
+void definirMinimo(Estoque& estoque) {
+    limparTela();
+    cout << "--- Definir Estoque Minimo ---" << endl;
+    int id = lerInteiro("Digite o ID do item: ");
+    int minimo = lerInteiro("Estoque minimo (0 = sem alerta): ");
+    estoque.definirMinimo(id, minimo);
+    cout << "Estoque minimo definido." << endl;
+}
+
+/**
+ * Menu opção 13: Lista os itens abaixo do estoque mínimo.
+ * 
+ * Usa o índice mantido pelos alertas (sem varrer o catálogo).
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (apenas lê)
+ */
+void listarEstoqueBaixo(Estoque& estoque) {
+    limparTela();
+    cout << "--- Itens Abaixo do Minimo ---" << endl;
+    std::vector<Item*> baixos = estoque.listarEstoqueBaixo();
+    if (baixos.empty()) {
+        cout << "Nenhum item abaixo do estoque minimo." << endl;
+        return;
+    }
+    for (std::size_t i = 0; i < baixos.size(); ++i) {
+        cout << "ID " << baixos[i]->getId() << " - " << baixos[i]->getNome()
+             << ": " << baixos[i]->getQuantidade() << " (minimo " << baixos[i]->getMinimo() << ")" << endl;
+    }
+}
+
+/**
+ * Callback registrado em main: imprime um aviso quando um item
+ * fica abaixo do estoque mínimo ou volta ao normal.
+ * 
+ * Parâmetro:
+ *   - alerta: item, quantidade atual, mínimo e direção do cruzamento
+ */
+void avisarEstoqueBaixo(const AlertaEstoqueBaixo& alerta) {
+    if (alerta.abaixo) {
+        cout << "*** ALERTA: '" << alerta.nome << "' (ID " << alerta.idItem << ") abaixo do estoque minimo: "
+             << alerta.quantidade << " < " << alerta.minimo << " ***" << endl;
+    } else {
+        cout << "'" << alerta.nome << "' (ID " << alerta.idItem << ") voltou ao estoque minimo." << endl;
+    }
+}
+
+/**
+ * Menu opção 14: Busca itens pelas palavras da descrição.
+ * 
+ * Fluxo:
+ * 1. Pede a consulta: palavras ligadas por E, grupos separados por OU
+ *    (ex: "m8 inox" = as duas palavras; "m8 OU inox" = qualquer uma)
+ * 2. Consulta o índice invertido (estoque.buscarPorDescricao)
+ * 3. Lista ID, nome e descrição dos itens encontrados
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (apenas lê)
+ */
+void buscarPorDescricao(Estoque& estoque) {
+    limparTela();
+    cout << "--- Buscar na Descricao ---" << endl;
+    string consulta = lerStringNaoVazia("Palavras (use OU para alternativas): ");
+    std::vector<Item*> encontrados = estoque.buscarPorDescricao(consulta);
+    if (encontrados.empty()) {
+        cout << "Nenhum item encontrado." << endl;
+        return;
+    }
+    for (std::size_t i = 0; i < encontrados.size(); ++i) {
+        cout << "ID " << encontrados[i]->getId() << " - " << encontrados[i]->getNome()
+             << ": " << encontrados[i]->getDescricao() << endl;
+    }
+    cout << encontrados.size() << " item(ns) encontrado(s)." << endl;
+}
+
+/**
+ * Menu opção 15: Lista produtos de uma categoria ou matérias-primas
+ * de um fornecedor.
+ * 
+ * Fluxo:
+ * 1. Pergunta o critério (1 - Categoria, 2 - Fornecedor)
+ * 2. Pede o nome; em branco lista todos os grupos com seus itens
+ * 3. Consulta os índices secundários do Estoque (sem varrer o catálogo)
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (apenas lê)
+ */
+void listarPorCategoriaFornecedor(Estoque& estoque) {
+    limparTela();
+    cout << "--- Itens por Categoria/Fornecedor ---" << endl;
+    int criterio = lerInteiro("Criterio (1 - Categoria, 2 - Fornecedor): ");
+    if (criterio != 1 && criterio != 2) {
+        cout << "Criterio invalido." << endl;
+        return;
+    }
+    bool porCategoria = (criterio == 1);
+    string nome = lerString(porCategoria ? "Categoria (vazio = todas): " : "Fornecedor (vazio = todos): ");
+
+    std::vector<GrupoItens> grupos;
+    if (nome.empty()) {
+        grupos = porCategoria ? estoque.agruparPorCategoria() : estoque.agruparPorFornecedor();
+    } else {
+        GrupoItens grupo;
+        grupo.itens = porCategoria ? estoque.listarPorCategoria(nome) : estoque.listarPorFornecedor(nome);
+        if (!grupo.itens.empty()) {
+            grupo.nome = detalheItem(*grupo.itens[0]);  // Grafia cadastrada
+            grupos.push_back(grupo);
+        }
+    }
+    if (grupos.empty()) {
+        cout << "Nenhum item encontrado." << endl;
+        return;
+    }
+    for (std::size_t g = 0; g < grupos.size(); ++g) {
+        cout << grupos[g].nome << " (" << grupos[g].itens.size() << " item(ns))" << endl;
+        for (std::size_t i = 0; i < grupos[g].itens.size(); ++i) {
+            const Item* item = grupos[g].itens[i];
+            cout << "  ID " << item->getId() << " - " << item->getNome()
+                 << ": " << item->getQuantidade() << endl;
+        }
+    }
+}
+
+/**
+ * Menu opção 16: Rankings do estoque.
+ * 
+ * Fluxo:
+ * 1. Pergunta o ranking (1 - Mais estocados, 2 - Menos estocados, 3 - Maiores saídas)
+ * 2. Pergunta o tamanho K (e, para saídas, a janela em dias; 0 = todo o histórico)
+ * 3. Exibe posição, ID, nome e valor
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (apenas lê)
+ */
+void exibirRankings(Estoque& estoque) {
+    limparTela();
+    cout << "--- Rankings ---" << endl;
+    int opcao = lerInteiro("Ranking (1 - Mais estocados, 2 - Menos estocados, 3 - Maiores saidas): ");
+    if (opcao < 1 || opcao > 3) {
+        cout << "Ranking invalido." << endl;
+        return;
+    }
+    int k = lerInteiro("Quantidade de itens (K): ");
+    if (k <= 0) {
+        cout << "K deve ser positivo." << endl;
+        return;
+    }
+
+    std::vector<PosicaoRanking> ranking;
+    const char* unidade = "em estoque";
+    if (opcao == 1) {
+        ranking = estoque.maioresQuantidades(static_cast<std::size_t>(k));
+    } else if (opcao == 2) {
+        ranking = estoque.menoresQuantidades(static_cast<std::size_t>(k));
+    } else {
+        int dias = lerInteiro("Ultimos quantos dias (0 = todo o historico): ");
+        ranking = estoque.maioresSaidas(static_cast<std::size_t>(k), dias);
+        unidade = "saidas";
+    }
+
+    if (ranking.empty()) {
+        cout << "Nenhum item no ranking." << endl;
+        return;
+    }
+    for (std::size_t i = 0; i < ranking.size(); ++i) {
+        cout << (i + 1) << ". ID " << ranking[i].item->getId() << " - " << ranking[i].item->getNome()
+             << ": " << ranking[i].valor << " " << unidade << endl;
+    }
+}
+
+/**
+ * Menu opção 17: Checkpoint do histórico.
+ * 
+ * Fluxo:
+ * 1. Pergunta quantos dias de movimentos manter em memória (0 = arquivar todos)
+ * 2. Chama estoque.compactarHistorico(): movimentos antigos vão para o
+ *    arquivo morto e viram um resumo por item
+ * 3. Informa quantos movimentos foram arquivados
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (modifica histórico e arquivos)
+ * 
+ * Lança: EstoqueException (tratada em main) se dias < 0 ou falha de gravação
+ */
+void compactarHistorico(Estoque& estoque) {
+    limparTela();
+    cout << "--- Compactar Historico ---" << endl;
+    int dias = lerInteiro("Manter movimentos dos ultimos quantos dias (0 = arquivar todos): ");
+    std::size_t arquivados = estoque.compactarHistorico(dias);
+    if (arquivados == 0) {
+        cout << "Nenhum movimento anterior ao corte." << endl;
+    }
+}
+
+/**
+ * Menu opção 18: Desfaz a operação mais recente.
+ * 
+ * Fluxo:
+ * 1. Mostra qual operação será desfeita (estoque.descreverProximoDesfazer)
+ * 2. Chama estoque.desfazer(): O(1), sem pedir confirmação
+ *    (a operação pode ser refeita com a opção 19)
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (modifica)
+ * 
+ * Lança: EstoqueException (tratada em main) se a inversa não for possível
+ */
+void desfazerOperacao(Estoque& estoque) {
+    limparTela();
+    string descricao = estoque.descreverProximoDesfazer();
+    if (!estoque.desfazer()) {
+        cout << "Nada a desfazer." << endl;
+        return;
+    }
+    cout << "Desfeito: " << descricao << endl;
+}
+
+/**
+ * Menu opção 19: Refaz a última operação desfeita.
+ * Mesmo fluxo de desfazerOperacao, com estoque.refazer().
+ */
+void refazerOperacao(Estoque& estoque) {
+    limparTela();
+    string descricao = estoque.descreverProximoRefazer();
+    if (!estoque.refazer()) {
+        cout << "Nada a refazer." << endl;
+        return;
+    }
+    cout << "Refeito: " << descricao << endl;
+}
+
+/**
+ * Menu opção 20: Saída de um kit com vários itens.
+ * 
+ * Fluxo:
+ * 1. Lê pares ID/quantidade até o usuário digitar ID 0
+ * 2. Monta uma TransacaoEstoque com uma SAIDA por par
+ * 3. estoque.executarTransacao(): aplica todas as saídas ou nenhuma
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (modifica)
+ * 
+ * Lança: EstoqueException (tratada em main) se algum item não existe
+ *        ou não tem estoque; nesse caso nenhuma saída é registrada
+ */
+void registrarSaidaKit(Estoque& estoque) {
+    limparTela();
+    cout << "--- Saida de Kit ---" << endl;
+    cout << "(Digite ID 0 para finalizar)" << endl;
+    TransacaoEstoque kit;
+    while (true) {
+        int id = lerInteiro("ID do item: ");
+        if (id == 0) {
+            break;
+        }
+        kit.saida(id, lerInteiro("Quantidade: "));
+    }
+    if (kit.vazia()) {
+        cout << "Nenhum item informado." << endl;
+        return;
+    }
+    estoque.executarTransacao(kit);
+    cout << "Saida do kit registrada (" << kit.getLinhas().size() << " movimento(s))." << endl;
+}
+
+/**
+ * Menu opção 21: Painel de quantidades.
+ * 
+ * Fluxo:
+ * 1. Lê o limite de "estoque baixo" para a contagem
+ * 2. estoque.agregarQuantidades(): itens, soma, mínimo, máximo, abaixo do limite
+ * 3. estoque.contarPorFaixaDeQuantidade(): faixas por ordem de grandeza
+ * 4. estoque.totalizarMovimentos(): entradas e saídas do histórico
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (apenas consulta)
+ */
+void exibirPainelQuantidades(Estoque& estoque) {
+    limparTela();
+    cout << "--- Painel de Quantidades ---" << endl;
+    int limite = lerInteiro("Contar itens com quantidade abaixo de: ");
+
+    AgregadosQuantidade agregados = estoque.agregarQuantidades(limite);
+    cout << "Itens: " << agregados.itens << " | Total em estoque: " << agregados.soma << endl;
+    cout << "Menor quantidade: " << agregados.minimo << " | Maior quantidade: " << agregados.maximo << endl;
+    cout << "Abaixo de " << limite << ": " << agregados.abaixoDoLimite << endl;
+
+    const int limitesArray[] = {1, 10, 100, 1000, 10000};
+    std::vector<int> limites(limitesArray, limitesArray + 5);
+    std::vector<std::size_t> faixas = estoque.contarPorFaixaDeQuantidade(limites);
+    cout << "\nFaixas de quantidade:" << endl;
+    cout << "  < " << limites[0] << ": " << faixas[0] << endl;
+    for (std::size_t i = 1; i < limites.size(); ++i) {
+        cout << "  " << limites[i - 1] << " a " << limites[i] - 1 << ": " << faixas[i] << endl;
+    }
+    cout << "  >= " << limites.back() << ": " << faixas.back() << endl;
+
+    TotaisMovimentos totais = estoque.totalizarMovimentos();
+    cout << "\nHistorico: " << totais.numEntradas << " entrada(s) somando " << totais.quantidadeEntradas
+         << ", " << totais.numSaidas << " saida(s) somando " << totais.quantidadeSaidas << endl;
+    cout << "(calculado com " << nomeNivelSimd(nivelSimdAtivo()) << ")" << endl;
+}
+
+/**
+ * Menu opção 22: Relatórios sobre o catálogo e o histórico inteiros.
+ * 
+ * Fluxo:
+ * 1. Escolhe o relatório:
+ *    1 = estoque por categoria/fornecedor, 2 = movimentos por mês,
+ *    3 = fluxo por fornecedor (mês YYYY-MM ou vazio para todo o histórico)
+ * 2. RelatoriosEstoque divide a varredura entre as threads disponíveis
+ * 3. Exibe as linhas e o tempo gasto
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (apenas consulta)
+ */
+void exibirRelatorios(Estoque& estoque) {
+    limparTela();
+    cout << "--- Relatorios ---" << endl;
+    cout << "1. Estoque por categoria/fornecedor" << endl;
+    cout << "2. Movimentos por mes" << endl;
+    cout << "3. Fluxo por fornecedor" << endl;
+    int opcao = lerInteiro("Escolha: ");
+
+    RelatoriosEstoque relatorios(estoque);
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    try {
+        if (opcao == 1) {
+            std::vector<EstoquePorGrupo> grupos = relatorios.estoquePorGrupo();
+            cout << "TIPO;GRUPO;ITENS;QUANTIDADE" << endl;
+            for (std::size_t i = 0; i < grupos.size(); ++i) {
+                cout << nomeTipoItem(grupos[i].tipo) << ";" << grupos[i].grupo << ";"
+                     << grupos[i].itens << ";" << grupos[i].quantidade << endl;
+            }
+        } else if (opcao == 2 || opcao == 3) {
+            std::vector<FluxoMovimentos> fluxos;
+            if (opcao == 2) {
+                fluxos = relatorios.movimentosPorMes();
+                cout << "MES";
+            } else {
+                string mes = lerString("Mes (YYYY-MM, vazio = todo o historico): ");
+                fluxos = relatorios.fluxoPorFornecedor(mes);
+                cout << "FORNECEDOR";
+            }
+            cout << ";ENTRADAS;UNID_ENTRADAS;SAIDAS;UNID_SAIDAS;SALDO" << endl;
+            for (std::size_t i = 0; i < fluxos.size(); ++i) {
+                const FluxoMovimentos& f = fluxos[i];
+                cout << f.chave << ";" << f.numEntradas << ";" << f.quantidadeEntradas << ";"
+                     << f.numSaidas << ";" << f.quantidadeSaidas << ";" << f.saldo() << endl;
+            }
+        } else {
+            cout << "Opcao invalida." << endl;
+            return;
+        }
+    } catch (const EstoqueException& e) {
+        cerr << "Erro: " << e.what() << endl;
+        return;
+    }
+    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - inicio).count();
+    cout << "(" << ms << " ms)" << endl;
+}
+
+/**
+ * Menu opção 23: Salvamento em segundo plano.
+ * 
+ * Fluxo:
+ * 1. Em andamento: exibe o PID e o tempo decorrido (não inicia outro)
+ * 2. Senão: Estoque::salvarEmSegundoPlano cria o processo filho que grava
+ *    itens.txt, estoque.ckp e movimentos.txt; o menu volta na hora
+ * 3. O fim é informado no topo do menu (informarSalvamentoEmSegundoPlano)
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque
+ */
+void salvarEmSegundoPlano(Estoque& estoque) {
+    StatusSalvamento status = estoque.consultarSalvamentoEmSegundoPlano();
+    if (status.situacao == SALVAMENTO_EM_ANDAMENTO) {
+        cout << "Salvamento em segundo plano ja em andamento (PID " << status.pid << ")." << endl;
+        return;
+    }
+    int pid = estoque.salvarEmSegundoPlano();
+    cout << "Salvamento em segundo plano iniciado (PID " << pid << ")." << endl;
+    cout << "O menu continua disponivel; o fim sera informado no topo do menu." << endl;
+}
+
+/**
+ * Exibe, uma única vez, o resultado do último salvamento em segundo plano.
+ * 
+ * Parâmetro:
+ *   - estoque: referência ao Estoque (consulta sem bloquear)
+ *   - pidInformado: PID do último resultado exibido (atualizado aqui)
+ */
+void informarSalvamentoEmSegundoPlano(Estoque& estoque, int& pidInformado) {
+    StatusSalvamento status = estoque.consultarSalvamentoEmSegundoPlano();
+    if (status.pid == 0 || status.pid == pidInformado) {
+        return;
+    }
+    if (status.situacao == SALVAMENTO_CONCLUIDO) {
+        cout << "[Salvamento em segundo plano concluido em " << status.duracaoMs << " ms]" << endl;
+    } else if (status.situacao == SALVAMENTO_FALHOU) {
+        cout << "[Salvamento em segundo plano FALHOU (codigo " << status.codigoSaida
+             << "); os dados continuam no diario]" << endl;
+    } else {
+        return;  // Em andamento: informa quando terminar
+    }
+    pidInformado = status.pid;
+}
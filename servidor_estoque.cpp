@@ -0,0 +1,65 @@
+#include <iostream>
+#include <csignal>
+#include <cstring>
+#include "Estoque.h"
+#include "ServidorEstoque.h"
+
+// Servidor usado pelo handler de sinal (SIGINT/SIGTERM encerram com salvamento)
+static ServidorEstoque* servidorAtivo = nullptr;
+
+static void tratarSinal(int) {
+    if (servidorAtivo) servidorAtivo->parar();
+}
+
+// Uso:
+//   servidor_estoque [-s caminho.sock]   (padrão: estoque.sock, mesmo do cliente_estoque)
+int main(int argc, char** argv) {
+    std::string caminho = "estoque.sock";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            caminho = argv[++i];
+        } else {
+            std::cerr << "Uso: servidor_estoque [-s caminho.sock]\n";
+            return 1;
+        }
+    }
+
+    // Antes de carregar o Estoque: com outro servidor ativo no caminho,
+    // esta instância não pode carregar nem regravar os arquivos dele
+    try {
+        ServidorEstoque::prepararCaminho(caminho);
+    } catch (const std::exception& e) {
+        std::cerr << "Erro no servidor: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Sem SA_RESTART: poll() retorna EINTR e o laço percebe o pedido de parada
+    struct sigaction acao;
+    acao.sa_handler = tratarSinal;
+    sigemptyset(&acao.sa_mask);
+    acao.sa_flags = 0;
+    sigaction(SIGINT, &acao, nullptr);
+    sigaction(SIGTERM, &acao, nullptr);
+    signal(SIGPIPE, SIG_IGN);  // Cliente que fecha cedo não derruba o servidor
+
+    Estoque estoque; // carrega dados existentes uma única vez
+    try {
+        ServidorEstoque servidor(estoque, caminho);
+        servidorAtivo = &servidor;
+        servidor.iniciar();
+        std::cerr << "Servidor do estoque escutando em " << caminho << std::endl;
+
+        // As operações do Estoque escrevem mensagens de sucesso em std::cout;
+        // no servidor elas são descartadas (respostas vão pelo socket)
+        std::cout.setstate(std::ios::failbit);
+        servidor.executar();
+        std::cout.clear();
+        servidorAtivo = nullptr;
+    } catch (const std::exception& e) {
+        std::cerr << "Erro no servidor: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Servidor encerrado. Salvando dados..." << std::endl;
+    return 0; // destrutor de 'estoque' salva itens.txt e movimentos.txt
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "DeteccaoCPU.h"
+#include "DivisorCampos.h"
+
+// Equivalência dos kernels de localizarDelimitadores (AVX2, SSE2, escalar)
+// e do LeitorRegistros que os usa: mesmas posições em qualquer alinhamento
+// e tamanho em torno dos blocos de 32/64 bytes, e mesmos campos com linhas
+// que atravessam o buffer de 1 MiB (inclusive uma linha maior que ele).
+// Níveis não suportados pela CPU são pulados.
+// Código de saída: 0 = todas as verificações passaram
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string& descricao) {
+    std::cout << (condicao ? "[OK]     " : "[FALHOU] ") << descricao << std::endl;
+    if (!condicao) {
+        ++falhas;
+    }
+}
+
+// Posições esperadas: laço byte a byte
+static std::vector<std::uint32_t> referencia(const char* dados, std::size_t n, char separador) {
+    std::vector<std::uint32_t> posicoes;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (dados[i] == separador || dados[i] == '\n') {
+            posicoes.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    return posicoes;
+}
+
+// Campos esperados: divisão por '\n' e depois por ';' (linha final vazia não é registro)
+static std::vector<std::vector<std::string> > dividirReferencia(const std::string& texto) {
+    std::vector<std::vector<std::string> > linhas;
+    std::size_t inicio = 0;
+    while (inicio < texto.size()) {
+        std::size_t fim = texto.find('\n', inicio);
+        if (fim == std::string::npos) {
+            fim = texto.size();
+        }
+        std::vector<std::string> campos;
+        std::size_t comeco = inicio;
+        for (std::size_t i = inicio; i <= fim; ++i) {
+            if (i == fim || texto[i] == ';') {
+                campos.push_back(texto.substr(comeco, i - comeco));
+                comeco = i + 1;
+            }
+        }
+        linhas.push_back(campos);
+        inicio = fim + 1;
+    }
+    return linhas;
+}
+
+// Todas as janelas [inicio, inicio + n) de 'dados' com inicio < 64
+static bool conferirJanelas(const std::string& dados) {
+    std::vector<std::uint32_t> posicoes(dados.size());
+    for (std::size_t inicio = 0; inicio < 64 && inicio <= dados.size(); ++inicio) {
+        for (std::size_t n = 0; inicio + n <= dados.size(); ++n) {
+            std::vector<std::uint32_t> esperadas = referencia(dados.data() + inicio, n, ';');
+            std::size_t encontrados = localizarDelimitadores(dados.data() + inicio, n, ';', &posicoes[0]);
+            if (encontrados != esperadas.size() ||
+                !std::equal(esperadas.begin(), esperadas.end(), posicoes.begin())) {
+                std::cout << "  divergencia em inicio=" << inicio << " n=" << n << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool conferirLeitor(const std::string& texto) {
+    std::vector<std::vector<std::string> > esperadas = dividirReferencia(texto);
+    std::istringstream entrada(texto);
+    LeitorRegistros leitor(entrada);
+    std::size_t linha = 0;
+    while (leitor.proximo()) {
+        if (linha >= esperadas.size() || leitor.numCampos() != esperadas[linha].size()) {
+            std::cout << "  divergencia no numero de campos da linha " << linha << std::endl;
+            return false;
+        }
+        for (std::size_t i = 0; i < leitor.numCampos(); ++i) {
+            if (leitor.campo(i) != esperadas[linha][i]) {
+                std::cout << "  divergencia no campo " << i << " da linha " << linha << std::endl;
+                return false;
+            }
+        }
+        ++linha;
+    }
+    bool ultimaCortada = !texto.empty() && texto[texto.size() - 1] != '\n';
+    return linha == esperadas.size() && leitor.terminaEmQuebra() == !ultimaCortada;
+}
+
+int main() {
+    std::cout << "---- localizarDelimitadores / LeitorRegistros por nivel SIMD ----" << std::endl;
+    std::mt19937 gerador(20240611);
+
+    // Bytes aleatórios com muitos delimitadores (inclui bytes >= 0x80)
+    std::string aleatorio(3 * 64 + 17, 'a');
+    const char alfabeto[] = { 'a', 'b', ';', '\n', 'x', '\xe9' };
+    for (std::size_t i = 0; i < aleatorio.size(); ++i) {
+        aleatorio[i] = alfabeto[gerador() % sizeof(alfabeto)];
+    }
+
+    // Delimitadores só nas bordas dos blocos de 32 e 64 bytes
+    std::string bordas(3 * 64, '-');
+    const std::size_t posicoesBorda[] = { 0, 31, 32, 63, 64, 127, 128, 191 };
+    for (std::size_t i = 0; i < sizeof(posicoesBorda) / sizeof(posicoesBorda[0]); ++i) {
+        bordas[posicoesBorda[i]] = (i % 2 == 0) ? ';' : '\n';
+    }
+
+    // Texto de ~3 MiB: linhas curtas, linhas que atravessam o limite de 1 MiB
+    // do buffer e uma linha de 1,5 MiB (o buffer dobra); termina sem '\n'
+    std::string texto;
+    while (texto.size() < (1u << 20) - 100) {
+        std::size_t campos = 1 + gerador() % 8;
+        for (std::size_t c = 0; c < campos; ++c) {
+            texto.append(gerador() % 40, static_cast<char>('a' + gerador() % 26));
+            texto += (c + 1 < campos) ? ';' : '\n';
+        }
+    }
+    texto += "\n;;\n";
+    texto += std::string(1536 * 1024, 'z') + ";fim\n";
+    while (texto.size() < 3u * (1u << 20)) {
+        texto += "12;2024-01-01;SAIDA;5;3;Parafuso\n";
+    }
+    texto += "13;2024-01-02;ENTR";
+
+    const NivelSimd niveis[] = { SIMD_ESCALAR, SIMD_SSE41, SIMD_AVX2 };
+    for (std::size_t i = 0; i < sizeof(niveis) / sizeof(niveis[0]); ++i) {
+        std::string nome = nomeNivelSimd(niveis[i]);
+        if (niveis[i] > nivelSimdSuportado()) {
+            std::cout << "[PULADO] " << nome << ": nao suportado por esta CPU" << std::endl;
+            continue;
+        }
+        limitarNivelSimd(niveis[i]);
+        verificar(nivelSimdAtivo() == niveis[i], nome + ": nivel ativo");
+        verificar(conferirJanelas(aleatorio), nome + ": bytes aleatorios, todo inicio < 64 e todo tamanho");
+        verificar(conferirJanelas(bordas), nome + ": delimitadores nas bordas dos blocos de 32/64 bytes");
+        verificar(conferirLeitor(texto), nome + ": LeitorRegistros atravessando o buffer de 1 MiB");
+    }
+    limitarNivelSimd(SIMD_AVX2);
+
+    std::cout << "\n---- " << (falhas == 0 ? "PASS" : "FALHOU") << " (" << falhas << " falha(s)) ----" << std::endl;
+    return falhas == 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "Estoque.h"
+#include "EstoqueException.h"
+#include "ItemProduto.h"
+#include "LogDesfazer.h"
+
+// Posse dos itens no log de desfazer (LogDesfazer) quando o anel dá a volta:
+// o log libera o item só quando é o dono (REMOVER não desfeito, ADICIONAR
+// desfeito) e nunca um item que voltou ao Estoque. Depois, pelo Estoque:
+// só as últimas CAPACIDADE operações são desfeitas.
+// Roda em um diretório temporário (o Estoque grava no diretório atual).
+// Código de saída: 0 = todas as verificações passaram
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string& descricao) {
+    std::cout << (condicao ? "[OK]     " : "[FALHOU] ") << descricao << std::endl;
+    if (!condicao) {
+        ++falhas;
+    }
+}
+
+// Item que conta as próprias destruições
+static int destruidos = 0;
+
+class ItemContado : public ItemProduto {
+public:
+    explicit ItemContado(int id) : ItemProduto(id, "Contado", "teste", 1, "http://t", "Teste") {}
+    ~ItemContado() { ++destruidos; }
+};
+
+static OperacaoDesfazivel operacaoItem(TipoDesfazivel tipo, Item* item) {
+    OperacaoDesfazivel operacao;
+    operacao.tipo = tipo;
+    operacao.idItem = item->getId();
+    operacao.quantidade = 0;
+    operacao.item = item;
+    return operacao;
+}
+
+static OperacaoDesfazivel operacaoEntrada() {
+    OperacaoDesfazivel operacao;
+    operacao.tipo = DESFAZ_ENTRADA;
+    operacao.idItem = 1;
+    operacao.quantidade = 1;
+    operacao.item = nullptr;
+    return operacao;
+}
+
+// Preenche o anel inteiro: tudo o que havia antes sai pela volta
+static void darVolta(LogDesfazer& log) {
+    for (std::size_t i = 0; i < LogDesfazer::CAPACIDADE; ++i) {
+        log.registrar(operacaoEntrada());
+    }
+}
+
+static void testarLog() {
+    std::cout << "\n[1] LogDesfazer (CAPACIDADE = " << LogDesfazer::CAPACIDADE << ")" << std::endl;
+    {
+        LogDesfazer log;
+
+        // REMOVER não desfeito: o item é do log e sai com a volta
+        log.registrar(operacaoItem(DESFAZ_REMOVER_ITEM, new ItemContado(9001)));
+        darVolta(log);
+        verificar(destruidos == 1, "REMOVER descartado pela volta libera o item");
+        verificar(log.numeroDesfaziveis() == LogDesfazer::CAPACIDADE, "anel cheio apos a volta");
+
+        // ADICIONAR desfeito: item fora do Estoque, do log; novo registro descarta o refazer
+        log.registrar(operacaoItem(DESFAZ_ADICIONAR_ITEM, new ItemContado(9002)));
+        log.confirmarDesfazer();
+        log.registrar(operacaoEntrada());
+        verificar(destruidos == 2, "ADICIONAR desfeito e descartado libera o item");
+
+        // ADICIONAR não desfeito: item no Estoque; a volta não o libera
+        ItemContado* noEstoque = new ItemContado(9003);
+        log.registrar(operacaoItem(DESFAZ_ADICIONAR_ITEM, noEstoque));
+        darVolta(log);
+        verificar(destruidos == 2, "ADICIONAR descartado pela volta nao libera item do Estoque");
+        delete noEstoque;
+
+        // REMOVER desfeito: item voltou ao Estoque; descartar o refazer não o libera
+        ItemContado* devolvido = new ItemContado(9004);
+        log.registrar(operacaoItem(DESFAZ_REMOVER_ITEM, devolvido));
+        log.confirmarDesfazer();
+        log.registrar(operacaoEntrada());
+        verificar(destruidos == 3, "REMOVER desfeito e descartado nao libera item do Estoque");
+        delete devolvido;
+
+        // Desfeito e refeito atravessando a emenda do anel: posse volta ao log
+        log.registrar(operacaoItem(DESFAZ_REMOVER_ITEM, new ItemContado(9005)));
+        for (std::size_t i = 0; i < LogDesfazer::CAPACIDADE / 2; ++i) {
+            log.registrar(operacaoEntrada());
+        }
+        for (std::size_t i = 0; i <= LogDesfazer::CAPACIDADE / 2; ++i) {
+            log.confirmarDesfazer();
+        }
+        for (std::size_t i = 0; i <= LogDesfazer::CAPACIDADE / 2; ++i) {
+            log.confirmarRefazer();
+        }
+        log.registrar(operacaoItem(DESFAZ_ADICIONAR_ITEM, new ItemContado(9006)));
+        log.confirmarDesfazer();
+        verificar(destruidos == 4, "nada liberado enquanto os itens estao no log");
+    }   // Destrutor do log: REMOVER 9005 (não desfeito) e ADICIONAR 9006 (desfeito)
+    verificar(destruidos == 6, "destrutor do log libera os itens que sao dele");
+}
+
+static void testarEstoque() {
+    std::cout << "\n[2] Estoque: remover item e dar a volta no anel" << std::endl;
+    Estoque estoque;
+    Item* removido = new ItemProduto("Removido", "teste", 5, "http://t", "Teste");
+    estoque.adicionarItem(removido);
+    int idRemovido = removido->getId();
+    Item* contador = new ItemProduto("Contador", "teste", 0, "http://t", "Teste");
+    estoque.adicionarItem(contador);
+    int idContador = contador->getId();
+
+    estoque.removerItem(idRemovido);   // O log passa a ser dono do item
+    for (std::size_t i = 0; i < LogDesfazer::CAPACIDADE; ++i) {
+        estoque.registrarEntrada(idContador, 1);
+    }
+
+    std::size_t desfeitas = 0;
+    while (estoque.desfazer()) {
+        ++desfeitas;
+    }
+    verificar(desfeitas == LogDesfazer::CAPACIDADE, "exatamente CAPACIDADE operacoes desfeitas");
+    verificar(estoque.buscarItemPorId(idContador)->getQuantidade() == 0, "entradas desfeitas");
+    bool voltou = true;
+    try {
+        estoque.buscarItemPorId(idRemovido);
+    } catch (const EstoqueException&) {
+        voltou = false;
+    }
+    verificar(!voltou, "remocao fora do anel nao pode ser desfeita (item liberado pelo log)");
+
+    std::size_t refeitas = 0;
+    while (estoque.refazer()) {
+        ++refeitas;
+    }
+    verificar(refeitas == LogDesfazer::CAPACIDADE &&
+              estoque.buscarItemPorId(idContador)->getQuantidade() == static_cast<int>(LogDesfazer::CAPACIDADE),
+              "todas refeitas");
+}
+
+int main() {
+    char modelo[] = "/tmp/test_desfazer.XXXXXX";
+    if (mkdtemp(modelo) == nullptr || chdir(modelo) != 0) {
+        std::cerr << "Nao foi possivel criar o diretorio temporario." << std::endl;
+        return 2;
+    }
+    std::cout << "---- Posse de itens no log de desfazer em " << modelo << " ----" << std::endl;
+
+    try {
+        testarLog();
+        testarEstoque();
+    } catch (const std::exception& e) {
+        std::cerr << "Excecao inesperada: " << e.what() << std::endl;
+        return 2;
+    }
+
+    std::cout << "\n---- " << (falhas == 0 ? "PASS" : "FALHOU") << " (" << falhas << " falha(s)) ----" << std::endl;
+    return falhas == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "CheckpointEstoque.h"
+#include "Estoque.h"
+#include "ItemMateria.h"
+#include "ItemProduto.h"
+
+// Recuperação por checkpoint + diário (estoque.ckp + diario_itens.txt):
+// entradas com SEQ <= a do checkpoint são ignoradas, a última entrada
+// cortada (sem '\n') não é reaplicada nem volta em cargas seguintes.
+// Roda em um diretório temporário (o Estoque grava no diretório atual).
+// Código de saída: 0 = todas as verificações passaram
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string& descricao) {
+    std::cout << (condicao ? "[OK]     " : "[FALHOU] ") << descricao << std::endl;
+    if (!condicao) {
+        ++falhas;
+    }
+}
+
+static std::string lerArquivo(const std::string& caminho) {
+    std::ifstream arq(caminho.c_str(), std::ios::binary);
+    std::ostringstream conteudo;
+    conteudo << arq.rdbuf();
+    return conteudo.str();
+}
+
+static int quantidade(Estoque& estoque, int id) {
+    return estoque.buscarItemPorId(id)->getQuantidade();
+}
+
+int main() {
+    char modelo[] = "/tmp/test_recuperacao.XXXXXX";
+    if (mkdtemp(modelo) == nullptr || chdir(modelo) != 0) {
+        std::cerr << "Nao foi possivel criar o diretorio temporario." << std::endl;
+        return 2;
+    }
+    std::cout << "---- Recuperacao (checkpoint + diario) em " << modelo << " ----" << std::endl;
+
+    try {
+        // [1] Checkpoint no meio: A entra nele, a saída de B fica só no diário
+        int idA, idB;
+        {
+            Estoque estoque;
+            Item* a = new ItemProduto("Parafuso", "M8 inox", 10, "http://a", "Fixacao");
+            estoque.adicionarItem(a);
+            idA = a->getId();
+            Item* b = new ItemMateria("Chapa", "Aco 2mm", 20, "http://b", "Siderurgica");
+            estoque.adicionarItem(b);
+            idB = b->getId();
+            estoque.registrarEntrada(idA, 5);   // A = 15
+            estoque.gravarCheckpoint();
+            estoque.registrarSaida(idB, 3);     // B = 17 (diário)
+        }   // Destrutor: diário curto, sem novo checkpoint
+
+        unsigned long long seqCheckpoint = 0;
+        int proximoIdItem = 0;
+        std::vector<RegistroItem> registros;
+        verificar(CheckpointEstoque::ler("estoque.ckp", seqCheckpoint, proximoIdItem, registros),
+                  "[1] estoque.ckp valido");
+        verificar(registros.size() == 2 && registros[1].campos.quantidade == 20,
+                  "[1] checkpoint com B = 20 (saida posterior fora dele)");
+        std::string diario = lerArquivo("diario_itens.txt");
+        std::ostringstream entradaB;
+        entradaB << seqCheckpoint + 1 << ";ITEM;MATERIA;" << idB << ";Chapa;Aco 2mm;17;";
+        verificar(diario.compare(0, entradaB.str().size(), entradaB.str()) == 0,
+                  "[1] diario comeca na SEQ seguinte a do checkpoint (B = 17)");
+
+        // [2] Entrada antiga (SEQ do checkpoint) e última entrada cortada no meio de "17"
+        {
+            std::ofstream arq("diario_itens.txt", std::ios::app);
+            arq << seqCheckpoint << ";ITEM;PRODUTO;" << idA << ";Parafuso;M8 inox;999;http://a;Fixacao\n";
+            arq << seqCheckpoint + 2 << ";ITEM;MATERIA;" << idB << ";Chapa;Aco 2mm;1";
+        }
+        {
+            Estoque estoque;
+            verificar(quantidade(estoque, idA) == 15, "[2] SEQ <= checkpoint ignorada (A = 15, nao 999)");
+            verificar(quantidade(estoque, idB) == 17, "[2] entrada cortada nao reaplicada (B = 17, nao 1)");
+        }
+        diario = lerArquivo("diario_itens.txt");
+        verificar(!diario.empty() && diario[diario.size() - 1] == '\n',
+                  "[2] entrada cortada removida do diario na carga");
+
+        // [3] Novo acréscimo depois do corte: a entrada cortada não reaparece
+        {
+            Estoque estoque;
+            estoque.registrarEntrada(idB, 1);   // B = 18
+        }
+        {
+            Estoque estoque;
+            verificar(quantidade(estoque, idA) == 15 && quantidade(estoque, idB) == 18,
+                      "[3] recarga apos novo acrescimo (A = 15, B = 18)");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Excecao inesperada: " << e.what() << std::endl;
+        return 2;
+    }
+
+    std::cout << "\n---- " << (falhas == 0 ? "PASS" : "FALHOU") << " (" << falhas << " falha(s)) ----" << std::endl;
+    return falhas == 0 ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include "Estoque.h"
+#include "EstoqueException.h"
+#include "ItemProduto.h"
+#include "SnapshotEstoque.h"
+#include "TransacaoEstoque.h"
+
+// Isolamento dos snapshots (MVCC) com escritores concorrentes: threads
+// transferem unidades entre itens com executarTransacao (SAIDA de um +
+// ENTRADA de outro, soma constante) enquanto outra thread lê snapshots.
+// Todo snapshot deve mostrar uma única versão: soma constante e, por item,
+// quantidade = ENTRADAS - SAIDAS do histórico do próprio snapshot; um
+// snapshot guardado não muda enquanto as escritas continuam.
+// Roda em um diretório temporário (o Estoque grava no diretório atual).
+// Código de saída: 0 = todas as verificações passaram
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const std::string& descricao) {
+    std::cout << (condicao ? "[OK]     " : "[FALHOU] ") << descricao << std::endl;
+    if (!condicao) {
+        ++falhas;
+    }
+}
+
+// Resumo de um snapshot para comparar com ele mesmo mais tarde
+struct ResumoSnapshot {
+    unsigned long versao;
+    std::size_t itens;
+    std::size_t movimentos;
+    long long soma;
+};
+
+static ResumoSnapshot resumir(const SnapshotEstoque& snapshot) {
+    ResumoSnapshot resumo;
+    resumo.versao = snapshot.getVersao();
+    resumo.itens = snapshot.getItens().size();
+    resumo.movimentos = snapshot.tamanhoHistorico();
+    resumo.soma = 0;
+    for (std::size_t i = 0; i < snapshot.getItens().size(); ++i) {
+        resumo.soma += snapshot.getItens()[i]->quantidade;
+    }
+    return resumo;
+}
+
+// Quantidade de cada item = saldo dos movimentos do mesmo snapshot
+static bool itensBatemComHistorico(const SnapshotEstoque& snapshot) {
+    std::unordered_map<int, long long> saldo;
+    for (std::size_t i = 0; i < snapshot.tamanhoHistorico(); ++i) {
+        const MovimentoEstoque* mov = snapshot.movimento(i);
+        saldo[mov->getIdItem()] += mov->getTipo() == ENTRADA ? mov->getQuantidade() : -mov->getQuantidade();
+    }
+    for (std::size_t i = 0; i < snapshot.getItens().size(); ++i) {
+        const EstadoItem& item = *snapshot.getItens()[i];
+        if (saldo[item.id] != item.quantidade) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    char modelo[] = "/tmp/test_snapshot.XXXXXX";
+    if (mkdtemp(modelo) == nullptr || chdir(modelo) != 0) {
+        std::cerr << "Nao foi possivel criar o diretorio temporario." << std::endl;
+        return 2;
+    }
+    std::cout << "---- Isolamento de snapshots com escritores em " << modelo << " ----" << std::endl;
+
+    const int NUM_ITENS = 32;
+    const int QTD_INICIAL = 1000;
+    const int NUM_ESCRITORES = 4;
+    const int TRANSFERENCIAS = 5000;
+    const long long SOMA = static_cast<long long>(NUM_ITENS) * QTD_INICIAL;
+
+    Estoque estoque;
+    std::vector<int> ids;
+    for (int i = 0; i < NUM_ITENS; ++i) {
+        Item* item = new ItemProduto("Item" + std::to_string(i), "teste", QTD_INICIAL, "http://t", "Teste");
+        estoque.adicionarItem(item);
+        ids.push_back(item->getId());
+    }
+
+    // Guardado antes das escritas e relido no fim
+    std::shared_ptr<const SnapshotEstoque> guardado = estoque.obterSnapshot();
+    ResumoSnapshot resumoGuardado = resumir(*guardado);
+
+    std::atomic<int> escritoresAtivos(NUM_ESCRITORES);
+    std::atomic<long long> aplicadas(0);
+    std::vector<std::thread> escritores;
+    for (int t = 0; t < NUM_ESCRITORES; ++t) {
+        escritores.push_back(std::thread([&, t]() {
+            unsigned semente = 7919u * (t + 1);
+            for (int i = 0; i < TRANSFERENCIAS; ++i) {
+                semente = semente * 1103515245u + 12345u;
+                int origem = ids[(semente >> 8) % NUM_ITENS];
+                int destino = ids[(semente >> 16) % NUM_ITENS];
+                int qtd = 1 + static_cast<int>((semente >> 4) % 50);
+                if (origem == destino) {
+                    continue;
+                }
+                try {
+                    TransacaoEstoque transferencia;
+                    transferencia.saida(origem, qtd).entrada(destino, qtd);
+                    estoque.executarTransacao(transferencia);
+                    ++aplicadas;
+                } catch (const EstoqueException&) {
+                    // Saldo insuficiente: nada aplicado (tudo ou nada)
+                }
+            }
+            --escritoresAtivos;
+        }));
+    }
+
+    // Leitor: um snapshot novo por volta
+    int lidos = 0, somaErrada = 0, historicoErrado = 0, versaoVoltou = 0;
+    unsigned long ultimaVersao = 0;
+    while (escritoresAtivos.load() > 0) {
+        std::shared_ptr<const SnapshotEstoque> snapshot = estoque.obterSnapshot();
+        ResumoSnapshot resumo = resumir(*snapshot);
+        if (resumo.soma != SOMA || resumo.itens != static_cast<std::size_t>(NUM_ITENS)) ++somaErrada;
+        if (!itensBatemComHistorico(*snapshot)) ++historicoErrado;
+        if (resumo.versao < ultimaVersao) ++versaoVoltou;
+        ultimaVersao = resumo.versao;
+        ++lidos;
+    }
+    for (std::size_t t = 0; t < escritores.size(); ++t) {
+        escritores[t].join();
+    }
+
+    std::cout << lidos << " snapshot(s) lido(s) durante " << aplicadas.load() << " transferencia(s)" << std::endl;
+    verificar(lidos > 0 && aplicadas.load() > 0, "leituras e escritas simultaneas");
+    verificar(somaErrada == 0, "soma e numero de itens constantes em todo snapshot");
+    verificar(historicoErrado == 0, "quantidades = saldo do historico do mesmo snapshot");
+    verificar(versaoVoltou == 0, "versoes dos snapshots nao decrescem");
+
+    ResumoSnapshot depois = resumir(*guardado);
+    verificar(depois.versao == resumoGuardado.versao && depois.movimentos == resumoGuardado.movimentos &&
+              depois.soma == resumoGuardado.soma && itensBatemComHistorico(*guardado),
+              "snapshot guardado inalterado depois das escritas");
+    guardado.reset();
+
+    ResumoSnapshot ultimo = resumir(*estoque.obterSnapshot());
+    verificar(ultimo.movimentos == resumoGuardado.movimentos + 2 * static_cast<std::size_t>(aplicadas.load()),
+              "snapshot final ve todas as transferencias (2 movimentos cada)");
+
+    std::cout << "\n---- " << (falhas == 0 ? "PASS" : "FALHOU") << " (" << falhas << " falha(s)) ----" << std::endl;
+    return falhas == 0 ? 0 : 1;
+}